@@ -0,0 +1,348 @@
+// AssignmentStream.cpp
+
+/** Implementation file for the AssignmentStream class.
+ */
+
+#include "AssignmentStream.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+
+static const char column_magic[] = "LMCOLS01";
+static const size_t magic_length = 8;
+
+static inline size_t padded( const size_t offset )
+{
+    return ( offset + 7 ) / 8 * 8;
+}
+
+// reads a native integer at offset, advancing offset past it
+template< typename Type >
+static Type read_integer( const char *data, const size_t length, size_t &offset )
+{
+    Type value;
+
+    if( offset + sizeof( Type ) > length )
+    {
+        throw AssignmentStream::Streamexception();
+    }
+
+    std::memcpy( &value, data + offset, sizeof( Type ) );
+    offset += sizeof( Type );
+    return value;
+}
+
+// the field without surrounding spaces and carriage returns
+static inline void trim_field( const char *&begin, const char *&end )
+{
+    while( begin < end && ( *begin == ' ' || *begin == '\r' ) )
+    {
+        ++begin;
+    }
+
+    while( end > begin && ( end[ -1 ] == ' ' || end[ -1 ] == '\r' ) )
+    {
+        --end;
+    }
+}
+
+AssignmentStream::AssignmentStream( const std::string &path ) : data( nullptr ), length( 0 ), body( 0 ), file_format( Text ), delimiter( ',' )
+{
+    if( !file.open( path ) || file.size() == 0 )
+    {
+        throw Streamexception();
+    }
+
+    data = file.data();
+    length = file.size();
+
+    if( length >= magic_length && std::memcmp( data, column_magic, magic_length ) == 0 )
+    {
+        size_t offset = magic_length, count = read_integer< uint64_t >( data, length, offset );
+
+        file_format = Binary;
+
+        for( size_t index = 0; index < count; ++index )
+        {
+            uint32_t name_length = read_integer< uint32_t >( data, length, offset );
+
+            if( offset + name_length > length )
+            {
+                throw Streamexception();
+            }
+
+            names.emplace_back( data + offset, name_length );
+            offset += name_length;
+        }
+
+        body = padded( offset );
+    }
+    else
+    {
+        const char *end = std::find( data, data + length, '\n' ), *begin = data, *field_end;
+
+        delimiter = ( std::find( data, end, '\t' ) != end )? '\t' : ',';
+
+        while( true )
+        {
+            field_end = std::find( begin, end, delimiter );
+            const char *name_begin = begin, *name_end = field_end;
+            trim_field( name_begin, name_end );
+            names.emplace_back( name_begin, name_end );
+
+            if( field_end == end )
+            {
+                break;
+            }
+
+            begin = field_end + 1;
+        }
+
+        body = std::min( length, ( size_t )( end - data ) + 1 );
+    }
+}
+
+AssignmentStream::Format AssignmentStream::format() const
+{
+    return file_format;
+}
+
+const std::vector< std::string > &AssignmentStream::columns() const
+{
+    return names;
+}
+
+// the identifier id of every column, npos for columns compiled does not know
+std::vector< SymbolTable::id_type > AssignmentStream::bind( const CompiledMatrix &compiled ) const
+{
+    std::vector< SymbolTable::id_type > bound( names.size(), SymbolTable::npos );
+    std::vector< bool > found( compiled.identifier_count(), false );
+    size_t index;
+
+    for( index = 0; index < names.size() && compiled.symbol_table(); ++index )
+    {
+        SymbolTable::id_type identifier = compiled.symbol_table()->find( names[ index ] );
+
+        if( identifier < compiled.identifier_count() )
+        {
+            bound[ index ] = identifier;
+            found[ identifier ] = true;
+        }
+    }
+
+    for( index = 0; index < found.size(); ++index )
+    {
+        if( !found[ index ] && compiled.references( index ) )
+        {
+            throw Streamexception();
+        }
+    }
+
+    return bound;
+}
+
+void AssignmentStream::evaluate( const CompiledMatrix &compiled, std::ostream &output, const size_t batch_assignments, ThreadPool *pool ) const
+{
+    size_t batch = std::max< size_t >( batch_assignments, 1 );
+
+    if( file_format == Binary )
+    {
+        evaluate_binary( compiled, output, batch, pool );
+    }
+    else
+    {
+        evaluate_text( compiled, output, batch, pool );
+    }
+}
+
+void AssignmentStream::evaluate_text( const CompiledMatrix &compiled, std::ostream &output, const size_t batch_assignments, ThreadPool *pool ) const
+{
+    std::vector< SymbolTable::id_type > bound = bind( compiled );
+    CompiledMatrix::BitSlice batch = compiled.make_batch( batch_assignments ), results = compiled.make_batch_result( batch_assignments );
+    std::vector< BitVector::word_type > scratch;
+    std::string buffer;
+    size_t count = 0, column, statement;
+    const char *position = data + body, *end = data + length;
+
+    auto flush = [ & ]()
+    {
+        if( pool )
+        {
+            compiled.evaluate_batch( batch, results, *pool );
+        }
+        else
+        {
+            compiled.evaluate_batch( batch.row( 0 ), batch.lanes(), results.row( 0 ), 0,
+                ( count + BitVector::word_bits - 1 ) / BitVector::word_bits, scratch );
+        }
+
+        buffer.clear();
+
+        for( size_t assignment = 0; assignment < count; ++assignment )
+        {
+            for( statement = 0; statement < results.rows(); ++statement )
+            {
+                if( statement != 0 )
+                {
+                    buffer += delimiter;
+                }
+
+                buffer += results.get( statement, assignment )? '1' : '0';
+            }
+
+            buffer += '\n';
+        }
+
+        output.write( buffer.data(), buffer.size() );
+        count = 0;
+    };
+
+    while( position < end )
+    {
+        const char *line_end = std::find( position, end, '\n' ), *field_begin = position, *field_end;
+
+        if( std::all_of( position, line_end, []( const char value ){ return value == ' ' || value == '\r'; } ) )
+        { // blank lines hold no assignment
+            position = line_end + ( line_end < end );
+            continue;
+        }
+
+        for( column = 0; column < bound.size(); ++column )
+        {
+            field_end = std::find( field_begin, line_end, delimiter );
+
+            if( ( field_end == line_end ) != ( column + 1 == bound.size() ) )
+            {
+                throw Streamexception();
+            }
+
+            const char *value_begin = field_begin, *value_end = field_end;
+            trim_field( value_begin, value_end );
+
+            if( value_end - value_begin != 1 || ( *value_begin != '0' && *value_begin != '1' ) )
+            {
+                throw Streamexception();
+            }
+
+            if( bound[ column ] != SymbolTable::npos )
+            {
+                batch.set( bound[ column ], count, *value_begin == '1' );
+            }
+
+            field_begin = field_end + 1;
+        }
+
+        if( ++count == batch_assignments )
+        {
+            flush();
+        }
+
+        position = line_end + ( line_end < end );
+    }
+
+    if( count != 0 )
+    {
+        flush();
+    }
+}
+
+void AssignmentStream::evaluate_binary( const CompiledMatrix &compiled, std::ostream &output, const size_t batch_assignments, ThreadPool *pool ) const
+{
+    std::vector< SymbolTable::id_type > bound = bind( compiled );
+    CompiledMatrix::BitSlice batch = compiled.make_batch( batch_assignments ), results = compiled.make_batch_result( batch_assignments );
+    std::vector< std::string > statement_names;
+    std::vector< BitVector::word_type > scratch;
+    size_t offset = body, block_lanes, lane, lanes, assignments, column;
+
+    for( column = 0; column < results.rows(); ++column )
+    {
+        statement_names.push_back( std::to_string( column ) );
+    }
+
+    write_header( output, statement_names );
+
+    while( offset < length )
+    {
+        size_t block_assignments = read_integer< uint64_t >( data, length, offset );
+
+        block_lanes = ( block_assignments + BitVector::word_bits - 1 ) / BitVector::word_bits;
+
+        if( block_lanes > ( length - offset ) / sizeof( BitVector::word_type ) / std::max< size_t >( names.size(), 1 ) )
+        {
+            throw Streamexception();
+        }
+
+        for( lane = 0; lane < block_lanes; lane += batch.lanes() )
+        {
+            lanes = std::min( batch.lanes(), block_lanes - lane );
+            assignments = std::min( batch.assignments(), block_assignments - lane * BitVector::word_bits );
+
+            for( column = 0; column < bound.size(); ++column )
+            {
+                if( bound[ column ] != SymbolTable::npos )
+                {
+                    std::memcpy( batch.row( bound[ column ] ), data + offset + ( column * block_lanes + lane ) * sizeof( BitVector::word_type ),
+                        lanes * sizeof( BitVector::word_type ) );
+                }
+            }
+
+            if( pool )
+            {
+                compiled.evaluate_batch( batch, results, *pool );
+            }
+            else
+            {
+                compiled.evaluate_batch( batch.row( 0 ), batch.lanes(), results.row( 0 ), 0, lanes, scratch );
+            }
+
+            write_block( output, results, assignments );
+        }
+
+        offset += names.size() * block_lanes * sizeof( BitVector::word_type );
+    }
+}
+
+void AssignmentStream::write_header( std::ostream &output, const std::vector< std::string > &columns )
+{
+    uint64_t count = columns.size();
+    size_t written = magic_length + sizeof( count );
+    static const char padding[ 8 ] = { 0 };
+
+    output.write( column_magic, magic_length );
+    output.write( ( const char * ) &count, sizeof( count ) );
+
+    for( std::string const& name : columns )
+    {
+        uint32_t name_length = name.size();
+
+        output.write( ( const char * ) &name_length, sizeof( name_length ) );
+        output.write( name.data(), name.size() );
+        written += sizeof( name_length ) + name.size();
+    }
+
+    output.write( padding, padded( written ) - written );
+}
+
+// writes the first assignments of every row of block, all of them by default
+void AssignmentStream::write_block( std::ostream &output, const CompiledMatrix::BitSlice &block, const size_t assignments )
+{
+    uint64_t count = std::min( assignments, block.assignments() );
+    size_t lanes = ( count + BitVector::word_bits - 1 ) / BitVector::word_bits;
+    BitVector::word_type tail;
+
+    output.write( ( const char * ) &count, sizeof( count ) );
+
+    for( size_t row = 0; row < block.rows(); ++row )
+    {
+        if( count % BitVector::word_bits == 0 )
+        {
+            output.write( ( const char * ) block.row( row ), lanes * sizeof( BitVector::word_type ) );
+            continue;
+        }
+
+        // bits past count in the last word are written clear
+        tail = block.row( row )[ lanes - 1 ] & ( ( ( BitVector::word_type ) 1 << ( count % BitVector::word_bits ) ) - 1 );
+        output.write( ( const char * ) block.row( row ), ( lanes - 1 ) * sizeof( BitVector::word_type ) );
+        output.write( ( const char * ) &tail, sizeof( tail ) );
+    }
+}
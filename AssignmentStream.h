@@ -0,0 +1,76 @@
+// AssignmentStream.h
+
+/** Header file for the AssignmentStream class.
+ *
+ *  An AssignmentStream memory maps a file of assignments and evaluates every
+ *  row of it against a CompiledMatrix in bit sliced batches, so memory use is
+ *  bounded by the batch size rather than the size of the file.
+ *
+ *  Two formats are read. A text file has a header row of identifier names and
+ *  one row of 0 or 1 values per assignment, separated by tabs when the header
+ *  holds a tab and by commas otherwise. Results are written as text rows of 0
+ *  or 1 per statement using the same separator.
+ *
+ *  A binary column file starts with the 8 bytes "LMCOLS01", a uint64 column
+ *  count and each column name as a uint32 length followed by its bytes, zero
+ *  padded to a multiple of 8 bytes. Any number of blocks follow, each a uint64
+ *  assignment count then, column by column, the bit sliced words of that many
+ *  assignments. Integers are in native byte order. Results are written as a
+ *  binary column file with one column per statement, named by its index.
+ */
+
+#ifndef __AssignmentStream_h_included__
+#define __AssignmentStream_h_included__
+
+#include "CompiledMatrix.h"
+#include "MappedFile.h"
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+class AssignmentStream
+{
+    public:
+        class Streamexception: public std::exception
+        {
+            public:
+                virtual const char* what() const throw()
+                {
+                    return "Unreadable or malformed assignment file";
+                }
+        };
+
+        enum Format { Text, Binary };
+
+        AssignmentStream( const std::string &path );
+
+        AssignmentStream( const AssignmentStream& ) = delete;
+        AssignmentStream &operator =( const AssignmentStream& ) = delete;
+
+        Format format() const;
+        const std::vector< std::string > &columns() const;
+
+        // every identifier compiled refers to needs a column, columns compiled does not know are ignored
+        void evaluate( const CompiledMatrix &compiled, std::ostream &output, const size_t batch_assignments = 1 << 16,
+            ThreadPool *pool = nullptr ) const;
+
+        static void write_header( std::ostream &output, const std::vector< std::string > &columns );
+        static void write_block( std::ostream &output, const CompiledMatrix::BitSlice &block, const size_t assignments = BitVector::npos );
+
+    private:
+        MappedFile file;
+        const char *data;
+        size_t length, body;
+        Format file_format;
+        char delimiter;
+        std::vector< std::string > names;
+
+        std::vector< SymbolTable::id_type > bind( const CompiledMatrix &compiled ) const;
+        void evaluate_text( const CompiledMatrix &compiled, std::ostream &output, const size_t batch_assignments, ThreadPool *pool ) const;
+        void evaluate_binary( const CompiledMatrix &compiled, std::ostream &output, const size_t batch_assignments, ThreadPool *pool ) const;
+};
+
+#endif
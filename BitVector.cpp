@@ -0,0 +1,449 @@
+// BitVector.cpp
+
+/** Implementation file for the BitVector class.
+ */
+
+#include "BitVector.h"
+#include <algorithm>
+
+const size_t BitVector::word_bits;
+const size_t BitVector::npos;
+
+static inline size_t words_for( const size_t length )
+{
+    return ( length + BitVector::word_bits - 1 ) / BitVector::word_bits;
+}
+
+// mask of the bits [ 0, bits ) within a single word, bits must be less than word_bits
+static inline BitVector::word_type low_mask( const size_t bits )
+{
+    return ( ( BitVector::word_type ) 1 << bits ) - 1;
+}
+
+BitVector::BitVector( const size_t length, const bool value ) : words( words_for( length ), value? ~( word_type ) 0 : 0 ), length( length )
+{
+    clear_tail();
+}
+
+// keeps the invariant that bits past length are zero
+void BitVector::clear_tail()
+{
+    if( length % word_bits != 0 )
+    {
+        words.back() &= low_mask( length % word_bits );
+    }
+}
+
+size_t BitVector::size() const
+{
+    return length;
+}
+
+bool BitVector::empty() const
+{
+    return length == 0;
+}
+
+size_t BitVector::word_count() const
+{
+    return words.size();
+}
+
+// the bits this holds room for without allocating, a whole number of words
+size_t BitVector::capacity() const
+{
+    return words.capacity() * word_bits;
+}
+
+void BitVector::resize( const size_t new_length, const bool value )
+{
+    size_t old_length = length;
+
+    words.resize( words_for( new_length ), value? ~( word_type ) 0 : 0 );
+    length = new_length;
+
+    if( value && old_length < new_length && old_length % word_bits != 0 )
+    {
+        words[ old_length / word_bits ] |= ~low_mask( old_length % word_bits );
+    }
+
+    clear_tail();
+}
+
+void BitVector::reserve( const size_t new_length )
+{
+    words.reserve( words_for( new_length ) );
+}
+
+void BitVector::clear()
+{
+    words.clear();
+    length = 0;
+}
+
+bool BitVector::operator []( const size_t index ) const
+{
+    return ( words[ index / word_bits ] >> ( index % word_bits ) ) & 1;
+}
+
+void BitVector::set( const size_t index, const bool value )
+{
+    if( value )
+    {
+        words[ index / word_bits ] |= ( word_type ) 1 << ( index % word_bits );
+    }
+    else
+    {
+        reset( index );
+    }
+}
+
+void BitVector::reset( const size_t index )
+{
+    words[ index / word_bits ] &= ~( ( word_type ) 1 << ( index % word_bits ) );
+}
+
+// clears every bit without changing size()
+void BitVector::reset()
+{
+    std::fill( words.begin(), words.end(), 0 );
+}
+
+// sets every bit in [ begin, end )
+void BitVector::set_range( const size_t begin, const size_t end )
+{
+    if( begin >= end )
+    {
+        return;
+    }
+
+    size_t first = begin / word_bits, last = ( end - 1 ) / word_bits;
+    word_type head = ~low_mask( begin % word_bits ),
+        tail = ( end % word_bits == 0 )? ~( word_type ) 0 : low_mask( end % word_bits );
+
+    if( first == last )
+    {
+        words[ first ] |= head & tail;
+        return;
+    }
+
+    words[ first ] |= head;
+    std::fill( words.begin() + first + 1, words.begin() + last, ~( word_type ) 0 );
+    words[ last ] |= tail;
+}
+
+void BitVector::push_back( const bool value )
+{
+    if( length % word_bits == 0 )
+    {
+        words.push_back( 0 );
+    }
+
+    ++length;
+
+    if( value )
+    {
+        set( length - 1 );
+    }
+}
+
+// concatenates other onto the end of this
+void BitVector::append( const BitVector &other )
+{
+    size_t offset = length;
+
+    resize( length + other.length );
+    or_at( other, offset );
+}
+
+// ORs other into this starting at bit offset, other must fit within size()
+void BitVector::or_at( const BitVector &other, const size_t offset )
+{
+    size_t index, target = offset / word_bits, shift = offset % word_bits;
+
+    if( shift == 0 )
+    {
+        for( index = 0; index < other.words.size(); ++index )
+        {
+            words[ target + index ] |= other.words[ index ];
+        }
+
+        return;
+    }
+
+    for( index = 0; index < other.words.size(); ++index )
+    {
+        words[ target + index ] |= other.words[ index ] << shift;
+
+        if( target + index + 1 < words.size() )
+        {
+            words[ target + index + 1 ] |= other.words[ index ] >> ( word_bits - shift );
+        }
+    }
+}
+
+// removes the bit at index, shifting every later bit down by one
+void BitVector::erase( const size_t index )
+{
+    size_t word_index = index / word_bits, offset = index % word_bits;
+    word_type value = words[ word_index ];
+
+    words[ word_index ] = ( value & low_mask( offset ) ) | ( ( value >> 1 ) & ~low_mask( offset ) );
+
+    for( ++word_index; word_index < words.size(); ++word_index )
+    {
+        words[ word_index - 1 ] |= words[ word_index ] << ( word_bits - 1 );
+        words[ word_index ] >>= 1;
+    }
+
+    if( --length % word_bits == 0 )
+    {
+        words.pop_back();
+    }
+
+    clear_tail();
+}
+
+// copies the bits [ begin, end ) down to start at target, a word at a time, target must not be past begin
+// The bits from target are overwritten, those past end - begin + target keep their values
+void BitVector::move_range( const size_t target, const size_t begin, const size_t end )
+{
+    size_t from = begin, to = target;
+
+    while( from < end )
+    {
+        size_t count = std::min( end - from, word_bits ), word_index = from / word_bits, offset = from % word_bits;
+        word_type value = words[ word_index ] >> offset, mask = ( count == word_bits )? ~( word_type ) 0 : low_mask( count );
+
+        if( offset != 0 && word_index + 1 < words.size() )
+        {
+            value |= words[ word_index + 1 ] << ( word_bits - offset );
+        }
+
+        value &= mask;
+        word_index = to / word_bits;
+        offset = to % word_bits;
+        words[ word_index ] = ( words[ word_index ] & ~( mask << offset ) ) | ( value << offset );
+
+        if( offset != 0 && offset + count > word_bits )
+        {
+            words[ word_index + 1 ] = ( words[ word_index + 1 ] & ~( mask >> ( word_bits - offset ) ) ) | ( value >> ( word_bits - offset ) );
+        }
+
+        from += count;
+        to += count;
+    }
+}
+
+// gathers the bits of this at every position set in keep
+BitVector BitVector::compact( const BitVector &keep ) const
+{
+    size_t target = 0;
+    BitVector result( keep.count() );
+
+    for( size_t index = keep.find_first(); index != npos; index = keep.find_next( index ) )
+    {
+        if( ( *this )[ index ] )
+        {
+            result.set( target );
+        }
+
+        ++target;
+    }
+
+    return result;
+}
+
+BitVector &BitVector::operator &=( const BitVector &other )
+{
+    for( size_t index = 0; index < words.size(); ++index )
+    {
+        words[ index ] &= other.words[ index ];
+    }
+
+    return *this;
+}
+
+BitVector &BitVector::operator |=( const BitVector &other )
+{
+    for( size_t index = 0; index < words.size(); ++index )
+    {
+        words[ index ] |= other.words[ index ];
+    }
+
+    return *this;
+}
+
+BitVector &BitVector::operator ^=( const BitVector &other )
+{
+    for( size_t index = 0; index < words.size(); ++index )
+    {
+        words[ index ] ^= other.words[ index ];
+    }
+
+    return *this;
+}
+
+// clears every bit of this that is set in other
+BitVector &BitVector::and_not( const BitVector &other )
+{
+    for( size_t index = 0; index < words.size(); ++index )
+    {
+        words[ index ] &= ~other.words[ index ];
+    }
+
+    return *this;
+}
+
+BitVector BitVector::operator ~() const
+{
+    BitVector result( *this );
+
+    for( word_type& word : result.words )
+    {
+        word = ~word;
+    }
+
+    result.clear_tail();
+
+    return result;
+}
+
+bool BitVector::any() const
+{
+    for( word_type const& word : words )
+    {
+        if( word != 0 )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool BitVector::none() const
+{
+    return !any();
+}
+
+size_t BitVector::count() const
+{
+    size_t result = 0;
+
+    for( word_type const& word : words )
+    {
+        result += __builtin_popcountll( word );
+    }
+
+    return result;
+}
+
+bool BitVector::intersects( const BitVector &other ) const
+{
+    for( size_t index = 0; index < words.size(); ++index )
+    {
+        if( words[ index ] & other.words[ index ] )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool BitVector::is_subset_of( const BitVector &other ) const
+{
+    for( size_t index = 0; index < words.size(); ++index )
+    {
+        if( words[ index ] & ~other.words[ index ] )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t BitVector::find_first() const
+{
+    for( size_t index = 0; index < words.size(); ++index )
+    {
+        if( words[ index ] != 0 )
+        {
+            return index * word_bits + __builtin_ctzll( words[ index ] );
+        }
+    }
+
+    return npos;
+}
+
+// finds the first set bit after index
+size_t BitVector::find_next( const size_t index ) const
+{
+    size_t word_index = ( index + 1 ) / word_bits, offset = ( index + 1 ) % word_bits;
+
+    if( word_index >= words.size() )
+    {
+        return npos;
+    }
+
+    word_type value = words[ word_index ] & ~low_mask( offset );
+
+    while( value == 0 )
+    {
+        if( ++word_index >= words.size() )
+        {
+            return npos;
+        }
+
+        value = words[ word_index ];
+    }
+
+    return word_index * word_bits + __builtin_ctzll( value );
+}
+
+bool BitVector::operator ==( const BitVector &other ) const
+{
+    return ( length == other.length ) && ( words == other.words );
+}
+
+bool BitVector::operator !=( const BitVector &other ) const
+{
+    return !( *this == other );
+}
+
+// lexicographic ordering matching std::vector< bool >
+bool BitVector::operator <( const BitVector &other ) const
+{
+    size_t index, common = std::min( length, other.length );
+
+    for( index = 0; index * word_bits < common; ++index )
+    {
+        word_type difference = words[ index ] ^ other.words[ index ];
+
+        if( difference != 0 )
+        {
+            size_t position = index * word_bits + __builtin_ctzll( difference );
+
+            if( position < common )
+            {
+                return other[ position ];
+            }
+
+            break;
+        }
+    }
+
+    return length < other.length;
+}
+
+const BitVector::word_type *BitVector::data() const
+{
+    return words.data();
+}
+
+BitVector::word_type *BitVector::data()
+{
+    return words.data();
+}
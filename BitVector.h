@@ -0,0 +1,75 @@
+// BitVector.h
+
+/** Header file for the BitVector class.
+ *
+ *  A BitVector is a fixed width sequence of bits packed into 64-bit words.
+ *  Bits past size() in the last word are always kept clear so that whole
+ *  words can be compared, counted and combined directly.
+ */
+
+#ifndef __BitVector_h_included__
+#define __BitVector_h_included__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BitVector
+{
+    public:
+        typedef uint64_t word_type;
+
+        static const size_t word_bits = 64;
+        static const size_t npos = -1;
+
+        BitVector( const size_t length = 0, const bool value = false );
+
+        size_t size() const;
+        bool empty() const;
+        size_t word_count() const;
+        size_t capacity() const;
+        void resize( const size_t length, const bool value = false );
+        void reserve( const size_t length );
+        void clear();
+
+        bool operator []( const size_t index ) const;
+        void set( const size_t index, const bool value = true );
+        void reset( const size_t index );
+        void reset();
+        void set_range( const size_t begin, const size_t end );
+        void push_back( const bool value );
+        void append( const BitVector &other );
+        void or_at( const BitVector &other, const size_t offset );
+        void erase( const size_t index );
+        void move_range( const size_t target, const size_t begin, const size_t end );
+        BitVector compact( const BitVector &keep ) const;
+
+        BitVector &operator &=( const BitVector &other );
+        BitVector &operator |=( const BitVector &other );
+        BitVector &operator ^=( const BitVector &other );
+        BitVector &and_not( const BitVector &other );
+        BitVector operator ~() const;
+
+        bool any() const;
+        bool none() const;
+        size_t count() const;
+        bool intersects( const BitVector &other ) const;
+        bool is_subset_of( const BitVector &other ) const;
+        size_t find_first() const;
+        size_t find_next( const size_t index ) const;
+
+        bool operator ==( const BitVector &other ) const;
+        bool operator !=( const BitVector &other ) const;
+        bool operator <( const BitVector &other ) const;
+
+        const word_type *data() const;
+        word_type *data();
+
+    private:
+        std::vector< word_type > words;
+        size_t length;
+
+        void clear_tail();
+};
+
+#endif
@@ -0,0 +1,648 @@
+// CompiledMatrix.cpp
+
+/** Implementation file for the CompiledMatrix class.
+ */
+
+#include "CompiledMatrix.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <numeric>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#define COMPILEDMATRIX_X86
+#endif
+
+// AND sets are computed for Width consecutive lanes into scratch[ term * Width ], then ORed into each statement
+template< size_t Width >
+static void evaluate_block( const uint32_t *term_offsets, const uint32_t *term_literals, const size_t terms,
+    const uint32_t *statement_offsets, const uint32_t *statement_terms, const size_t statements,
+    const BitVector::word_type *slices, const size_t lanes, BitVector::word_type *results, const size_t lane, BitVector::word_type *scratch )
+{
+    size_t term, statement, index, word;
+    BitVector::word_type accumulator[ Width ], flip;
+    const BitVector::word_type *source;
+
+    for( term = 0; term < terms; ++term )
+    {
+        for( word = 0; word < Width; ++word )
+        {
+            accumulator[ word ] = ~( BitVector::word_type ) 0;
+        }
+
+        for( index = term_offsets[ term ]; index < term_offsets[ term + 1 ]; ++index )
+        {
+            source = slices + ( term_literals[ index ] >> 1 ) * lanes + lane;
+            flip = -( BitVector::word_type )( term_literals[ index ] & 1 );
+
+            for( word = 0; word < Width; ++word )
+            {
+                accumulator[ word ] &= source[ word ] ^ flip;
+            }
+        }
+
+        for( word = 0; word < Width; ++word )
+        {
+            scratch[ term * Width + word ] = accumulator[ word ];
+        }
+    }
+
+    for( statement = 0; statement < statements; ++statement )
+    {
+        for( word = 0; word < Width; ++word )
+        {
+            accumulator[ word ] = 0;
+        }
+
+        for( index = statement_offsets[ statement ]; index < statement_offsets[ statement + 1 ]; ++index )
+        {
+            for( word = 0; word < Width; ++word )
+            {
+                accumulator[ word ] |= scratch[ statement_terms[ index ] * Width + word ];
+            }
+        }
+
+        for( word = 0; word < Width; ++word )
+        {
+            results[ statement * lanes + lane + word ] = accumulator[ word ];
+        }
+    }
+}
+
+#ifdef COMPILEDMATRIX_X86
+
+#pragma GCC push_options
+#pragma GCC target( "avx2" )
+
+// evaluate_block for 4 lanes held in one 256-bit register
+static void evaluate_block_avx2( const uint32_t *term_offsets, const uint32_t *term_literals, const size_t terms,
+    const uint32_t *statement_offsets, const uint32_t *statement_terms, const size_t statements,
+    const BitVector::word_type *slices, const size_t lanes, BitVector::word_type *results, const size_t lane, BitVector::word_type *scratch )
+{
+    size_t term, statement, index;
+    __m256i accumulator, flip;
+    __m256i *term_values = ( __m256i * ) scratch;
+
+    for( term = 0; term < terms; ++term )
+    {
+        accumulator = _mm256_set1_epi64x( -1 );
+
+        for( index = term_offsets[ term ]; index < term_offsets[ term + 1 ]; ++index )
+        {
+            flip = _mm256_set1_epi64x( -( long long )( term_literals[ index ] & 1 ) );
+            accumulator = _mm256_and_si256( accumulator, _mm256_xor_si256( flip,
+                _mm256_loadu_si256( ( const __m256i * )( slices + ( term_literals[ index ] >> 1 ) * lanes + lane ) ) ) );
+        }
+
+        _mm256_storeu_si256( term_values + term, accumulator );
+    }
+
+    for( statement = 0; statement < statements; ++statement )
+    {
+        accumulator = _mm256_setzero_si256();
+
+        for( index = statement_offsets[ statement ]; index < statement_offsets[ statement + 1 ]; ++index )
+        {
+            accumulator = _mm256_or_si256( accumulator, _mm256_loadu_si256( term_values + statement_terms[ index ] ) );
+        }
+
+        _mm256_storeu_si256( ( __m256i * )( results + statement * lanes + lane ), accumulator );
+    }
+}
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target( "avx512f" )
+
+// evaluate_block for 8 lanes held in one 512-bit register
+static void evaluate_block_avx512( const uint32_t *term_offsets, const uint32_t *term_literals, const size_t terms,
+    const uint32_t *statement_offsets, const uint32_t *statement_terms, const size_t statements,
+    const BitVector::word_type *slices, const size_t lanes, BitVector::word_type *results, const size_t lane, BitVector::word_type *scratch )
+{
+    size_t term, statement, index;
+    __m512i accumulator, flip;
+    __m512i *term_values = ( __m512i * ) scratch;
+
+    for( term = 0; term < terms; ++term )
+    {
+        accumulator = _mm512_set1_epi64( -1 );
+
+        for( index = term_offsets[ term ]; index < term_offsets[ term + 1 ]; ++index )
+        {
+            flip = _mm512_set1_epi64( -( long long )( term_literals[ index ] & 1 ) );
+            accumulator = _mm512_and_si512( accumulator, _mm512_xor_si512( flip,
+                _mm512_loadu_si512( slices + ( term_literals[ index ] >> 1 ) * lanes + lane ) ) );
+        }
+
+        _mm512_storeu_si512( term_values + term, accumulator );
+    }
+
+    for( statement = 0; statement < statements; ++statement )
+    {
+        accumulator = _mm512_setzero_si512();
+
+        for( index = statement_offsets[ statement ]; index < statement_offsets[ statement + 1 ]; ++index )
+        {
+            accumulator = _mm512_or_si512( accumulator, _mm512_loadu_si512( term_values + statement_terms[ index ] ) );
+        }
+
+        _mm512_storeu_si512( results + statement * lanes + lane, accumulator );
+    }
+}
+
+#pragma GCC pop_options
+
+#endif
+
+CompiledMatrix::BitSlice::BitSlice( const size_t rows, const size_t assignments ) : row_count( rows ),
+    lane_count( ( assignments + BitVector::word_bits - 1 ) / BitVector::word_bits ), assignment_count( assignments ),
+    words( row_count * lane_count, 0 )
+{
+}
+
+size_t CompiledMatrix::BitSlice::rows() const
+{
+    return row_count;
+}
+
+size_t CompiledMatrix::BitSlice::lanes() const
+{
+    return lane_count;
+}
+
+size_t CompiledMatrix::BitSlice::assignments() const
+{
+    return assignment_count;
+}
+
+bool CompiledMatrix::BitSlice::get( const size_t row, const size_t assignment ) const
+{
+    return ( words[ row * lane_count + assignment / BitVector::word_bits ] >> ( assignment % BitVector::word_bits ) ) & 1;
+}
+
+void CompiledMatrix::BitSlice::set( const size_t row, const size_t assignment, const bool value )
+{
+    BitVector::word_type bit = ( BitVector::word_type ) 1 << ( assignment % BitVector::word_bits );
+    BitVector::word_type &word = words[ row * lane_count + assignment / BitVector::word_bits ];
+
+    word = value? ( word | bit ) : ( word & ~bit );
+}
+
+BitVector::word_type *CompiledMatrix::BitSlice::row( const size_t row )
+{
+    return words.data() + row * lane_count;
+}
+
+const BitVector::word_type *CompiledMatrix::BitSlice::row( const size_t row ) const
+{
+    return words.data() + row * lane_count;
+}
+
+CompiledMatrix::Assignment::Assignment( const size_t identifiers ) : True( identifiers ), False( identifiers )
+{
+}
+
+void CompiledMatrix::Assignment::set( const SymbolTable::id_type identifier, const bool value )
+{
+    True.set( identifier, value );
+    False.set( identifier, !value );
+}
+
+void CompiledMatrix::Assignment::unset( const SymbolTable::id_type identifier )
+{
+    True.reset( identifier );
+    False.reset( identifier );
+}
+
+void CompiledMatrix::Assignment::clear()
+{
+    True.reset();
+    False.reset();
+}
+
+CompiledMatrix::CompiledMatrix() : identifiers( 0 ), mask_words( 0 ), statement_offsets( 1, 0 ), term_offsets( 1, 0 ),
+    literal_offsets( 1, 0 ), term_statement_offsets( 1, 0 )
+{
+}
+
+CompiledMatrix::CompiledMatrix( const LogicalMatrix &matrix ) : symbols( matrix.symbols ), identifiers( 0 ), mask_words( 0 ),
+    statement_offsets( 1, 0 ), term_offsets( 1, 0 ), literal_offsets( 1, 0 ), term_statement_offsets( 1, 0 )
+{
+    if( matrix.empty() )
+    {
+        return;
+    }
+
+    if( matrix.form() == LogicalMatrix::CNF )
+    {
+        *this = CompiledMatrix( matrix.to_DNF() );
+        return;
+    }
+
+    if( matrix.storage() == LogicalMatrix::TermMajor )
+    { // compiled from the literal lists of a Sparse copy
+        LogicalMatrix listed( matrix );
+
+        listed.make_sparse();
+        *this = CompiledMatrix( listed );
+        return;
+    }
+
+    size_t index, size = matrix.term_count();
+
+    identifiers = symbols->size();
+    mask_words = ( identifiers + BitVector::word_bits - 1 ) / BitVector::word_bits;
+
+    positive.assign( size * mask_words, 0 );
+    negative.assign( size * mask_words, 0 );
+    first_word.assign( size, mask_words );
+    last_word.assign( size, 0 );
+
+    if( matrix.storage() == LogicalMatrix::Sparse )
+    { // the literal lists are taken as they are and the masks filled from them
+        term_offsets = matrix.term_offsets;
+        term_literals = matrix.term_literals;
+        statement_offsets = matrix.statement_offsets;
+        statement_terms = matrix.statement_terms;
+
+        for( index = 0; index < size; ++index )
+        {
+            for( size_t position = term_offsets[ index ]; position < term_offsets[ index + 1 ]; ++position )
+            {
+                uint32_t identifier = term_literals[ position ] / 2;
+                size_t word = identifier / BitVector::word_bits;
+
+                ( ( term_literals[ position ] & 1 )? negative : positive )[ index * mask_words + word ] |= ( BitVector::word_type ) 1 << ( identifier % BitVector::word_bits );
+                first_word[ index ] = std::min< uint32_t >( first_word[ index ], word );
+                last_word[ index ] = std::max< uint32_t >( last_word[ index ], word + 1 );
+            }
+        }
+
+        build_index();
+        return;
+    }
+
+    auto add_literals = [ this ]( std::vector< BitVector::word_type > &masks, const BitVector &input_vector, const SymbolTable::id_type &identifier )
+    {
+        size_t word = identifier / BitVector::word_bits;
+
+        for( size_t term = input_vector.find_first(); term != BitVector::npos; term = input_vector.find_next( term ) )
+        {
+            masks[ term * mask_words + word ] |= ( BitVector::word_type ) 1 << ( identifier % BitVector::word_bits );
+            first_word[ term ] = std::min< uint32_t >( first_word[ term ], word );
+            last_word[ term ] = std::max< uint32_t >( last_word[ term ], word + 1 );
+        }
+    };
+
+    for( LogicalMatrix::TruthTable const& table : matrix.AND_matrix )
+    {
+        add_literals( positive, table.True, table.identifier );
+        add_literals( negative, table.False, table.identifier );
+    }
+
+    for( index = 0; index < size; ++index )
+    {
+        for( size_t word = first_word[ index ]; word < last_word[ index ]; ++word )
+        {
+            BitVector::word_type positive_word = positive[ index * mask_words + word ],
+                negative_word = negative[ index * mask_words + word ],
+                remaining = positive_word | negative_word;
+
+            for( ; remaining != 0; remaining &= remaining - 1 )
+            {
+                size_t bit = __builtin_ctzll( remaining );
+                uint32_t identifier = word * BitVector::word_bits + bit;
+
+                if( ( positive_word >> bit ) & 1 )
+                {
+                    term_literals.push_back( identifier * 2 );
+                }
+
+                if( ( negative_word >> bit ) & 1 )
+                {
+                    term_literals.push_back( identifier * 2 + 1 );
+                }
+            }
+        }
+
+        term_offsets.push_back( term_literals.size() );
+    }
+
+    for( BitVector const& statement : matrix.OR_matrix )
+    {
+        for( index = statement.find_first(); index != BitVector::npos; index = statement.find_next( index ) )
+        {
+            statement_terms.push_back( index );
+        }
+
+        statement_offsets.push_back( statement_terms.size() );
+    }
+
+    build_index();
+}
+
+// inverts term_literals and statement_terms by counting then placing each entry
+void CompiledMatrix::build_index()
+{
+    size_t term, statement, index, terms = term_count();
+
+    literal_offsets.assign( 2 * identifiers + 1, 0 );
+    term_statement_offsets.assign( terms + 1, 0 );
+
+    for( uint32_t const& literal : term_literals )
+    {
+        ++literal_offsets[ literal + 1 ];
+    }
+
+    for( uint32_t const& term_index : statement_terms )
+    {
+        ++term_statement_offsets[ term_index + 1 ];
+    }
+
+    std::partial_sum( literal_offsets.begin(), literal_offsets.end(), literal_offsets.begin() );
+    std::partial_sum( term_statement_offsets.begin(), term_statement_offsets.end(), term_statement_offsets.begin() );
+    literal_terms.resize( literal_offsets.back() );
+    term_statements.resize( term_statement_offsets.back() );
+
+    std::vector< uint32_t > cursor( literal_offsets.begin(), literal_offsets.end() - 1 );
+
+    for( term = 0; term < terms; ++term )
+    {
+        for( index = term_offsets[ term ]; index < term_offsets[ term + 1 ]; ++index )
+        {
+            literal_terms[ cursor[ term_literals[ index ] ]++ ] = term;
+        }
+    }
+
+    cursor.assign( term_statement_offsets.begin(), term_statement_offsets.end() - 1 );
+
+    for( statement = 0; statement < statement_count(); ++statement )
+    {
+        for( index = statement_offsets[ statement ]; index < statement_offsets[ statement + 1 ]; ++index )
+        {
+            term = statement_terms[ index ];
+            term_statements[ cursor[ term ]++ ] = statement;
+
+            if( term_offsets[ term ] == term_offsets[ term + 1 ] )
+            {
+                constant_statements.push_back( statement );
+            }
+        }
+    }
+}
+
+CompiledMatrix::Assignment CompiledMatrix::make_assignment() const
+{
+    return Assignment( identifiers );
+}
+
+// identifiers unknown to the SymbolTable are ignored
+CompiledMatrix::Assignment CompiledMatrix::make_assignment( const std::map< std::string, bool > &identifier_values ) const
+{
+    Assignment assignment( identifiers );
+    SymbolTable::id_type identifier;
+
+    for( auto const& [ key, value ] : identifier_values )
+    {
+        if( symbols && ( identifier = symbols->find( key ) ) < identifiers )
+        {
+            assignment.set( identifier, value );
+        }
+    }
+
+    return assignment;
+}
+
+CompiledMatrix::ResultBitset CompiledMatrix::make_result() const
+{
+    return ResultBitset( statement_count() );
+}
+
+bool CompiledMatrix::satisfied( const size_t term, const BitVector::word_type *True, const BitVector::word_type *False ) const
+{
+    const BitVector::word_type *positive_mask = positive.data() + term * mask_words,
+        *negative_mask = negative.data() + term * mask_words;
+
+    for( size_t word = first_word[ term ]; word < last_word[ term ]; ++word )
+    {
+        if( ( positive_mask[ word ] & ~True[ word ] ) | ( negative_mask[ word ] & ~False[ word ] ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// assignment must come from make_assignment and result from make_result, nothing is allocated
+void CompiledMatrix::evaluate( const Assignment &assignment, ResultBitset &result ) const
+{
+    size_t statement, index;
+    const BitVector::word_type *True = assignment.True.data(), *False = assignment.False.data();
+
+    result.reset();
+
+    for( statement = 0; statement + 1 < statement_offsets.size(); ++statement )
+    {
+        for( index = statement_offsets[ statement ]; index < statement_offsets[ statement + 1 ]; ++index )
+        {
+            if( satisfied( statement_terms[ index ], True, False ) )
+            {
+                result.set( statement );
+                break;
+            }
+        }
+    }
+}
+
+// An AND set holds once as many of its literals hold as it has, each known identifier makes one of its two literals hold
+void CompiledMatrix::evaluate_sparse( const Assignment &assignment, ResultBitset &result, std::vector< uint32_t > &counts ) const
+{
+    size_t identifier, index, position;
+
+    if( counts.size() < term_count() )
+    {
+        counts.resize( term_count(), 0 );
+    }
+
+    result.reset();
+
+    for( uint32_t const& statement : constant_statements )
+    {
+        result.set( statement );
+    }
+
+    auto visit = [ & ]( const BitVector &known, const uint32_t negated, const bool count )
+    {
+        for( identifier = known.find_first(); identifier != BitVector::npos && identifier < identifiers; identifier = known.find_next( identifier ) )
+        {
+            uint32_t literal = identifier * 2 + negated;
+
+            for( index = literal_offsets[ literal ]; index < literal_offsets[ literal + 1 ]; ++index )
+            {
+                uint32_t term = literal_terms[ index ];
+
+                if( !count )
+                {
+                    counts[ term ] = 0;
+                }
+                else if( ++counts[ term ] == term_offsets[ term + 1 ] - term_offsets[ term ] )
+                {
+                    for( position = term_statement_offsets[ term ]; position < term_statement_offsets[ term + 1 ]; ++position )
+                    {
+                        result.set( term_statements[ position ] );
+                    }
+                }
+            }
+        }
+    };
+
+    visit( assignment.True, 0, true );
+    visit( assignment.False, 1, true );
+    visit( assignment.True, 0, false );
+    visit( assignment.False, 1, false );
+}
+
+std::vector< bool > CompiledMatrix::evaluate( const std::map< std::string, bool > &identifier_values ) const
+{
+    ResultBitset result = make_result();
+    std::vector< bool > result_vector( statement_count() );
+    std::vector< uint32_t > counts;
+
+    evaluate_sparse( make_assignment( identifier_values ), result, counts );
+
+    for( size_t index = 0; index < result_vector.size(); ++index )
+    {
+        result_vector[ index ] = result[ index ];
+    }
+
+    return result_vector;
+}
+
+CompiledMatrix::BitSlice CompiledMatrix::make_batch( const size_t assignments ) const
+{
+    return BitSlice( identifiers, assignments );
+}
+
+CompiledMatrix::BitSlice CompiledMatrix::make_batch_result( const size_t assignments ) const
+{
+    return BitSlice( statement_count(), assignments );
+}
+
+// the widest kernel the running CPU supports
+CompiledMatrix::Kernel CompiledMatrix::supported_kernel()
+{
+#ifdef COMPILEDMATRIX_X86
+    static const Kernel kernel = __builtin_cpu_supports( "avx512f" )? AVX512 : __builtin_cpu_supports( "avx2" )? AVX2 : Scalar;
+
+    return kernel;
+#else
+    return Scalar;
+#endif
+}
+
+// the kernels follow raw rows, so slices of another shape would be read or written past their words
+void CompiledMatrix::check_batch( const BitSlice &assignments, const BitSlice &results ) const
+{
+    if( assignments.rows() < identifiers || results.rows() != statement_count() || assignments.lanes() != results.lanes() )
+    {
+        throw Batchexception();
+    }
+}
+
+// every identifier of the batch is known, an identifier without a row must not appear in this
+void CompiledMatrix::evaluate_batch( const BitSlice &assignments, BitSlice &results, const Kernel kernel ) const
+{
+    std::vector< BitVector::word_type > scratch;
+
+    check_batch( assignments, results );
+
+    evaluate_batch( assignments.row( 0 ), assignments.lanes(), results.row( 0 ), 0, assignments.lanes(), scratch, kernel );
+}
+
+// each chunk of chunk_lanes lanes is a task of pool writing its own words of results, workers keep their own scratch
+void CompiledMatrix::evaluate_batch( const BitSlice &assignments, BitSlice &results, ThreadPool &pool, const size_t chunk_lanes,
+    const Kernel kernel ) const
+{
+    size_t lanes = assignments.lanes(), chunk = ( chunk_lanes == 0 )? 1 : chunk_lanes;
+    std::vector< std::vector< BitVector::word_type > > scratch( pool.size() );
+
+    check_batch( assignments, results );
+
+    pool.run( ( lanes + chunk - 1 ) / chunk, [ & ]( const size_t task, const size_t worker )
+    {
+        evaluate_batch( assignments.row( 0 ), lanes, results.row( 0 ), task * chunk, std::min( lanes, ( task + 1 ) * chunk ),
+            scratch[ worker ], kernel );
+    } );
+}
+
+// evaluates lanes [ begin_lane, end_lane ) of slices, holding identifiers() rows of lanes words, into results,
+// holding statement_count() rows of lanes words, scratch is resized as needed and may be reused between calls
+void CompiledMatrix::evaluate_batch( const BitVector::word_type *slices, const size_t lanes, BitVector::word_type *results,
+    const size_t begin_lane, const size_t end_lane, std::vector< BitVector::word_type > &scratch, Kernel kernel ) const
+{
+    size_t lane = begin_lane, terms = term_count(), statements = statement_count();
+
+    if( kernel == Automatic || kernel > supported_kernel() )
+    {
+        kernel = supported_kernel();
+    }
+
+    if( scratch.size() < terms * 8 )
+    {
+        scratch.resize( terms * 8 );
+    }
+
+#ifdef COMPILEDMATRIX_X86
+    if( kernel == AVX512 )
+    {
+        for( ; lane + 8 <= end_lane; lane += 8 )
+        {
+            evaluate_block_avx512( term_offsets.data(), term_literals.data(), terms, statement_offsets.data(), statement_terms.data(), statements,
+                slices, lanes, results, lane, scratch.data() );
+        }
+    }
+
+    if( kernel >= AVX2 )
+    {
+        for( ; lane + 4 <= end_lane; lane += 4 )
+        {
+            evaluate_block_avx2( term_offsets.data(), term_literals.data(), terms, statement_offsets.data(), statement_terms.data(), statements,
+                slices, lanes, results, lane, scratch.data() );
+        }
+    }
+#endif
+
+    for( ; lane < end_lane; ++lane )
+    {
+        evaluate_block< 1 >( term_offsets.data(), term_literals.data(), terms, statement_offsets.data(), statement_terms.data(), statements,
+            slices, lanes, results, lane, scratch.data() );
+    }
+}
+
+size_t CompiledMatrix::identifier_count() const
+{
+    return identifiers;
+}
+
+size_t CompiledMatrix::statement_count() const
+{
+    return statement_offsets.size() - 1;
+}
+
+size_t CompiledMatrix::term_count() const
+{
+    return first_word.size();
+}
+
+// whether any AND set has a literal of identifier
+bool CompiledMatrix::references( const SymbolTable::id_type identifier ) const
+{
+    return identifier < identifiers && literal_offsets[ 2 * identifier ] != literal_offsets[ 2 * identifier + 2 ];
+}
+
+const std::shared_ptr< SymbolTable > &CompiledMatrix::symbol_table() const
+{
+    return symbols;
+}
@@ -0,0 +1,140 @@
+// CompiledMatrix.h
+
+/** Header file for the CompiledMatrix class.
+ *
+ *  A CompiledMatrix is a read only snapshot of a LogicalMatrix laid out for
+ *  repeated evaluation. Each AND set is stored as a pair of literal masks over
+ *  the identifier ids of the SymbolTable and each statement as a list of its
+ *  AND sets, so evaluating an Assignment needs no heap allocation.
+ *
+ *  Batches of assignments can be evaluated bit sliced, 64 assignments per
+ *  word, using AVX2 or AVX-512 when the CPU supports them, and split across
+ *  the workers of a ThreadPool in chunks of lanes.
+ */
+
+#ifndef __CompiledMatrix_h_included__
+#define __CompiledMatrix_h_included__
+
+#include "BitVector.h"
+#include "LogicalMatrix.h"
+#include "SymbolTable.h"
+#include <exception>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class DeltaEvaluator;
+class ThreadPool;
+
+class CompiledMatrix
+{
+    friend class DeltaEvaluator;
+
+    public:
+        class Batchexception: public std::exception
+        {
+            public:
+                virtual const char* what() const throw()
+                {
+                    return "Batch shaped for another compiled matrix";
+                }
+        };
+
+        // The truth values of identifiers by id, an identifier set in neither True nor False is unknown
+        // and fails every AND set it appears in, matching identifiers missing from LogicalMatrix::evaluate
+        class Assignment
+        {
+            public:
+                BitVector True, False;
+
+                Assignment( const size_t identifiers = 0 );
+                void set( const SymbolTable::id_type identifier, const bool value );
+                void unset( const SymbolTable::id_type identifier );
+                void clear();
+        };
+
+        typedef BitVector ResultBitset;
+
+        // Bit sliced batch of assignments or results, one row per identifier id or statement
+        // bit k of word l in a row is the value for assignment l * 64 + k
+        class BitSlice
+        {
+            public:
+                BitSlice( const size_t rows = 0, const size_t assignments = 0 );
+
+                size_t rows() const;
+                size_t lanes() const;
+                size_t assignments() const;
+                bool get( const size_t row, const size_t assignment ) const;
+                void set( const size_t row, const size_t assignment, const bool value = true );
+                BitVector::word_type *row( const size_t row );
+                const BitVector::word_type *row( const size_t row ) const;
+
+            private:
+                size_t row_count, lane_count, assignment_count;
+                std::vector< BitVector::word_type > words;
+        };
+
+        enum Kernel { Automatic, Scalar, AVX2, AVX512 };
+
+        CompiledMatrix();
+        CompiledMatrix( const LogicalMatrix &matrix );
+
+        Assignment make_assignment() const;
+        Assignment make_assignment( const std::map< std::string, bool > &identifiers ) const;
+        ResultBitset make_result() const;
+
+        void evaluate( const Assignment &assignment, ResultBitset &result ) const;
+
+        // counts the literals that hold per AND set over the inverted index of the known identifiers only, so the cost
+        // follows the AND sets holding them rather than every AND set, counts is scratch left zeroed between calls
+        void evaluate_sparse( const Assignment &assignment, ResultBitset &result, std::vector< uint32_t > &counts ) const;
+        std::vector< bool > evaluate( const std::map< std::string, bool > &identifiers ) const;
+
+        BitSlice make_batch( const size_t assignments ) const;
+        BitSlice make_batch_result( const size_t assignments ) const;
+        // assignments must hold a row per identifier and results a row per statement over as many lanes, or Batchexception is thrown
+        // the overload over raw rows is not checked
+        void evaluate_batch( const BitSlice &assignments, BitSlice &results, const Kernel kernel = Automatic ) const;
+        void evaluate_batch( const BitSlice &assignments, BitSlice &results, ThreadPool &pool, const size_t chunk_lanes = 256,
+            const Kernel kernel = Automatic ) const;
+        void evaluate_batch( const BitVector::word_type *slices, const size_t lanes, BitVector::word_type *results,
+            const size_t begin_lane, const size_t end_lane, std::vector< BitVector::word_type > &scratch, Kernel kernel = Automatic ) const;
+        static Kernel supported_kernel();
+
+        size_t identifier_count() const;
+        size_t statement_count() const;
+        size_t term_count() const;
+        bool references( const SymbolTable::id_type identifier ) const;
+        const std::shared_ptr< SymbolTable > &symbol_table() const;
+
+    private:
+        std::shared_ptr< SymbolTable > symbols;
+        size_t identifiers, mask_words;
+
+        // literal masks of AND set t occupy words [ t * mask_words, ( t + 1 ) * mask_words )
+        // and only words [ first_word[ t ], last_word[ t ] ) of them can be non zero
+        std::vector< BitVector::word_type > positive, negative;
+        std::vector< uint32_t > first_word, last_word;
+
+        // AND sets of statement s are statement_terms[ statement_offsets[ s ] .. statement_offsets[ s + 1 ] )
+        std::vector< uint32_t > statement_offsets, statement_terms;
+
+        // literals of AND set t are term_literals[ term_offsets[ t ] .. term_offsets[ t + 1 ] ) stored as id * 2 + negated
+        std::vector< uint32_t > term_offsets, term_literals;
+
+        // the inverted index, AND sets holding literal l are literal_terms[ literal_offsets[ l ] .. literal_offsets[ l + 1 ] )
+        // and statements holding AND set t are term_statements[ term_statement_offsets[ t ] .. term_statement_offsets[ t + 1 ] )
+        std::vector< uint32_t > literal_offsets, literal_terms, term_statement_offsets, term_statements;
+
+        // statements holding an AND set without literals, which always holds
+        std::vector< uint32_t > constant_statements;
+
+        void build_index();
+        void check_batch( const BitSlice &assignments, const BitSlice &results ) const;
+
+        bool satisfied( const size_t term, const BitVector::word_type *True, const BitVector::word_type *False ) const;
+};
+
+#endif
@@ -0,0 +1,651 @@
+// DecisionDiagram.cpp
+
+/** Implementation file for the DecisionDiagram class.
+ */
+
+#include "DecisionDiagram.h"
+#include <algorithm>
+
+const DecisionDiagram::Manager::node_type DecisionDiagram::Manager::False;
+const DecisionDiagram::Manager::node_type DecisionDiagram::Manager::True;
+
+// the computed table doubles whenever the nodes outgrow it, up to this many entries
+static const size_t minimum_cache_size = 1 << 12, maximum_cache_size = 1 << 22;
+
+bool DecisionDiagram::Manager::Node::operator ==( const Node &other ) const
+{
+    return level == other.level && low == other.low && high == other.high;
+}
+
+size_t DecisionDiagram::Manager::NodeHash::operator ()( const Node &node ) const
+{
+    uint64_t hash = ( ( uint64_t ) node.low << 32 | node.high ) * 0x9E3779B97F4A7C15ULL ^ node.level * 0xC2B2AE3D27D4EB4FULL;
+
+    return hash ^ ( hash >> 29 );
+}
+
+// terminals FALSE and TRUE are the first two nodes, below every level
+DecisionDiagram::Manager::Manager( std::shared_ptr< SymbolTable > symbol_table, const std::vector< std::string > &order ) :
+    symbols( symbol_table? symbol_table : std::make_shared< SymbolTable >() ),
+    nodes( { Node{ uint32_t( -1 ), False, False }, Node{ uint32_t( -1 ), True, True } } ), computed( minimum_cache_size )
+{
+    for( std::string const& name : order )
+    {
+        level( symbols->intern( name ) );
+    }
+}
+
+size_t DecisionDiagram::Manager::level( const SymbolTable::id_type identifier )
+{
+    if( identifier >= levels.size() )
+    {
+        levels.resize( identifier + 1, -1 );
+    }
+
+    if( levels[ identifier ] == uint32_t( -1 ) )
+    {
+        levels[ identifier ] = identifiers.size();
+        identifiers.push_back( identifier );
+    }
+
+    return levels[ identifier ];
+}
+
+// identifier ids by level
+const std::vector< SymbolTable::id_type > &DecisionDiagram::Manager::order() const
+{
+    return identifiers;
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::literal( const SymbolTable::id_type identifier, const bool negated )
+{
+    return negated? make( level( identifier ), True, False ) : make( level( identifier ), False, True );
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::AND( const node_type left, const node_type right )
+{
+    return apply( And, left, right );
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::OR( const node_type left, const node_type right )
+{
+    return apply( Or, left, right );
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::NOT( const node_type node )
+{
+    return apply( Not, node, False );
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::restrict( const node_type node, const SymbolTable::id_type identifier, const bool value )
+{
+    if( identifier >= levels.size() || levels[ identifier ] == uint32_t( -1 ) )
+    {
+        return node;
+    }
+
+    return restrict_level( node, levels[ identifier ], value );
+}
+
+// terminals are at level uint32_t( -1 )
+size_t DecisionDiagram::Manager::node_level( const node_type node ) const
+{
+    return nodes[ node ].level;
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::low( const node_type node ) const
+{
+    return nodes[ node ].low;
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::high( const node_type node ) const
+{
+    return nodes[ node ].high;
+}
+
+size_t DecisionDiagram::Manager::size() const
+{
+    return nodes.size();
+}
+
+const std::shared_ptr< SymbolTable > &DecisionDiagram::Manager::symbol_table() const
+{
+    return symbols;
+}
+
+// the unique node testing level with these children, a test whose children are the same is skipped
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::make( const uint32_t level, const node_type low, const node_type high )
+{
+    if( low == high )
+    {
+        return low;
+    }
+
+    Node node{ level, low, high };
+    auto found = unique.find( node );
+
+    if( found != unique.end() )
+    {
+        return found->second;
+    }
+
+    node_type index = nodes.size();
+
+    nodes.push_back( node );
+    unique.emplace( node, index );
+
+    if( nodes.size() > 2 * computed.size() && computed.size() < maximum_cache_size )
+    {
+        computed.assign( 2 * computed.size(), CacheEntry() );
+    }
+
+    return index;
+}
+
+DecisionDiagram::Manager::CacheEntry &DecisionDiagram::Manager::cache_entry( const Operation operation, const node_type left, const node_type right )
+{
+    uint64_t hash = ( ( uint64_t ) left << 32 | right ) * 0x9E3779B97F4A7C15ULL + operation * 0xC2B2AE3D27D4EB4FULL;
+
+    return computed[ ( hash ^ ( hash >> 32 ) ) & ( computed.size() - 1 ) ];
+}
+
+// Shannon expansion on the topmost level of the operands, right is ignored by Not
+// The cache is looked up again after recursing since nodes made meanwhile may have resized it
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::apply( const Operation operation, node_type left, node_type right )
+{
+    switch( operation )
+    {
+        case And:
+            if( left == False || right == False )
+            {
+                return False;
+            }
+
+            if( left == True || left == right )
+            {
+                return right;
+            }
+
+            if( right == True )
+            {
+                return left;
+            }
+
+            break;
+
+        case Or:
+            if( left == True || right == True )
+            {
+                return True;
+            }
+
+            if( left == False || left == right )
+            {
+                return right;
+            }
+
+            if( right == False )
+            {
+                return left;
+            }
+
+            break;
+
+        default:
+            if( left == False || left == True )
+            {
+                return True - left;
+            }
+    }
+
+    if( left > right && operation != Not )
+    {
+        std::swap( left, right );
+    }
+
+    CacheEntry &entry = cache_entry( operation, left, right );
+
+    if( entry.operation == operation && entry.left == left && entry.right == right )
+    {
+        return entry.result;
+    }
+
+    uint32_t level = std::min( nodes[ left ].level, operation == Not? uint32_t( -1 ) : nodes[ right ].level );
+    node_type left_low = left, left_high = left, right_low = right, right_high = right;
+
+    if( nodes[ left ].level == level )
+    {
+        left_low = nodes[ left ].low;
+        left_high = nodes[ left ].high;
+    }
+
+    if( operation != Not && nodes[ right ].level == level )
+    {
+        right_low = nodes[ right ].low;
+        right_high = nodes[ right ].high;
+    }
+
+    node_type low_result = apply( operation, left_low, right_low ),
+        high_result = apply( operation, left_high, right_high ),
+        result = make( level, low_result, high_result );
+
+    cache_entry( operation, left, right ) = CacheEntry{ operation, left, right, result };
+
+    return result;
+}
+
+DecisionDiagram::Manager::node_type DecisionDiagram::Manager::restrict_level( const node_type node, const uint32_t level, const bool value )
+{
+    if( nodes[ node ].level > level )
+    {
+        return node;
+    }
+
+    if( nodes[ node ].level == level )
+    {
+        return value? nodes[ node ].high : nodes[ node ].low;
+    }
+
+    Operation operation = value? RestrictHigh : RestrictLow;
+    CacheEntry &entry = cache_entry( operation, node, level );
+
+    if( entry.operation == operation && entry.left == node && entry.right == level )
+    {
+        return entry.result;
+    }
+
+    node_type low_result = restrict_level( nodes[ node ].low, level, value ),
+        high_result = restrict_level( nodes[ node ].high, level, value ),
+        result = make( nodes[ node ].level, low_result, high_result );
+
+    cache_entry( operation, node, level ) = CacheEntry{ operation, node, level, result };
+
+    return result;
+}
+
+DecisionDiagram::DecisionDiagram( const LogicalMatrix &matrix, const std::vector< std::string > &order ) :
+    DecisionDiagram( matrix, std::make_shared< Manager >( matrix.symbols, order ) )
+{
+}
+
+// each AND set, or OR set in CNF, is built from its lowest literal up so every step adds a single node
+DecisionDiagram::DecisionDiagram( const LogicalMatrix &matrix, const std::shared_ptr< Manager > &manager ) : nodes( manager )
+{
+    if( matrix.empty() )
+    {
+        return;
+    }
+
+    LogicalMatrix rebound;
+    const bool convert = matrix.symbols != nodes->symbol_table() || matrix.storage() != LogicalMatrix::Dense;
+
+    if( convert )
+    { // nodes are built from the columns of dense storage
+        rebound = matrix.rebind( nodes->symbol_table() );
+        rebound.make_dense();
+    }
+
+    const LogicalMatrix &source = convert? rebound : matrix;
+    const bool conjunctive = source.form() == LogicalMatrix::CNF;
+    size_t index, size = source.OR_matrix[ 0 ].size();
+    std::vector< std::vector< Manager::node_type > > column_literals( size );
+    std::vector< Manager::node_type > columns( size );
+
+    for( LogicalMatrix::TruthTable const& table : source.AND_matrix )
+    {
+        for( index = table.True.find_first(); index != BitVector::npos; index = table.True.find_next( index ) )
+        {
+            column_literals[ index ].push_back( nodes->literal( table.identifier ) );
+        }
+
+        for( index = table.False.find_first(); index != BitVector::npos; index = table.False.find_next( index ) )
+        {
+            column_literals[ index ].push_back( nodes->literal( table.identifier, true ) );
+        }
+    }
+
+    for( index = 0; index < size; ++index )
+    {
+        std::sort( column_literals[ index ].begin(), column_literals[ index ].end(), [ this ]( const Manager::node_type left, const Manager::node_type right )
+        {
+            return nodes->node_level( left ) > nodes->node_level( right );
+        } );
+
+        columns[ index ] = conjunctive? Manager::False : Manager::True;
+
+        for( Manager::node_type const& literal : column_literals[ index ] )
+        {
+            columns[ index ] = conjunctive? nodes->OR( literal, columns[ index ] ) : nodes->AND( literal, columns[ index ] );
+        }
+    }
+
+    for( BitVector const& row : source.OR_matrix )
+    {
+        statements.push_back( conjunctive? Manager::True : Manager::False );
+
+        for( index = row.find_first(); index != BitVector::npos; index = row.find_next( index ) )
+        {
+            statements.back() = conjunctive? nodes->AND( statements.back(), columns[ index ] ) : nodes->OR( statements.back(), columns[ index ] );
+        }
+    }
+}
+
+DecisionDiagram DecisionDiagram::operator !() const
+{
+    DecisionDiagram result( *this );
+
+    for( Manager::node_type& root : result.statements )
+    {
+        root = nodes->NOT( root );
+    }
+
+    return result;
+}
+
+DecisionDiagram DecisionDiagram::operator &( const DecisionDiagram &other ) const
+{
+    DecisionDiagram result( *this );
+    return result &= other;
+}
+
+// every statement of this with every statement of other, as LogicalMatrix &=
+DecisionDiagram &DecisionDiagram::operator &=( const DecisionDiagram &other )
+{
+    combine( other, true );
+    return *this;
+}
+
+DecisionDiagram DecisionDiagram::operator |( const DecisionDiagram &other ) const
+{
+    DecisionDiagram result( *this );
+    return result |= other;
+}
+
+// every statement of this with every statement of other, as LogicalMatrix |=
+DecisionDiagram &DecisionDiagram::operator |=( const DecisionDiagram &other )
+{
+    combine( other, false );
+    return *this;
+}
+
+DecisionDiagram DecisionDiagram::operator +( const DecisionDiagram &other ) const
+{
+    DecisionDiagram result( *this );
+    return result += other;
+}
+
+DecisionDiagram &DecisionDiagram::operator +=( const DecisionDiagram &other )
+{
+    if( empty() )
+    {
+        return *this = other;
+    }
+
+    if( !other.empty() )
+    {
+        check_manager( other );
+        statements.insert( statements.end(), other.statements.begin(), other.statements.end() );
+    }
+
+    return *this;
+}
+
+// statements of one Manager are equivalent exactly when their roots are the same node
+bool DecisionDiagram::operator ==( const DecisionDiagram &other ) const
+{
+    return statements == other.statements && ( empty() || nodes == other.nodes );
+}
+
+DecisionDiagram DecisionDiagram::restrict( const std::string &identifier, const bool value ) const
+{
+    DecisionDiagram result( *this );
+
+    if( empty() )
+    {
+        return result;
+    }
+
+    SymbolTable::id_type id = nodes->symbol_table()->find( identifier );
+
+    if( id != SymbolTable::npos )
+    {
+        for( Manager::node_type& root : result.statements )
+        {
+            root = nodes->restrict( root, id, value );
+        }
+    }
+
+    return result;
+}
+
+std::vector< bool > DecisionDiagram::evaluate( const std::map< std::string, bool > &identifiers ) const
+{
+    std::vector< bool > result;
+
+    if( empty() )
+    {
+        return result;
+    }
+
+    // the value of each level, -1 for identifiers missing from identifiers
+    const std::vector< SymbolTable::id_type > &order = nodes->order();
+    std::vector< int8_t > values( order.size(), -1 );
+
+    for( size_t level = 0; level < order.size(); ++level )
+    {
+        auto identifier = identifiers.find( nodes->symbol_table()->name( order[ level ] ) );
+
+        if( identifier != identifiers.end() )
+        {
+            values[ level ] = identifier->second;
+        }
+    }
+
+    for( Manager::node_type node : statements )
+    {
+        while( node != Manager::False && node != Manager::True )
+        {
+            int8_t value = values[ nodes->node_level( node ) ];
+
+            node = ( value < 0 )? Manager::False : value? nodes->high( node ) : nodes->low( node );
+        }
+
+        result.push_back( node == Manager::True );
+    }
+
+    return result;
+}
+
+// A statement that is always TRUE becomes x | !x and one that is always FALSE x & !x, x being the first identifier of the order
+LogicalMatrix DecisionDiagram::to_matrix( const size_t &limit ) const
+{
+    LogicalMatrix result;
+
+    if( empty() )
+    {
+        return result;
+    }
+
+    const std::vector< SymbolTable::id_type > &order = nodes->order();
+    std::vector< uint32_t > term_offsets( 1, 0 ), term_literals, term_statements, path, identifiers;
+    size_t index, statement;
+
+    // literals are stored as id * 2 + negated
+    auto add_term = [ & ]( const std::vector< uint32_t > &literals, const size_t statement )
+    {
+        if( term_statements.size() == limit )
+        {
+            throw LogicalMatrix::Logicalsizeexception();
+        }
+
+        term_literals.insert( term_literals.end(), literals.begin(), literals.end() );
+        term_offsets.push_back( term_literals.size() );
+        term_statements.push_back( statement );
+    };
+
+    auto paths = [ & ]( auto &self, const Manager::node_type node, const size_t statement ) -> void
+    {
+        if( node == Manager::True )
+        {
+            add_term( path, statement );
+        }
+        else if( node != Manager::False )
+        {
+            uint32_t identifier = order[ nodes->node_level( node ) ];
+
+            path.push_back( identifier * 2 );
+            self( self, nodes->high( node ), statement );
+            path.back() = identifier * 2 + 1;
+            self( self, nodes->low( node ), statement );
+            path.pop_back();
+        }
+    };
+
+    for( statement = 0; statement < statements.size(); ++statement )
+    {
+        if( statements[ statement ] == Manager::True )
+        {
+            add_term( { order.front() * 2 }, statement );
+            add_term( { order.front() * 2 + 1 }, statement );
+        }
+        else if( statements[ statement ] == Manager::False )
+        {
+            add_term( { order.front() * 2, order.front() * 2 + 1 }, statement );
+        }
+        else
+        {
+            paths( paths, statements[ statement ], statement );
+        }
+    }
+
+    size_t size = term_statements.size();
+    std::vector< uint32_t > position( nodes->symbol_table()->size(), -1 );
+
+    for( uint32_t const& literal : term_literals )
+    {
+        identifiers.push_back( literal / 2 );
+    }
+
+    std::sort( identifiers.begin(), identifiers.end() );
+    identifiers.erase( std::unique( identifiers.begin(), identifiers.end() ), identifiers.end() );
+
+    result.symbols = nodes->symbol_table();
+
+    for( uint32_t const& identifier : identifiers )
+    {
+        position[ identifier ] = result.AND_matrix.size();
+        result.AND_matrix.emplace_back( identifier, size );
+    }
+
+    result.OR_matrix.assign( statements.size(), BitVector( size ) );
+
+    for( index = 0; index < size; ++index )
+    {
+        for( size_t literal = term_offsets[ index ]; literal < term_offsets[ index + 1 ]; ++literal )
+        {
+            LogicalMatrix::TruthTable &table = result.AND_matrix.write()[ position[ term_literals[ literal ] / 2 ] ];
+
+            ( ( term_literals[ literal ] & 1 )? table.False : table.True ).set( index );
+        }
+
+        result.OR_matrix.write()[ term_statements[ index ] ].set( index );
+    }
+
+    result.trim();
+
+    return result;
+}
+
+size_t DecisionDiagram::statement_count() const
+{
+    return statements.size();
+}
+
+// distinct nodes reachable from any statement, terminals included
+size_t DecisionDiagram::node_count() const
+{
+    if( empty() )
+    {
+        return 0;
+    }
+
+    BitVector visited( nodes->size() );
+    std::vector< Manager::node_type > stack( statements );
+    size_t count = 0;
+
+    while( !stack.empty() )
+    {
+        Manager::node_type node = stack.back();
+
+        stack.pop_back();
+
+        if( visited[ node ] )
+        {
+            continue;
+        }
+
+        visited.set( node );
+        ++count;
+
+        if( node != Manager::False && node != Manager::True )
+        {
+            stack.push_back( nodes->low( node ) );
+            stack.push_back( nodes->high( node ) );
+        }
+    }
+
+    return count;
+}
+
+bool DecisionDiagram::empty() const
+{
+    return statements.empty();
+}
+
+const std::vector< DecisionDiagram::Manager::node_type > &DecisionDiagram::roots() const
+{
+    return statements;
+}
+
+const std::shared_ptr< DecisionDiagram::Manager > &DecisionDiagram::manager() const
+{
+    return nodes;
+}
+
+void DecisionDiagram::check_manager( const DecisionDiagram &other ) const
+{
+    if( nodes != other.nodes )
+    {
+        throw Diagramexception();
+    }
+}
+
+void DecisionDiagram::combine( const DecisionDiagram &other, const bool conjunction )
+{
+    if( other.empty() )
+    {
+        return;
+    }
+
+    if( empty() )
+    {
+        *this = other;
+        return;
+    }
+
+    check_manager( other );
+
+    std::vector< Manager::node_type > result;
+
+    result.reserve( statements.size() * other.statements.size() );
+
+    for( Manager::node_type const& root : statements )
+    {
+        for( Manager::node_type const& other_root : other.statements )
+        {
+            result.push_back( conjunction? nodes->AND( root, other_root ) : nodes->OR( root, other_root ) );
+        }
+    }
+
+    statements = std::move( result );
+}
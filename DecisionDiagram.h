@@ -0,0 +1,143 @@
+// DecisionDiagram.h
+
+/** Header file for the DecisionDiagram class.
+ *
+ *  A DecisionDiagram holds the statements of a LogicalMatrix as reduced
+ *  ordered binary decision diagrams. Its nodes live in a Manager shared by
+ *  every diagram built on it, which keeps each node unique and caches the
+ *  results of operations, so equivalent statements of one Manager have the
+ *  same root and & | ! never expand into AND sets.
+ *
+ *  Identifiers are tested in the order given to the Manager, identifiers not
+ *  given are ordered after them by first use. Nodes are never freed while
+ *  their Manager lives and a Manager must not be used from several threads.
+ */
+
+#ifndef __DecisionDiagram_h_included__
+#define __DecisionDiagram_h_included__
+
+#include "LogicalMatrix.h"
+#include "SymbolTable.h"
+#include <exception>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DecisionDiagram
+{
+    public:
+        class Diagramexception: public std::exception
+        {
+            public:
+                virtual const char* what() const throw()
+                {
+                    return "Decision diagrams of different managers";
+                }
+        };
+
+        class Manager
+        {
+            public:
+                typedef uint32_t node_type;
+
+                static const node_type False = 0, True = 1;
+
+                Manager( std::shared_ptr< SymbolTable > symbol_table = nullptr, const std::vector< std::string > &order = {} );
+
+                Manager( const Manager& ) = delete;
+                Manager &operator =( const Manager& ) = delete;
+
+                // the level of identifier, identifiers without one are placed after every other level
+                size_t level( const SymbolTable::id_type identifier );
+                const std::vector< SymbolTable::id_type > &order() const;
+
+                node_type literal( const SymbolTable::id_type identifier, const bool negated = false );
+                node_type AND( const node_type left, const node_type right );
+                node_type OR( const node_type left, const node_type right );
+                node_type NOT( const node_type node );
+                node_type restrict( const node_type node, const SymbolTable::id_type identifier, const bool value );
+
+                size_t node_level( const node_type node ) const;
+                node_type low( const node_type node ) const;
+                node_type high( const node_type node ) const;
+                size_t size() const;
+                const std::shared_ptr< SymbolTable > &symbol_table() const;
+
+            private:
+                class Node
+                {
+                    public:
+                        uint32_t level;
+                        node_type low, high;
+
+                        bool operator ==( const Node &other ) const;
+                };
+
+                class NodeHash
+                {
+                    public:
+                        size_t operator ()( const Node &node ) const;
+                };
+
+                enum Operation : uint32_t { And, Or, Not, RestrictLow, RestrictHigh };
+
+                // lossy computed table, an entry is overwritten by any later operation hashing to its slot
+                class CacheEntry
+                {
+                    public:
+                        uint32_t operation = -1;
+                        node_type left = 0, right = 0, result = 0;
+                };
+
+                std::shared_ptr< SymbolTable > symbols;
+                std::vector< Node > nodes;
+                std::unordered_map< Node, node_type, NodeHash > unique;
+                std::vector< CacheEntry > computed;
+                std::vector< SymbolTable::id_type > identifiers;
+                std::vector< uint32_t > levels;
+
+                node_type make( const uint32_t level, const node_type low, const node_type high );
+                CacheEntry &cache_entry( const Operation operation, const node_type left, const node_type right );
+                node_type apply( const Operation operation, node_type left, node_type right );
+                node_type restrict_level( const node_type node, const uint32_t level, const bool value );
+        };
+
+        DecisionDiagram() {}
+        DecisionDiagram( const LogicalMatrix &matrix, const std::vector< std::string > &order = {} );
+        DecisionDiagram( const LogicalMatrix &matrix, const std::shared_ptr< Manager > &manager );
+
+        DecisionDiagram operator !() const;
+        DecisionDiagram operator &( const DecisionDiagram &other ) const;
+        DecisionDiagram &operator &=( const DecisionDiagram &other );
+        DecisionDiagram operator |( const DecisionDiagram &other ) const;
+        DecisionDiagram &operator |=( const DecisionDiagram &other );
+        DecisionDiagram operator +( const DecisionDiagram &other ) const;
+        DecisionDiagram &operator +=( const DecisionDiagram &other );
+        bool operator ==( const DecisionDiagram &other ) const;
+
+        // every statement with identifier fixed to value, identifiers unknown to the SymbolTable change nothing
+        DecisionDiagram restrict( const std::string &identifier, const bool value ) const;
+
+        // identifiers missing from identifiers fail every path testing them, as they fail the AND sets of to_matrix()
+        std::vector< bool > evaluate( const std::map< std::string, bool > &identifiers ) const;
+
+        // one AND set per path to TRUE, trimmed as any LogicalMatrix, throwing Logicalsizeexception past limit paths
+        LogicalMatrix to_matrix( const size_t &limit = LogicalMatrix::default_conversion_limit ) const;
+
+        size_t statement_count() const;
+        size_t node_count() const;
+        bool empty() const;
+        const std::vector< Manager::node_type > &roots() const;
+        const std::shared_ptr< Manager > &manager() const;
+
+    private:
+        std::shared_ptr< Manager > nodes;
+        std::vector< Manager::node_type > statements;
+
+        void check_manager( const DecisionDiagram &other ) const;
+        void combine( const DecisionDiagram &other, const bool conjunction );
+};
+
+#endif
@@ -0,0 +1,148 @@
+// DeltaEvaluator.cpp
+
+/** Implementation file for the DeltaEvaluator class.
+ */
+
+#include "DeltaEvaluator.h"
+#include <algorithm>
+
+// the inverted index of compiled is copied, each AND set starts with none of its literals holding
+DeltaEvaluator::DeltaEvaluator( const CompiledMatrix &compiled ) : symbols( compiled.symbols ), values( compiled.identifiers, -1 ),
+    literal_offsets( compiled.literal_offsets ), literal_terms( compiled.literal_terms ), term_offsets( compiled.term_statement_offsets ),
+    term_statements( compiled.term_statements ), satisfied_terms( compiled.statement_count(), 0 ), current( compiled.statement_count() ),
+    reported( compiled.statement_count() ), pending( compiled.statement_count() )
+{
+    for( size_t term = 0; term < compiled.term_count(); ++term )
+    {
+        unsatisfied.push_back( compiled.term_offsets[ term + 1 ] - compiled.term_offsets[ term ] );
+    }
+
+    for( uint32_t const& statement : compiled.constant_statements )
+    {
+        ++satisfied_terms[ statement ];
+        current.set( statement );
+    }
+
+    reported = current;
+}
+
+DeltaEvaluator::DeltaEvaluator( const CompiledMatrix &compiled, const CompiledMatrix::Assignment &assignment ) : DeltaEvaluator( compiled )
+{
+    for( SymbolTable::id_type identifier = 0; identifier < values.size(); ++identifier )
+    {
+        if( identifier < assignment.True.size() && ( assignment.True[ identifier ] || assignment.False[ identifier ] ) )
+        {
+            set( identifier, assignment.True[ identifier ] );
+        }
+    }
+
+    changes();
+}
+
+// the AND sets holding literal gain or lose one literal that holds, statements whose count of AND sets that hold
+// leaves or reaches zero change value
+void DeltaEvaluator::update_literal( const uint32_t literal, const bool holds )
+{
+    for( size_t index = literal_offsets[ literal ]; index < literal_offsets[ literal + 1 ]; ++index )
+    {
+        uint32_t term = literal_terms[ index ];
+
+        if( holds? --unsatisfied[ term ] != 0 : unsatisfied[ term ]++ != 0 )
+        {
+            continue;
+        }
+
+        for( size_t position = term_offsets[ term ]; position < term_offsets[ term + 1 ]; ++position )
+        {
+            uint32_t statement = term_statements[ position ];
+
+            if( holds? satisfied_terms[ statement ]++ != 0 : --satisfied_terms[ statement ] != 0 )
+            {
+                continue;
+            }
+
+            current.set( statement, holds );
+
+            if( !pending[ statement ] )
+            {
+                pending.set( statement );
+                touched.push_back( statement );
+            }
+        }
+    }
+}
+
+void DeltaEvaluator::set( const SymbolTable::id_type identifier, const bool value )
+{
+    if( identifier >= values.size() || values[ identifier ] == value )
+    {
+        return;
+    }
+
+    if( values[ identifier ] >= 0 )
+    {
+        update_literal( identifier * 2 + value, false );
+    }
+
+    values[ identifier ] = value;
+    update_literal( identifier * 2 + !value, true );
+}
+
+void DeltaEvaluator::set( const std::string &identifier, const bool value )
+{
+    set( symbols? symbols->find( identifier ) : SymbolTable::npos, value );
+}
+
+void DeltaEvaluator::unset( const SymbolTable::id_type identifier )
+{
+    if( identifier >= values.size() || values[ identifier ] < 0 )
+    {
+        return;
+    }
+
+    update_literal( identifier * 2 + !values[ identifier ], false );
+    values[ identifier ] = -1;
+}
+
+void DeltaEvaluator::unset( const std::string &identifier )
+{
+    unset( symbols? symbols->find( identifier ) : SymbolTable::npos );
+}
+
+bool DeltaEvaluator::value( const size_t statement ) const
+{
+    return current[ statement ];
+}
+
+const CompiledMatrix::ResultBitset &DeltaEvaluator::result() const
+{
+    return current;
+}
+
+// a statement changed back to its reported value by a later set() is left out
+std::vector< size_t > DeltaEvaluator::changes()
+{
+    std::vector< size_t > result;
+
+    std::sort( touched.begin(), touched.end() );
+
+    for( uint32_t const& statement : touched )
+    {
+        pending.reset( statement );
+
+        if( current[ statement ] != reported[ statement ] )
+        {
+            reported.set( statement, current[ statement ] );
+            result.push_back( statement );
+        }
+    }
+
+    touched.clear();
+
+    return result;
+}
+
+size_t DeltaEvaluator::statement_count() const
+{
+    return current.size();
+}
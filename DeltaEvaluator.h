@@ -0,0 +1,64 @@
+// DeltaEvaluator.h
+
+/** Header file for the DeltaEvaluator class.
+ *
+ *  A DeltaEvaluator keeps the result of a CompiledMatrix under an assignment
+ *  that changes one identifier at a time. Each AND set counts its literals
+ *  that do not hold and each statement counts its AND sets that do, so set()
+ *  only visits the AND sets holding the identifier it changes.
+ *
+ *  Statements whose value changed are collected as set() goes, changes()
+ *  returns those that differ from the value it last reported, so work done
+ *  downstream is proportional to what changed.
+ */
+
+#ifndef __DeltaEvaluator_h_included__
+#define __DeltaEvaluator_h_included__
+
+#include "BitVector.h"
+#include "CompiledMatrix.h"
+#include "SymbolTable.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class DeltaEvaluator
+{
+    public:
+        // every identifier starts unknown, failing the AND sets it appears in as in CompiledMatrix::evaluate
+        DeltaEvaluator( const CompiledMatrix &compiled );
+        DeltaEvaluator( const CompiledMatrix &compiled, const CompiledMatrix::Assignment &assignment );
+
+        // identifiers the CompiledMatrix does not know are ignored
+        void set( const SymbolTable::id_type identifier, const bool value );
+        void set( const std::string &identifier, const bool value );
+        void unset( const SymbolTable::id_type identifier );
+        void unset( const std::string &identifier );
+
+        bool value( const size_t statement ) const;
+        const CompiledMatrix::ResultBitset &result() const;
+
+        // statements whose value differs from when changes() was last called, or since construction, in increasing order
+        std::vector< size_t > changes();
+
+        size_t statement_count() const;
+
+    private:
+        std::shared_ptr< SymbolTable > symbols;
+
+        // the truth value of each identifier, -1 while unknown
+        std::vector< int8_t > values;
+
+        // the inverted index of the CompiledMatrix, AND sets holding literal l, stored as id * 2 + negated, are
+        // literal_terms[ literal_offsets[ l ] .. literal_offsets[ l + 1 ] ) and statements holding AND set t are
+        // term_statements[ term_offsets[ t ] .. term_offsets[ t + 1 ] )
+        std::vector< uint32_t > literal_offsets, literal_terms, term_offsets, term_statements;
+
+        std::vector< uint32_t > unsatisfied, satisfied_terms;
+        CompiledMatrix::ResultBitset current, reported, pending;
+        std::vector< uint32_t > touched;
+
+        void update_literal( const uint32_t literal, const bool holds );
+};
+
+#endif
@@ -0,0 +1,483 @@
+// FrozenMatrix.cpp
+
+/** Implementation file for the FrozenMatrix class.
+ */
+
+#include "FrozenMatrix.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+// An image is a 64 byte header of
+//     "LGMF", uint32 0x01020304 in the byte order of the writer, uint32 version, uint32 zero, uint64 size of the image in bytes
+//     uint64 identifiers, uint64 bytes of names, uint64 AND sets, uint64 statements, uint64 statement memberships
+// then each section below starting at the next multiple of 64 bytes, the image ending with the last of them
+//     uint32 name_offsets[ identifiers + 1 ], the names in increasing order
+//     masks as uint64[ AND sets * 2 * mask_words ], uint32 first_word[ AND sets ], uint32 last_word[ AND sets ]
+//     uint32 statement_offsets[ statements + 1 ], uint32 statement_terms[ memberships ]
+static const char frozen_magic[] = "LGMF";
+static const uint32_t frozen_order = 0x01020304;
+static const uint32_t frozen_version = 1;
+static const size_t frozen_header_size = 64;
+static const size_t frozen_alignment = 64;
+
+class FrozenLayout
+{
+    public:
+        size_t name_offsets, names, masks, first_word, last_word, statement_offsets, statement_terms, size;
+
+        FrozenLayout( const size_t identifiers, const size_t name_bytes, const size_t terms, const size_t statements, const size_t memberships )
+        {
+            size_t mask_words = ( identifiers + BitVector::word_bits - 1 ) / BitVector::word_bits;
+
+            size = frozen_header_size;
+            name_offsets = section( ( identifiers + 1 ) * sizeof( uint32_t ) );
+            names = section( name_bytes );
+            masks = section( terms * 2 * mask_words * sizeof( BitVector::word_type ) );
+            first_word = section( terms * sizeof( uint32_t ) );
+            last_word = section( terms * sizeof( uint32_t ) );
+            statement_offsets = section( ( statements + 1 ) * sizeof( uint32_t ) );
+            statement_terms = section( memberships * sizeof( uint32_t ) );
+            size = ( size + frozen_alignment - 1 ) / frozen_alignment * frozen_alignment;
+        }
+
+    private:
+        size_t section( const size_t bytes )
+        {
+            size_t begin = ( size + frozen_alignment - 1 ) / frozen_alignment * frozen_alignment;
+
+            size = begin + bytes;
+            return begin;
+        }
+};
+
+template< typename Value >
+static Value frozen_get( const char *image, const size_t position )
+{
+    Value value;
+
+    std::memcpy( &value, image + position, sizeof( Value ) );
+    return value;
+}
+
+template< typename Value >
+static void frozen_put( char *image, const size_t position, const Value value )
+{
+    std::memcpy( image + position, &value, sizeof( Value ) );
+}
+
+FrozenMatrix::FrozenMatrix() : FrozenMatrix( LogicalMatrix() )
+{
+}
+
+// The image is built in a buffer of words, so its sections are aligned for reading in place
+FrozenMatrix::FrozenMatrix( const LogicalMatrix &matrix )
+{
+    LogicalMatrix listed;
+    const LogicalMatrix *sparse = &matrix;
+    std::vector< SymbolTable::id_type > symbol_identifiers;
+    std::vector< uint32_t > order, local;
+    size_t index, name_bytes = 0, size = 0;
+
+    if( !matrix.empty() )
+    {
+        if( matrix.form() == LogicalMatrix::CNF || matrix.storage() != LogicalMatrix::Sparse )
+        {
+            listed = ( matrix.form() == LogicalMatrix::CNF )? matrix.to_DNF() : matrix;
+            listed.make_sparse();
+            sparse = &listed;
+        }
+
+        symbol_identifiers = sparse->sparse_identifiers();
+        size = sparse->term_count();
+    }
+
+    // identifiers are numbered by name, local maps the place of an identifier in symbol_identifiers to its number
+    order.resize( symbol_identifiers.size() );
+    local.resize( symbol_identifiers.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    std::sort( order.begin(), order.end(), [ & ]( const uint32_t left, const uint32_t right )
+    {
+        return sparse->symbols->name( symbol_identifiers[ left ] ) < sparse->symbols->name( symbol_identifiers[ right ] );
+    } );
+
+    for( index = 0; index < order.size(); ++index )
+    {
+        local[ order[ index ] ] = index;
+        name_bytes += sparse->symbols->name( symbol_identifiers[ index ] ).size();
+    }
+
+    size_t statement_total = matrix.empty()? 0 : sparse->statement_count(),
+        memberships = matrix.empty()? 0 : sparse->statement_terms.size();
+    FrozenLayout layout( symbol_identifiers.size(), name_bytes, size, statement_total, memberships );
+    std::shared_ptr< std::vector< BitVector::word_type > > buffer =
+        std::make_shared< std::vector< BitVector::word_type > >( layout.size / sizeof( BitVector::word_type ), 0 );
+    char *image = reinterpret_cast< char * >( buffer->data() );
+    size_t words = ( symbol_identifiers.size() + BitVector::word_bits - 1 ) / BitVector::word_bits;
+
+    std::memcpy( image, frozen_magic, 4 );
+    frozen_put( image, 4, frozen_order );
+    frozen_put( image, 8, frozen_version );
+    frozen_put( image, 16, ( uint64_t ) layout.size );
+    frozen_put( image, 24, ( uint64_t ) symbol_identifiers.size() );
+    frozen_put( image, 32, ( uint64_t ) name_bytes );
+    frozen_put( image, 40, ( uint64_t ) size );
+    frozen_put( image, 48, ( uint64_t ) statement_total );
+    frozen_put( image, 56, ( uint64_t ) memberships );
+
+    uint32_t *offsets = reinterpret_cast< uint32_t * >( image + layout.name_offsets );
+    char *name_bytes_out = image + layout.names;
+
+    offsets[ 0 ] = 0;
+
+    for( index = 0; index < order.size(); ++index )
+    {
+        const std::string &identifier_name = sparse->symbols->name( symbol_identifiers[ order[ index ] ] );
+
+        std::memcpy( name_bytes_out + offsets[ index ], identifier_name.data(), identifier_name.size() );
+        offsets[ index + 1 ] = offsets[ index ] + identifier_name.size();
+    }
+
+    BitVector::word_type *mask_out = reinterpret_cast< BitVector::word_type * >( image + layout.masks );
+    uint32_t *first_out = reinterpret_cast< uint32_t * >( image + layout.first_word ),
+        *last_out = reinterpret_cast< uint32_t * >( image + layout.last_word );
+
+    for( index = 0; index < size; ++index )
+    {
+        first_out[ index ] = words;
+        last_out[ index ] = 0;
+
+        for( size_t position = sparse->term_offsets[ index ]; position < sparse->term_offsets[ index + 1 ]; ++position )
+        {
+            uint32_t literal = sparse->term_literals[ position ],
+                identifier = local[ std::lower_bound( symbol_identifiers.begin(), symbol_identifiers.end(), literal / 2 ) - symbol_identifiers.begin() ];
+            size_t word = identifier / BitVector::word_bits;
+
+            mask_out[ ( 2 * index + ( literal & 1 ) ) * words + word ] |= ( BitVector::word_type ) 1 << ( identifier % BitVector::word_bits );
+            first_out[ index ] = std::min< uint32_t >( first_out[ index ], word );
+            last_out[ index ] = std::max< uint32_t >( last_out[ index ], word + 1 );
+        }
+    }
+
+    if( statement_total > 0 )
+    {
+        std::memcpy( image + layout.statement_offsets, sparse->statement_offsets.data(), ( statement_total + 1 ) * sizeof( uint32_t ) );
+
+        if( memberships > 0 )
+        {
+            std::memcpy( image + layout.statement_terms, sparse->statement_terms.data(), memberships * sizeof( uint32_t ) );
+        }
+    }
+    else
+    {
+        frozen_put( image, layout.statement_offsets, ( uint32_t ) 0 );
+    }
+
+    attach( std::string_view( image, layout.size ) );
+    owner = buffer;
+}
+
+FrozenMatrix::FrozenMatrix( const std::string_view &image, const std::shared_ptr< const void > &owner ) : owner( owner )
+{
+    attach( image );
+}
+
+FrozenMatrix FrozenMatrix::view( const std::string_view &image )
+{
+    return FrozenMatrix( image, nullptr );
+}
+
+// throws Logicalfileexception when path cannot be mapped and Logicalformatexception when it holds no image
+FrozenMatrix FrozenMatrix::open( const std::string &path )
+{
+    std::shared_ptr< MappedFile > file = std::make_shared< MappedFile >();
+
+    // evaluation reads the same pages again and again, so they are not advised as read once
+    if( !file->open( path, MappedFile::Random ) )
+    {
+        throw LogicalMatrix::Logicalfileexception();
+    }
+
+    return FrozenMatrix( file->view(), file );
+}
+
+// Checks the header and every offset the evaluation follows, so a damaged image throws Logicalformatexception here
+// rather than being read out of bounds. The masks themselves are not read, bits past the identifiers only fail their AND sets
+void FrozenMatrix::attach( const std::string_view &image )
+{
+    const char *bytes = image.data();
+    size_t size = image.size();
+
+    if( size < frozen_header_size || reinterpret_cast< uintptr_t >( bytes ) % alignof( BitVector::word_type ) != 0 ||
+        std::memcmp( bytes, frozen_magic, 4 ) != 0 || frozen_get< uint32_t >( bytes, 4 ) != frozen_order ||
+        frozen_get< uint32_t >( bytes, 8 ) != frozen_version || frozen_get< uint64_t >( bytes, 16 ) != size )
+    {
+        throw LogicalMatrix::Logicalformatexception();
+    }
+
+    uint64_t identifier_total = frozen_get< uint64_t >( bytes, 24 ), name_bytes = frozen_get< uint64_t >( bytes, 32 ),
+        term_total = frozen_get< uint64_t >( bytes, 40 ), statement_total = frozen_get< uint64_t >( bytes, 48 ),
+        memberships = frozen_get< uint64_t >( bytes, 56 ), words = ( identifier_total + BitVector::word_bits - 1 ) / BitVector::word_bits;
+
+    // every count is bounded by the image before the layout multiplies them
+    if( identifier_total > size / sizeof( uint32_t ) || name_bytes > size || term_total > size / ( 2 * sizeof( uint32_t ) ) ||
+        statement_total > size / sizeof( uint32_t ) || memberships > size / sizeof( uint32_t ) ||
+        ( words > 0 && term_total > size / ( 2 * sizeof( BitVector::word_type ) * words ) ) )
+    {
+        throw LogicalMatrix::Logicalformatexception();
+    }
+
+    FrozenLayout layout( identifier_total, name_bytes, term_total, statement_total, memberships );
+
+    if( layout.size != size )
+    {
+        throw LogicalMatrix::Logicalformatexception();
+    }
+
+    identifiers = identifier_total;
+    mask_words = words;
+    terms = term_total;
+    statements = statement_total;
+    name_offsets = reinterpret_cast< const uint32_t * >( bytes + layout.name_offsets );
+    names = bytes + layout.names;
+    masks = reinterpret_cast< const BitVector::word_type * >( bytes + layout.masks );
+    first_word = reinterpret_cast< const uint32_t * >( bytes + layout.first_word );
+    last_word = reinterpret_cast< const uint32_t * >( bytes + layout.last_word );
+    statement_offsets = reinterpret_cast< const uint32_t * >( bytes + layout.statement_offsets );
+    statement_terms = reinterpret_cast< const uint32_t * >( bytes + layout.statement_terms );
+    data = image;
+
+    // offsets never decreasing from 0 to the end of their list, so every range lies within it
+    if( name_offsets[ 0 ] != 0 || name_offsets[ identifiers ] != name_bytes || !std::is_sorted( name_offsets, name_offsets + identifiers + 1 ) ||
+        statement_offsets[ 0 ] != 0 || statement_offsets[ statements ] != memberships || !std::is_sorted( statement_offsets, statement_offsets + statements + 1 ) )
+    {
+        throw LogicalMatrix::Logicalformatexception();
+    }
+
+    size_t index;
+
+    // names strictly increasing, so find() can search them
+    for( index = 1; index < identifiers; ++index )
+    {
+        if( name( index - 1 ) >= name( index ) )
+        {
+            throw LogicalMatrix::Logicalformatexception();
+        }
+    }
+
+    for( index = 0; index < terms; ++index )
+    {
+        if( last_word[ index ] > mask_words )
+        {
+            throw LogicalMatrix::Logicalformatexception();
+        }
+    }
+
+    // the AND sets of each statement strictly increasing, as LogicalMatrix keeps them
+    for( index = 0; index < statements; ++index )
+    {
+        for( size_t position = statement_offsets[ index ]; position < statement_offsets[ index + 1 ]; ++position )
+        {
+            if( statement_terms[ position ] >= terms || ( position > statement_offsets[ index ] && statement_terms[ position ] <= statement_terms[ position - 1 ] ) )
+            {
+                throw LogicalMatrix::Logicalformatexception();
+            }
+        }
+    }
+}
+
+std::string_view FrozenMatrix::image() const
+{
+    return data;
+}
+
+void FrozenMatrix::write( std::ostream &output ) const
+{
+    output.write( data.data(), data.size() );
+}
+
+FrozenMatrix::Assignment FrozenMatrix::make_assignment() const
+{
+    return Assignment( identifiers );
+}
+
+// identifiers not in this are ignored
+FrozenMatrix::Assignment FrozenMatrix::make_assignment( const std::map< std::string, bool > &identifier_values ) const
+{
+    Assignment assignment( identifiers );
+    SymbolTable::id_type identifier;
+
+    for( auto const& [ key, value ] : identifier_values )
+    {
+        if( ( identifier = find( key ) ) != SymbolTable::npos )
+        {
+            assignment.set( identifier, value );
+        }
+    }
+
+    return assignment;
+}
+
+FrozenMatrix::ResultBitset FrozenMatrix::make_result() const
+{
+    return ResultBitset( statements );
+}
+
+bool FrozenMatrix::satisfied( const size_t term, const BitVector::word_type *True, const BitVector::word_type *False ) const
+{
+    const BitVector::word_type *positive_mask = masks + 2 * term * mask_words,
+        *negative_mask = positive_mask + mask_words;
+
+    for( size_t word = first_word[ term ]; word < last_word[ term ]; ++word )
+    {
+        if( ( positive_mask[ word ] & ~True[ word ] ) | ( negative_mask[ word ] & ~False[ word ] ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FrozenMatrix::evaluate( const Assignment &assignment, ResultBitset &result ) const
+{
+    size_t statement, index;
+    const BitVector::word_type *True = assignment.True.data(), *False = assignment.False.data();
+
+    result.reset();
+
+    for( statement = 0; statement < statements; ++statement )
+    {
+        for( index = statement_offsets[ statement ]; index < statement_offsets[ statement + 1 ]; ++index )
+        {
+            if( satisfied( statement_terms[ index ], True, False ) )
+            {
+                result.set( statement );
+                break;
+            }
+        }
+    }
+}
+
+std::vector< bool > FrozenMatrix::evaluate( const std::map< std::string, bool > &identifier_values ) const
+{
+    ResultBitset result = make_result();
+    std::vector< bool > result_vector( statements );
+
+    evaluate( make_assignment( identifier_values ), result );
+
+    for( size_t index = 0; index < result_vector.size(); ++index )
+    {
+        result_vector[ index ] = result[ index ];
+    }
+
+    return result_vector;
+}
+
+size_t FrozenMatrix::identifier_count() const
+{
+    return identifiers;
+}
+
+size_t FrozenMatrix::statement_count() const
+{
+    return statements;
+}
+
+size_t FrozenMatrix::term_count() const
+{
+    return terms;
+}
+
+SymbolTable::id_type FrozenMatrix::find( const std::string_view &identifier_name ) const
+{
+    size_t low = 0, high = identifiers;
+
+    while( low < high )
+    {
+        size_t middle = low + ( high - low ) / 2;
+
+        if( name( middle ) < identifier_name )
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return ( low < identifiers && name( low ) == identifier_name )? low : SymbolTable::npos;
+}
+
+std::string_view FrozenMatrix::name( const SymbolTable::id_type identifier ) const
+{
+    return std::string_view( names + name_offsets[ identifier ], name_offsets[ identifier + 1 ] - name_offsets[ identifier ] );
+}
+
+// the statements of this in sparse storage, or as Adaptive storage chooses, throws Logicalformatexception on a mask bit past the identifiers
+LogicalMatrix FrozenMatrix::to_matrix( std::shared_ptr< SymbolTable > symbol_table ) const
+{
+    LogicalMatrix result;
+    std::vector< SymbolTable::id_type > symbol_identifiers;
+    size_t index;
+
+    result.symbols = symbol_table? symbol_table : std::make_shared< SymbolTable >();
+
+    if( statements == 0 )
+    {
+        return result;
+    }
+
+    for( index = 0; index < identifiers; ++index )
+    {
+        symbol_identifiers.push_back( result.symbols->intern( std::string( name( index ) ) ) );
+    }
+
+    result.term_offsets.assign( 1, 0 );
+    result.term_literals.clear();
+
+    for( index = 0; index < terms; ++index )
+    {
+        const BitVector::word_type *positive_mask = masks + 2 * index * mask_words;
+        size_t begin = result.term_literals.size();
+
+        for( size_t word = first_word[ index ]; word < last_word[ index ]; ++word )
+        {
+            BitVector::word_type positive_word = positive_mask[ word ], negative_word = positive_mask[ mask_words + word ],
+                remaining = positive_word | negative_word;
+
+            for( ; remaining != 0; remaining &= remaining - 1 )
+            {
+                size_t bit = __builtin_ctzll( remaining ), identifier = word * BitVector::word_bits + bit;
+
+                if( identifier >= identifiers )
+                {
+                    throw LogicalMatrix::Logicalformatexception();
+                }
+
+                if( ( positive_word >> bit ) & 1 )
+                {
+                    result.term_literals.push_back( symbol_identifiers[ identifier ] * 2 );
+                }
+
+                if( ( negative_word >> bit ) & 1 )
+                {
+                    result.term_literals.push_back( symbol_identifiers[ identifier ] * 2 + 1 );
+                }
+            }
+        }
+
+        // a SymbolTable numbers the identifiers in its own order
+        std::sort( result.term_literals.write().begin() + begin, result.term_literals.write().end() );
+        result.term_offsets.push_back( result.term_literals.size() );
+    }
+
+    result.statement_offsets.assign( statement_offsets, statement_offsets + statements + 1 );
+    result.statement_terms.assign( statement_terms, statement_terms + statement_offsets[ statements ] );
+    result.current_storage = LogicalMatrix::Sparse;
+    result.choose_storage();
+
+    return result;
+}
@@ -0,0 +1,93 @@
+// FrozenMatrix.h
+
+/** Header file for the FrozenMatrix class.
+ *
+ *  A FrozenMatrix is a read only image of a LogicalMatrix that is evaluated
+ *  where it lies. The image is one block of flat arrays at 64 byte aligned
+ *  offsets from its start: the identifier names in order, the positive and
+ *  negative literal masks of each AND set, and the AND sets of each statement.
+ *  It holds no pointers, so a file written from it can be memory mapped by
+ *  any number of processes, which then share its pages and evaluate it
+ *  without parsing or allocating a copy of it.
+ *
+ *  Identifiers are numbered by their place in the sorted names of the image
+ *  rather than by a SymbolTable. Images are read by hosts of the byte order
+ *  that wrote them.
+ */
+
+#ifndef __FrozenMatrix_h_included__
+#define __FrozenMatrix_h_included__
+
+#include "BitVector.h"
+#include "CompiledMatrix.h"
+#include "LogicalMatrix.h"
+#include "SymbolTable.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class FrozenMatrix
+{
+    public:
+        typedef CompiledMatrix::Assignment Assignment;
+        typedef BitVector ResultBitset;
+
+        FrozenMatrix();
+        FrozenMatrix( const LogicalMatrix &matrix );
+
+        // refers to image where it lies, which must outlive the result and every copy of it
+        static FrozenMatrix view( const std::string_view &image );
+
+        // maps the image written to path, shared by every copy of the result
+        static FrozenMatrix open( const std::string &path );
+
+        std::string_view image() const;
+        void write( std::ostream &output ) const;
+
+        Assignment make_assignment() const;
+        Assignment make_assignment( const std::map< std::string, bool > &identifiers ) const;
+        ResultBitset make_result() const;
+
+        // assignment must come from make_assignment and result from make_result, nothing is allocated
+        void evaluate( const Assignment &assignment, ResultBitset &result ) const;
+        std::vector< bool > evaluate( const std::map< std::string, bool > &identifiers ) const;
+
+        size_t identifier_count() const;
+        size_t statement_count() const;
+        size_t term_count() const;
+
+        // the number of identifier_name in this, or SymbolTable::npos
+        SymbolTable::id_type find( const std::string_view &identifier_name ) const;
+        std::string_view name( const SymbolTable::id_type identifier ) const;
+
+        LogicalMatrix to_matrix( std::shared_ptr< SymbolTable > symbol_table = nullptr ) const;
+
+    private:
+        // keeps the image alive, a buffer built by freezing or a mapped file, empty when the image is only referred to
+        std::shared_ptr< const void > owner;
+        std::string_view data;
+
+        size_t identifiers, mask_words, terms, statements;
+
+        // identifier i is named names[ name_offsets[ i ] .. name_offsets[ i + 1 ] )
+        const uint32_t *name_offsets;
+        const char *names;
+
+        // the positive mask of AND set t is words [ 2 * t * mask_words, ( 2 * t + 1 ) * mask_words ) of masks,
+        // its negative mask the mask_words after it, and only words [ first_word[ t ], last_word[ t ] ) of them can be non zero
+        const BitVector::word_type *masks;
+        const uint32_t *first_word, *last_word;
+
+        // AND sets of statement s are statement_terms[ statement_offsets[ s ] .. statement_offsets[ s + 1 ] )
+        const uint32_t *statement_offsets, *statement_terms;
+
+        FrozenMatrix( const std::string_view &image, const std::shared_ptr< const void > &owner );
+
+        void attach( const std::string_view &image );
+        bool satisfied( const size_t term, const BitVector::word_type *True, const BitVector::word_type *False ) const;
+};
+
+#endif
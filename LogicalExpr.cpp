@@ -0,0 +1,199 @@
+// LogicalExpr.cpp
+
+/** Implementation file for the LogicalExpr class.
+ */
+
+#include "LogicalExpr.h"
+#include <algorithm>
+
+LogicalExpr::Node::Node( const Operation operation, std::shared_ptr< const LogicalMatrix > matrix ) : operation( operation ), matrix( matrix )
+{
+}
+
+LogicalExpr::LogicalExpr( const LogicalMatrix &matrix ) : root( std::make_shared< Node >( Leaf, std::make_shared< LogicalMatrix >( matrix ) ) )
+{
+}
+
+LogicalExpr::LogicalExpr( LogicalMatrix &&matrix ) : root( std::make_shared< Node >( Leaf, std::make_shared< LogicalMatrix >( std::move( matrix ) ) ) )
+{
+}
+
+LogicalExpr::LogicalExpr( const Operation operation, const LogicalExpr &left, const LogicalExpr &right )
+{
+    std::shared_ptr< Node > node = std::make_shared< Node >( operation );
+
+    node->operands = { left.root, right.root };
+    root = node;
+}
+
+LogicalExpr LogicalExpr::operator !() const
+{
+    LogicalExpr result( *this );
+
+    if( root->operation == NOT )
+    { // !!A = A
+        result.root = root->operands[ 0 ];
+        return result;
+    }
+
+    std::shared_ptr< Node > node = std::make_shared< Node >( NOT );
+
+    node->operands.push_back( root );
+    result.root = node;
+    return result;
+}
+
+LogicalExpr operator &( const LogicalExpr &left, const LogicalExpr &right )
+{
+    return LogicalExpr( LogicalExpr::AND, left, right );
+}
+
+LogicalExpr operator |( const LogicalExpr &left, const LogicalExpr &right )
+{
+    return LogicalExpr( LogicalExpr::OR, left, right );
+}
+
+LogicalExpr operator +( const LogicalExpr &left, const LogicalExpr &right )
+{
+    return LogicalExpr( LogicalExpr::ADD, left, right );
+}
+
+LogicalExpr &LogicalExpr::operator &=( const LogicalExpr &other )
+{
+    return *this = *this & other;
+}
+
+LogicalExpr &LogicalExpr::operator |=( const LogicalExpr &other )
+{
+    return *this = *this | other;
+}
+
+LogicalExpr &LogicalExpr::operator +=( const LogicalExpr &other )
+{
+    return *this = *this + other;
+}
+
+LogicalMatrix LogicalExpr::materialize() const
+{
+    Materialized done;
+
+    return build( *root, false, done );
+}
+
+// node built as an operand, operands referred to by more than one expression are kept in done for their next use
+std::shared_ptr< const LogicalMatrix > LogicalExpr::build_operand( const Node &node, const bool negated, const bool shared, Materialized &done )
+{
+    if( node.operation == Leaf && !negated )
+    {
+        return node.matrix;
+    }
+
+    auto found = done.find( { &node, negated } );
+
+    if( found != done.end() )
+    {
+        return found->second;
+    }
+
+    std::shared_ptr< const LogicalMatrix > result = std::make_shared< LogicalMatrix >( build( node, negated, done ) );
+
+    if( shared )
+    {
+        done[ { &node, negated } ] = result;
+    }
+
+    return result;
+}
+
+// The operands of a chain of one operator are gathered through nested nodes of the same operator and through !,
+// as !( A & B ) = !A | !B, !( A | B ) = !A & !B and !( A + B ) = !A + !B
+// Operands of & and | with at most one statement are joined first, smallest first, operands of more statements keep
+// their order as it numbers the statements. Statements gathered without multiplying are trimmed once at the end
+LogicalMatrix LogicalExpr::build( const Node &node, const bool negated, Materialized &done )
+{
+    if( node.operation == Leaf )
+    {
+        return negated? !*node.matrix : *node.matrix;
+    }
+
+    if( node.operation == NOT )
+    {
+        return build( *node.operands[ 0 ], !negated, done );
+    }
+
+    struct Pending
+    {
+        const Node *node;
+        bool negated, shared;
+    };
+
+    const Operation operation = ( !negated || node.operation == ADD )? node.operation : ( node.operation == AND )? OR : AND;
+    std::vector< Pending > pending( 1, { &node, negated, false } );
+    std::vector< std::shared_ptr< const LogicalMatrix > > operands;
+
+    while( !pending.empty() )
+    { // depth first, left to right
+        Pending next = pending.back();
+        Operation next_operation = next.node->operation;
+
+        pending.pop_back();
+
+        if( next.negated && ( next_operation == AND || next_operation == OR ) )
+        {
+            next_operation = ( next_operation == AND )? OR : AND;
+        }
+
+        if( next_operation == NOT )
+        {
+            pending.push_back( { next.node->operands[ 0 ].get(), !next.negated, next.shared || next.node->operands[ 0 ].use_count() > 1 } );
+        }
+        else if( next_operation == operation )
+        {
+            for( auto operand = next.node->operands.rbegin(); operand != next.node->operands.rend(); ++operand )
+            {
+                pending.push_back( { operand->get(), next.negated, operand->use_count() > 1 } );
+            }
+        }
+        else
+        {
+            operands.push_back( build_operand( *next.node, next.negated, next.shared, done ) );
+        }
+    }
+
+    if( operation != ADD )
+    {
+        auto single = std::stable_partition( operands.begin(), operands.end(), []( const std::shared_ptr< const LogicalMatrix > &operand )
+        {
+            return operand->statement_count() <= 1;
+        } );
+
+        std::stable_sort( operands.begin(), single, []( const std::shared_ptr< const LogicalMatrix > &left, const std::shared_ptr< const LogicalMatrix > &right )
+        {
+            return left->term_count() < right->term_count();
+        } );
+    }
+
+    LogicalMatrix result( *operands[ 0 ] );
+    bool untrimmed = false;
+
+    for( size_t index = 1; index < operands.size(); ++index )
+    {
+        if( operation == ADD )
+        {
+            result += *operands[ index ];
+            continue;
+        }
+
+        // multiplied statements are trimmed as they are built, gathered ones wait for the end
+        result.combine( *operands[ index ], operation == AND, false );
+        untrimmed |= ( result.form() == LogicalMatrix::DNF ) != ( operation == AND );
+    }
+
+    if( untrimmed )
+    {
+        result.trim();
+        result.choose_storage();
+    }
+
+    return result;
+}
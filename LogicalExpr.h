@@ -0,0 +1,67 @@
+// LogicalExpr.h
+
+/** Header file for the LogicalExpr class.
+ *
+ *  A LogicalExpr records &, |, ! and + over LogicalMatrix operands without
+ *  evaluating them, and materialize() builds the LogicalMatrix they describe.
+ *  Chains of one operator are joined as a whole: the operands of & and | are
+ *  joined smallest first, gathered AND sets or OR sets are trimmed once at the
+ *  end of the chain, and ! is moved down to the operands by De Morgan's laws
+ *  so only operand matrices are ever negated.
+ *
+ *  Statements are numbered as the LogicalMatrix operators number them, so an
+ *  operand of more than one statement keeps its place among the others.
+ *  Operands are shared, an expression reused in several places is
+ *  materialized once per materialize() call.
+ */
+
+#ifndef __LogicalExpr_h_included__
+#define __LogicalExpr_h_included__
+
+#include "LogicalMatrix.h"
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class LogicalExpr
+{
+    private:
+        enum Operation { Leaf, AND, OR, ADD, NOT };
+
+        class Node
+        {
+            public:
+                Operation operation;
+                std::shared_ptr< const LogicalMatrix > matrix;
+                std::vector< std::shared_ptr< const Node > > operands;
+
+                Node( const Operation operation, std::shared_ptr< const LogicalMatrix > matrix = nullptr );
+        };
+
+        // the operands already built by one materialize(), and whether each was negated
+        typedef std::map< std::pair< const Node *, bool >, std::shared_ptr< const LogicalMatrix > > Materialized;
+
+        std::shared_ptr< const Node > root;
+
+        LogicalExpr( const Operation operation, const LogicalExpr &left, const LogicalExpr &right );
+        static LogicalMatrix build( const Node &node, const bool negated, Materialized &done );
+        static std::shared_ptr< const LogicalMatrix > build_operand( const Node &node, const bool negated, const bool shared, Materialized &done );
+
+    public:
+        LogicalExpr( const LogicalMatrix &matrix );
+        LogicalExpr( LogicalMatrix &&matrix );
+
+        LogicalExpr operator !() const;
+        friend LogicalExpr operator &( const LogicalExpr &left, const LogicalExpr &right );
+        friend LogicalExpr operator |( const LogicalExpr &left, const LogicalExpr &right );
+        friend LogicalExpr operator +( const LogicalExpr &left, const LogicalExpr &right );
+        LogicalExpr &operator &=( const LogicalExpr &other );
+        LogicalExpr &operator |=( const LogicalExpr &other );
+        LogicalExpr &operator +=( const LogicalExpr &other );
+
+        // the statements the LogicalMatrix operators would build, though they may be ordered or kept in another form
+        LogicalMatrix materialize() const;
+};
+
+#endif
@@ -5,11 +5,31 @@
  *  This implementation does not handle tautologies nor contradictions such as
  *      A | !A = TRUE
  *      A & !A = FALSE
+ *  unless minimize() is called or automatic minimization is enabled
  */
 
  #include "LogicalMatrix.h"
+ #include "CompiledMatrix.h"
+ #include "FrozenMatrix.h"
+ #include "MappedFile.h"
+ #include "StatementView.h"
+ #include "ThreadPool.h"
  #include <algorithm>
+ #include <atomic>
+ #include <cctype>
+ #include <cstring>
+ #include <functional>
+ #include <numeric>
  #include <sstream>
+ #include <string_view>
+
+const size_t LogicalMatrix::default_conversion_limit;
+
+// Adaptive storage keeps matrices of fewer AND sets dense
+static const size_t sparse_term_minimum = 1024;
+
+// the parser expands a negated group right away when it takes no more AND sets than this
+static const size_t parsed_expansion_maximum = 1024;
 
 /**Order of operations
  * ( )
@@ -19,19 +39,14 @@
  */
 
 
-LogicalMatrix::TruthTable::TruthTable( const size_t depth )
+LogicalMatrix::TruthTable::TruthTable( const SymbolTable::id_type identifier, const size_t depth ) : identifier( identifier ), True( depth ), False( depth )
 {
-    True = std::vector< bool >( depth, false );
-    False = std::vector< bool >( depth, false );
 }
 
-LogicalMatrix::TruthTable::TruthTable( const size_t depth, const bool condition )
+LogicalMatrix::TruthTable::TruthTable( const SymbolTable::id_type identifier, const size_t depth, const bool condition ) : identifier( identifier ), True( depth ), False( depth )
 {
-    True = std::vector< bool >( depth, false );
-    False = std::vector< bool >( depth, false );
-
-    True[ depth - 1 ] = condition? true : false;
-    False[ depth - 1 ] = condition? false : true;
+    True.set( depth - 1, condition );
+    False.set( depth - 1, !condition );
 }
 
 bool LogicalMatrix::TruthTable::operator ==( const TruthTable &other ) const
@@ -51,7 +66,7 @@ bool LogicalMatrix::TruthTable::operator <( const TruthTable &other ) const
     }
 }
 
-// not used
+// swaps every literal for its complement
 LogicalMatrix::TruthTable LogicalMatrix::TruthTable::operator !() const
 {
     TruthTable result( *this );
@@ -60,90 +75,248 @@ LogicalMatrix::TruthTable LogicalMatrix::TruthTable::operator !() const
     return result;
 }
 
-// credit to https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
-// trim from start (in place)
-static inline void ltrim_string(std::string &s) {
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](int ch) {
-        return !std::isspace(ch);
-    }));
+// narrows piece to exclude leading and trailing whitespace and returns if it is still not empty
+static inline bool trim_view( std::string_view &piece )
+{
+    auto is_space = []( const char character ){ return std::isspace( ( unsigned char ) character ) != 0; };
+
+    while( !piece.empty() && is_space( piece.front() ) )
+    {
+        piece.remove_prefix( 1 );
+    }
+
+    while( !piece.empty() && is_space( piece.back() ) )
+    {
+        piece.remove_suffix( 1 );
+    }
+
+    return !piece.empty();
+}
+
+const std::string &LogicalMatrix::name( const TruthTable &table ) const
+{
+    return symbols->name( table.identifier );
 }
 
-// credit to https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
-// trim from end (in place)
-static inline void rtrim_string(std::string &s) {
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](int ch) {
-        return !std::isspace(ch);
-    }).base(), s.end());
+// positions within AND_matrix ordered by identifier name
+std::vector< size_t > LogicalMatrix::ordered_identifiers() const
+{
+    std::vector< size_t > order( AND_matrix.size() );
+
+    std::iota( order.begin(), order.end(), 0 );
+    std::sort( order.begin(), order.end(), [ this ]( const size_t &left, const size_t &right )
+    {
+        return name( AND_matrix[ left ] ) < name( AND_matrix[ right ] );
+    } );
+
+    return order;
 }
 
-// credit to https://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring
-// trim from both ends (in place) and returns if the string is still not empty
-static inline bool trim_string(std::string &s) {
-    ltrim_string(s);
-    rtrim_string(s);
-    return !s.empty();
+// returns other if it uses the same SymbolTable as this, otherwise a copy of other moved onto the SymbolTable of this
+const LogicalMatrix &LogicalMatrix::share_symbols( const LogicalMatrix &other, LogicalMatrix &rebound ) const
+{
+    if( other.symbols == symbols && &other != this )
+    {
+        return other;
+    }
+
+    rebound = other.rebind( symbols );
+    return rebound;
 }
 
-template< typename Type >
-static inline void extend_vector( std::vector< Type > &input_vector, const std::vector< Type > &additional_vector, const size_t newsize )
+// returns other if it has the same form as this, otherwise converts whichever of the two takes fewer sets in the other form
+// A CNF operand too large to expand, such as a negated rule group, thus stays in CNF when joined to a few DNF AND sets
+// Ties expand into DNF
+const LogicalMatrix &LogicalMatrix::share_form( const LogicalMatrix &other, LogicalMatrix &converted )
 {
-    size_t offset = input_vector.size() + additional_vector.size() - newsize;
-    input_vector.reserve( newsize );
+    if( other.matrix_form == matrix_form )
+    {
+        return other;
+    }
+
+    const LogicalMatrix &conjunctive = ( matrix_form == CNF )? *this : other, &disjunctive = ( matrix_form == CNF )? other : *this;
+
+    if( disjunctive.conversion_size( DNF_limit ) < conjunctive.conversion_size( DNF_limit ) )
+    {
+        if( matrix_form == DNF )
+        {
+            *this = to_CNF();
+            return other;
+        }
+
+        converted = other.to_CNF();
+        return converted;
+    }
 
-    std::copy( additional_vector.begin() + offset, additional_vector.end(), std::back_inserter( input_vector ) );
+    if( matrix_form == CNF )
+    {
+        *this = to_DNF();
+        return other;
+    }
+
+    converted = other.to_DNF();
+    return converted;
 }
 
-template< typename Type >
-static inline std::vector< Type > stretch_vector( const std::vector< Type > &input_vector, const size_t &newsize, const size_t &stretch_factor )
+// The most sets the other form of this can take, the product of the literal counts of the sets of each statement
+// summed over the statements, counted no further than limit + 1
+size_t LogicalMatrix::conversion_size( const size_t &limit ) const
 {
-    if( stretch_factor <= 1 )
+    std::vector< size_t > literal_counts( term_count(), 0 );
+    size_t term, total = 0;
+
+    if( current_storage == Dense )
+    {
+        for( TruthTable const& table : AND_matrix )
+        {
+            for( term = table.True.find_first(); term != BitVector::npos; term = table.True.find_next( term ) )
+            {
+                ++literal_counts[ term ];
+            }
+
+            for( term = table.False.find_first(); term != BitVector::npos; term = table.False.find_next( term ) )
+            {
+                ++literal_counts[ term ];
+            }
+        }
+    }
+    else
+    {
+        for( term = 0; term < literal_counts.size(); ++term )
+        {
+            literal_counts[ term ] = ( current_storage == Sparse )? term_offsets[ term + 1 ] - term_offsets[ term ] :
+                term_positive[ term ].count() + term_negative[ term ].count();
+        }
+    }
+
+    auto times = [ limit ]( const size_t product, const size_t count ) -> size_t
+    {
+        return ( count != 0 && product > limit / count )? limit + 1 : product * count;
+    };
+
+    for( size_t statement = 0; statement < statement_count() && total <= limit; ++statement )
     {
-        return input_vector;
+        size_t product = 1;
+
+        if( current_storage == Dense )
+        {
+            const BitVector &row = OR_matrix[ statement ];
+
+            for( term = row.find_first(); term != BitVector::npos; term = row.find_next( term ) )
+            {
+                product = times( product, literal_counts[ term ] );
+            }
+        }
+        else
+        {
+            for( size_t position = statement_offsets[ statement ]; position < statement_offsets[ statement + 1 ]; ++position )
+            {
+                product = times( product, literal_counts[ statement_terms[ position ] ] );
+            }
+        }
+
+        total = std::min( total + product, limit + 1 );
     }
 
-    size_t count, index = 0;
-    std::vector< Type > result_vector = std::vector< Type >( newsize );
+    return total;
+}
+
+// takes the statements of other while keeping the settings of this
+void LogicalMatrix::adopt( const LogicalMatrix &other )
+{
+    AND_matrix = other.AND_matrix;
+    OR_matrix = other.OR_matrix;
+    term_offsets = other.term_offsets;
+    term_literals = other.term_literals;
+    statement_offsets = other.statement_offsets;
+    statement_terms = other.statement_terms;
+    term_positive = other.term_positive;
+    term_negative = other.term_negative;
+    current_storage = other.current_storage;
+    symbols = other.symbols;
+    matrix_form = other.matrix_form;
+}
+
+// adds a TruthTable for each identifier of other not already in this, with depth AND sets
+// returns the position within AND_matrix of each TruthTable of other
+std::vector< size_t > LogicalMatrix::merge_identifiers( const LogicalMatrix &other, const size_t depth )
+{
+    size_t index = 0;
+    std::vector< TruthTable > &tables = AND_matrix.write(), merged;
+    std::vector< size_t > positions;
+
+    merged.reserve( tables.size() + other.AND_matrix.size() );
+    positions.reserve( other.AND_matrix.size() );
 
-    for( Type const& value : input_vector )
+    for( TruthTable const& table : other.AND_matrix )
     {
-        for( count = 0; count < stretch_factor; ++count )
+        while( index < tables.size() && tables[ index ].identifier < table.identifier )
+        {
+            merged.push_back( std::move( tables[ index++ ] ) );
+        }
+
+        if( index < tables.size() && tables[ index ].identifier == table.identifier )
+        {
+            merged.push_back( std::move( tables[ index++ ] ) );
+        }
+        else
         {
-            result_vector[ index++ ] = value;
+            merged.emplace_back( table.identifier, depth );
         }
+
+        positions.push_back( merged.size() - 1 );
     }
 
-    return result_vector;
+    std::move( tables.begin() + index, tables.end(), std::back_inserter( merged ) );
+    tables.swap( merged );
+
+    return positions;
 }
 
-LogicalMatrix LogicalMatrix::build_inverse( const size_t &index ) const
+// the OR set at index of a CNF matrix as a DNF matrix of one literal per AND set, literals ordered by identifier name
+LogicalMatrix LogicalMatrix::build_clause( const size_t &index, const std::vector< size_t > &order ) const
 {
     size_t depth = 0;
     LogicalMatrix temp_matrix;
 
-    auto build_operator = [ &depth, &temp_matrix ]( const bool &value, const std::string &key, const bool &conditional )
+    auto build_operator = [ &depth, &temp_matrix ]( const bool &value, const SymbolTable::id_type &identifier, const bool &conditional )
     {
         if( value )
         {
-            depth += 1;
-            temp_matrix.AND_matrix[ key ] = TruthTable( depth, conditional );
+            if( temp_matrix.AND_matrix.empty() || temp_matrix.AND_matrix.back().identifier != identifier )
+            {
+                temp_matrix.AND_matrix.emplace_back( identifier, 0 );
+            }
+
+            TruthTable &table = temp_matrix.AND_matrix.write().back();
+
+            table.True.resize( ++depth );
+            table.False.resize( depth );
+            ( conditional? table.True : table.False ).set( depth - 1 );
         }
     };
 
-    for( auto const& [ key, data ] : AND_matrix )
+    temp_matrix.symbols = symbols;
+
+    for( size_t const& position : order )
     {
-        build_operator( data.True[ index ], key, false );
-        build_operator( data.False[ index ], key, true );
+        build_operator( AND_matrix[ position ].False[ index ], AND_matrix[ position ].identifier, false );
+        build_operator( AND_matrix[ position ].True[ index ], AND_matrix[ position ].identifier, true );
     }
 
-    std::vector< bool > temp_vector = std::vector< bool >( depth, false );
-    temp_matrix.OR_matrix.push_back( std::vector< bool >( depth, true ) );
+    temp_matrix.OR_matrix.push_back( BitVector( depth, true ) );
 
-    for( auto& [ key, data ] : temp_matrix.AND_matrix )
+    for( TruthTable& table : temp_matrix.AND_matrix.write() )
     {
-        extend_vector( data.True, temp_vector, depth );
-        extend_vector( data.False, temp_vector, depth );
+        table.True.resize( depth );
+        table.False.resize( depth );
     }
 
+    std::sort( temp_matrix.AND_matrix.write().begin(), temp_matrix.AND_matrix.write().end(), []( const TruthTable &left, const TruthTable &right )
+    {
+        return left.identifier < right.identifier;
+    } );
+
     return temp_matrix;
 }
 
@@ -160,795 +333,4081 @@ void LogicalMatrix::extend_matrix( const LogicalMatrix &other )
         return;
     }
 
-    size_t old_size = OR_matrix[ 0 ].size(),
+    size_t index, old_size = OR_matrix[ 0 ].size(),
         other_size = other.OR_matrix[ 0 ].size();
     size_t newsize = old_size + other_size;
 
-    std::vector< bool > temp_vector( other_size, false );
-
-    // extend keys found in this and not other with FALSE
-    for( auto& [ key, data ] : AND_matrix )
+    // extend keys of this with FALSE
+    for( TruthTable& table : AND_matrix.write() )
     {
-        if( other.AND_matrix.count( key ) == 0 )
-        {
-            extend_vector( data.True, temp_vector, newsize );
-            extend_vector( data.False, temp_vector, newsize );
-        }
+        table.True.resize( newsize );
+        table.False.resize( newsize );
     }
 
-    for( auto const& [ key, data ] : other.AND_matrix )
-    {
-        // adds each TruthTable from other to this if needed
-        if( AND_matrix.count( key ) == 0 )
-        {
-            AND_matrix[ key ] = TruthTable( old_size );
-        }
+    // adds each TruthTable from other to this if needed
+    std::vector< size_t > positions = merge_identifiers( other, newsize );
 
-        extend_vector( AND_matrix[ key ].True, data.True, newsize );
-        extend_vector( AND_matrix[ key ].False, data.False, newsize );
+    std::vector< TruthTable > &tables = AND_matrix.write();
+
+    for( index = 0; index < positions.size(); ++index )
+    {
+        tables[ positions[ index ] ].True.or_at( other.AND_matrix[ index ].True, old_size );
+        tables[ positions[ index ] ].False.or_at( other.AND_matrix[ index ].False, old_size );
     }
 }
 
-// This function consolidates duplicate AND sets
-void LogicalMatrix::trim()
+// keeps each element of input_vector for which keep returns true, preserving order
+// keep may modify the elements it is given
+template< typename Type, typename Predicate >
+static inline void filter_vector( std::vector< Type > &input_vector, Predicate keep )
 {
-    if( AND_matrix.empty() || OR_matrix.empty() )
+    size_t index, kept = 0;
+
+    for( index = 0; index < input_vector.size(); ++index )
     {
-        if( !AND_matrix.empty() || !OR_matrix.empty() )
+        if( keep( input_vector[ index ] ) )
         {
-            clear();
-        }
+            if( kept != index )
+            {
+                input_vector[ kept ] = std::move( input_vector[ index ] );
+            }
 
-        return;
+            ++kept;
+        }
     }
 
-    size_t index, inner_index, size = OR_matrix[ 0 ].size();
-    bool temp_bool;
+    input_vector.erase( input_vector.begin() + kept, input_vector.end() );
+}
+
+// the bytes the buffers given back on each thread may hold in all, and the most buffers of one type
+static std::atomic< size_t > scratch_limit( LogicalMatrix::default_scratch_limit );
+static const size_t scratch_depth = 32;
 
-    std::vector< std::vector< bool > > is_subset;
+// the bytes held by the buffers given back on this thread and the function emptying the pool of each type of them
+static thread_local size_t scratch_held = 0;
+static thread_local std::vector< void (*)() > scratch_releases;
 
-    auto analyze_subsets = [ &size, &index, &inner_index, &is_subset ]( const std::vector< bool > &input_vector )
-    {
-        if( !input_vector[ index ] )
+// a T taken empty from those given back on this thread, so the temporaries of each trim and product reuse the capacity
+// earlier ones grew instead of allocating it again, and given back when it goes out of scope unless that passes scratch_limit
+template< typename T >
+class Scratch : public T
+{
+    public:
+        Scratch() : T( take() ) {}
+        Scratch( const Scratch &other ) = delete;
+        Scratch &operator =( const Scratch &other ) = delete;
+
+        ~Scratch()
         {
-            for( inner_index = 0; inner_index < size; ++inner_index )
+            std::vector< T > &pool = given_back();
+
+            T::clear();
+
+            size_t held = bytes( *this );
+
+            if( pool.size() < scratch_depth && scratch_held + held <= scratch_limit.load( std::memory_order_relaxed ) )
             {
-                is_subset[ inner_index ][ index ] = is_subset[ inner_index ][ index ] & !input_vector[ inner_index ];
+                scratch_held += held;
+                pool.push_back( std::move( static_cast< T & >( *this ) ) );
             }
         }
-    };
-
-    auto remove_subset = [ &is_subset, &index ]( const size_t &remove_index )
-    {
-        is_subset.erase( is_subset.begin() + remove_index );
 
-        for( std::vector< bool >& each_set : is_subset )
+    private:
+        static std::vector< T > &given_back()
         {
-            each_set.erase( each_set.begin() + remove_index );
-        }
+            static thread_local std::vector< T > pool;
 
-        index -= ( remove_index < index )? 1 : 0;
-    };
+            if( pool.capacity() == 0 )
+            { // giving back never allocates
+                pool.reserve( scratch_depth );
+                scratch_releases.push_back( &release );
+            }
 
-    auto remove_ANDset = [ &temp_bool, &size, this ]( size_t &remove_index )
-    {
-        size_t sub_index;
+            return pool;
+        }
 
-        for( auto AND_iter = AND_matrix.begin(); AND_iter != AND_matrix.end(); )
+        static T take()
         {
-            temp_bool = false;
-
-            if( AND_iter->second.True[ remove_index ] | AND_iter->second.False[ remove_index ] )
-            { // check if remove_index is the only significant value for AND_iter
-                for( sub_index = 0; sub_index < size; ++sub_index )
-                {
-                    if( sub_index != remove_index )
-                    {
-                        temp_bool |= AND_iter->second.True[ sub_index ] | AND_iter->second.False[ sub_index ];
-                    }
-                }
+            std::vector< T > &pool = given_back();
 
-                temp_bool = !temp_bool;
+            if( pool.empty() )
+            {
+                return T();
             }
 
-            if( temp_bool )
-            { // has no other significant values
-                AND_matrix.erase( AND_iter++ );
-            }
-            else
-            {
-                AND_iter->second.True.erase( AND_iter->second.True.begin() + remove_index );
-                AND_iter->second.False.erase( AND_iter->second.False.begin() + remove_index );
+            T taken( std::move( pool.back() ) );
 
-                ++AND_iter;
-            }
+            pool.pop_back();
+            scratch_held -= bytes( taken );
+            return taken;
         }
 
-        for( std::vector< bool >& statement : OR_matrix )
+        static void release()
         {
-            statement.erase( statement.begin() + remove_index );
-        }
+            std::vector< T > &pool = given_back();
 
-        --remove_index;
-        --size;
-    };
+            for( const T &buffer : pool )
+            {
+                scratch_held -= bytes( buffer );
+            }
 
-    for( index = 0; index < size; ++index )
-    {
-        temp_bool = false;
+            pool.clear();
+        }
 
-        for( std::vector< bool > const& statement : OR_matrix )
+        // the heap bytes a cleared T keeps, the elements of a vector are gone once it is cleared
+        template< typename Element >
+        static size_t bytes( const std::vector< Element > &vector )
         {
-            temp_bool |= statement[ index ];
+            return vector.capacity() * sizeof( Element );
         }
 
-        if( !temp_bool ) // index is not used for any statement
+        static size_t bytes( const BitVector &bits )
         {
-            remove_ANDset( index );
+            return bits.capacity() / BitVector::word_bits * sizeof( BitVector::word_type );
         }
+};
+
+void LogicalMatrix::set_scratch_limit( const size_t limit )
+{
+    scratch_limit.store( limit, std::memory_order_relaxed );
+
+    if( scratch_held > limit )
+    {
+        release_scratch();
     }
+}
 
-    is_subset = std::vector< std::vector< bool > >( size, std::vector< bool >( size, true ) );
+size_t LogicalMatrix::scratch_size()
+{
+    return scratch_held;
+}
 
-    for( auto const& [ key, data ] : AND_matrix )
+void LogicalMatrix::release_scratch()
+{
+    for( void ( *release )() : scratch_releases )
     {
-        for( index = 0; index < size; ++index )
-        {
-            analyze_subsets( data.True );
-            analyze_subsets( data.False );
-        }
+        release();
     }
+}
 
-    for( index = 0; index < size; ++index )
+// lists the literals of each of terms AND sets in increasing order as offsets and literals, literal 2 * k or 2 * k + 1
+// is the True or False column of tables[ k ], or of the TruthTable at positions[ k ] when positions are given in increasing order
+template< typename Table >
+static void list_literals( const std::vector< Table > &tables, const size_t terms, std::vector< uint32_t > &offsets,
+    std::vector< uint32_t > &literals, const std::vector< size_t > *positions = nullptr )
+{
+    auto enumerate = [ & ]( auto function )
     {
-        for( inner_index = 0; inner_index < size; ++inner_index )
+        for( size_t column = 0; column < 2 * tables.size(); ++column )
         {
-            if( index != inner_index && is_subset[ index ][ inner_index ] )
+            const BitVector &set_terms = ( column & 1 )? tables[ column / 2 ].False : tables[ column / 2 ].True;
+            size_t literal = 2 * ( positions? ( *positions )[ column / 2 ] : column / 2 ) + ( column & 1 );
+
+            for( size_t term = set_terms.find_first(); term != BitVector::npos; term = set_terms.find_next( term ) )
             {
-                if( is_subset[ inner_index ][ index ] )
-                { // A is subset of B, B is subset of A, and A == B : combine A and B, remove B
-                    for( std::vector< bool >& statement : OR_matrix )
-                    {
-                        statement[ index ] = statement[ index ] | statement[ inner_index ];
-                    }
+                function( term, literal );
+            }
+        }
+    };
 
-                    remove_subset( inner_index );
-                    remove_ANDset( inner_index );
-                }
-                else
-                { // A is subset of B and A != B
-                    temp_bool = false;
+    offsets.assign( terms + 1, 0 );
+    enumerate( [ &offsets ]( const size_t term, const size_t ){ ++offsets[ term + 1 ]; } );
+    std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+    literals.resize( offsets[ terms ] );
 
-                    for( std::vector< bool >& statement : OR_matrix )
-                    { // if A then remove B
-                        statement[ inner_index ] = statement[ index ]? false : statement[ inner_index ];
-                        temp_bool |= statement[ inner_index ];
-                    }
+    Scratch< std::vector< uint32_t > > cursor;
 
-                    if( !temp_bool ) // B is empty
-                    {
-                        remove_subset( inner_index );
-                        remove_ANDset( inner_index );
-                    }
-                }
-            }
-        }
-    }
+    cursor.assign( offsets.begin(), offsets.end() - 1 );
+    enumerate( [ &literals, &cursor ]( const size_t term, const size_t literal ){ literals[ cursor[ term ]++ ] = literal; } );
 }
 
-// Construct from parsing a string
-// This is where the class parses the string
-// Recursion is possible depending on the input_string
-LogicalMatrix::LogicalMatrix( const std::string &input_string )
+// the statements of each AND set from the AND sets of each statement
+static std::vector< BitVector > transpose( const std::vector< BitVector > &rows, const size_t columns )
 {
-    size_t index, depth, last = 0, length = input_string.size();
-    LogicalMatrix temp_matrix, cumulative_OR, cumulative_AND;
-    bool negated = false, recursive_LSP = false, not_empty = false;
+    std::vector< BitVector > result( columns, BitVector( rows.size() ) );
 
-    auto PAREN_identifier = [ & ]()
+    for( size_t row = 0; row < rows.size(); ++row )
     {
-        if( index - last > 0 )
+        for( size_t column = rows[ row ].find_first(); column != BitVector::npos; column = rows[ row ].find_next( column ) )
+        {
+            result[ column ].set( row );
+        }
+    }
+
+    return result;
+}
+
+// the first AND set added with each hash, kept by open addressing in Scratch buffers so adding AND sets does not allocate
+class FirstWithHash
+{
+    public:
+        FirstWithHash( const size_t count ) : mask( ( size_t ) 1 << ( 64 - __builtin_clzll( 2 * count + 1 ) ) )
         {
-            std::string piece = input_string.substr( last, index - last );
+            slots.assign( mask, none );
+            hashes.resize( mask );
+            --mask;
+        }
 
-            if( trim_string( piece ) )
+        // the AND set first added with hash, term itself when there was none
+        uint32_t try_emplace( const uint64_t hash, const uint32_t term )
+        {
+            for( size_t slot = ( hash ^ ( hash >> 32 ) ) & mask;; slot = ( slot + 1 ) & mask )
             {
-                temp_matrix = LogicalMatrix( piece );
-
-                if( negated )
+                if( slots[ slot ] == none )
                 {
-                    temp_matrix = !temp_matrix;
-                    negated = false;
+                    slots[ slot ] = term;
+                    hashes[ slot ] = hash;
+                    return term;
                 }
 
-                recursive_LSP = true;
-                return;
+                if( hashes[ slot ] == hash )
+                {
+                    return slots[ slot ];
+                }
             }
         }
 
-        throw Logicalstatementexception();
-    };
+    private:
+        static constexpr uint32_t none = -1;
+        size_t mask;
+        Scratch< std::vector< uint32_t > > slots;
+        Scratch< std::vector< uint64_t > > hashes;
+};
 
-    auto AND_identifier = [ & ]()
+// returns other if it has the storage of this, otherwise a copy of other converted to it
+const LogicalMatrix &LogicalMatrix::share_storage( const LogicalMatrix &other, LogicalMatrix &converted ) const
+{
+    if( other.current_storage == current_storage )
     {
-        if( index - last > 0 )
-        {
-            std::string piece = input_string.substr( last, index - last );
+        return other;
+    }
 
-            not_empty = trim_string( piece );
+    converted = other;
+    converted.convert_storage( current_storage );
 
-            if( not_empty )
-            {
-                temp_matrix.AND_matrix[ piece ] = TruthTable( 1, !negated );
-                temp_matrix.OR_matrix.push_back( { true } );
-                negated = false;
-            }
-        }
+    return converted;
+}
 
-        if( not_empty ^ recursive_LSP )
-        {
-            recursive_LSP = not_empty = false;
-            cumulative_AND &= temp_matrix;
-            temp_matrix.clear();
-            return;
-        }
+LogicalMatrix LogicalMatrix::dense_copy() const
+{
+    LogicalMatrix result( *this );
 
-        throw Logicalstatementexception();
-    };
+    result.make_dense();
+    return result;
+}
 
-    auto OR_identifier = [ & ]()
+size_t LogicalMatrix::term_count() const
+{
+    if( current_storage == TermMajor )
     {
-        AND_identifier();
+        return term_positive.size();
+    }
 
-        cumulative_OR |= cumulative_AND;
-        cumulative_AND.clear();
-    };
+    if( current_storage == Sparse )
+    {
+        return term_offsets.size() - 1;
+    }
 
-    auto new_statement = [ & ]()
+    return OR_matrix.empty()? 0 : OR_matrix[ 0 ].size();
+}
+
+// the literals of AND set term in increasing order, in either storage without columns
+void LogicalMatrix::list_term( const size_t &term, std::vector< uint32_t > &literals ) const
+{
+    literals.clear();
+
+    if( current_storage == Sparse )
     {
-        OR_identifier();
+        literals.assign( term_literals.begin() + term_offsets[ term ], term_literals.begin() + term_offsets[ term + 1 ] );
+        return;
+    }
 
-        *this += cumulative_OR;
-        cumulative_OR.clear();
-    };
+    const BitVector &positive = term_positive[ term ], &negative = term_negative[ term ];
+    size_t next_positive = positive.find_first(), next_negative = negative.find_first();
 
-    for( index = 0; index < length; ++index )
+    while( next_positive != BitVector::npos || next_negative != BitVector::npos )
     {
-        switch( input_string[ index ] )
+        if( next_negative == BitVector::npos || ( next_positive != BitVector::npos && next_positive <= next_negative ) )
         {
-            case '\n':
-            case ',':
-                new_statement();
+            literals.push_back( next_positive * 2 );
+            next_positive = positive.find_next( next_positive );
+        }
+        else
+        {
+            literals.push_back( next_negative * 2 + 1 );
+            next_negative = negative.find_next( next_negative );
+        }
+    }
+}
 
-                last = index + 1;
-                break;
-            case '(':
-                depth = 1;
-                last = ++index;
+// the identifiers of the literal lists or masks in increasing order
+std::vector< SymbolTable::id_type > LogicalMatrix::sparse_identifiers() const
+{
+    std::vector< SymbolTable::id_type > result;
 
-                for( ; index < length; ++index )
-                {
-                    if( input_string[ index ] == '(' )
-                    {
-                        ++depth;
-                    }
-                    else if( input_string[ index ] == ')' )
-                    {
-                        if( --depth == 0 )
-                        {
-                            break;
-                        }
-                    }
-                }
+    if( current_storage == TermMajor )
+    {
+        BitVector identifiers( term_positive.empty()? 0 : term_positive[ 0 ].size() );
 
-                if( depth > 0 )
-                {
-                    throw Logicalstatementexception();
-                }
+        for( size_t term = 0; term < term_positive.size(); ++term )
+        {
+            identifiers |= term_positive[ term ];
+            identifiers |= term_negative[ term ];
+        }
 
-                PAREN_identifier();
-                last = index + 1;
+        for( size_t identifier = identifiers.find_first(); identifier != BitVector::npos; identifier = identifiers.find_next( identifier ) )
+        {
+            result.push_back( identifier );
+        }
 
-                break;
-            case ')':
-                throw Logicalstatementexception();
-                break;
-            case '|': // |, ||
-                OR_identifier();
+        return result;
+    }
 
-                index += ( index + 1 < length && input_string[ index + 1 ] == '|' )? 1 : 0;
-                last = index + 1;
-                break;
-            case 'O': // OR
-                if( index + 1 < length && input_string[ index + 1 ] == 'R' )
-                {
-                    OR_identifier();
+    result.reserve( term_literals.size() );
 
-                    index += 1;
-                    last = index + 1;
-                }
+    for( uint32_t const& literal : term_literals )
+    {
+        result.push_back( literal / 2 );
+    }
 
-                break;
-            case '!':
-                negated = !negated;
-                last = index + 1;
-                break;
-            case 'N': // NOT
-                if( index + 2 < length && input_string[ index + 1 ] == 'O' && input_string[ index + 2 ] == 'T' )
-                {
-                    negated = !negated;
-                    index += 2;
-                    last = index + 1;
-                }
+    std::sort( result.begin(), result.end() );
+    result.erase( std::unique( result.begin(), result.end() ), result.end() );
 
-                break;
-            case '&':
-                AND_identifier();
+    return result;
+}
 
-                index += ( index + 1 < length && input_string[ index + 1 ] == '&' )? 1 : 0;
-                last = index + 1;
-                break;
-            case 'A': // AND
-                if( index + 2 < length && input_string[ index + 1 ] == 'N' && input_string[ index + 2 ] == 'D' )
-                {
-                    AND_identifier();
+// the statements of each AND set in increasing order
+std::vector< std::vector< uint32_t > > LogicalMatrix::sparse_term_statements() const
+{
+    std::vector< std::vector< uint32_t > > result( term_count() );
 
-                    index += 2;
-                    last = index + 1;
-                }
+    for( size_t statement = 0; statement + 1 < statement_offsets.size(); ++statement )
+    {
+        for( size_t position = statement_offsets[ statement ]; position < statement_offsets[ statement + 1 ]; ++position )
+        {
+            result[ statement_terms[ position ] ].push_back( statement );
+        }
+    }
 
-                break;
+    return result;
+}
+
+// the row of OR_matrix for statement_index, built from its AND sets in the other storages
+BitVector LogicalMatrix::statement_row( const size_t &statement_index ) const
+{
+    if( current_storage == Dense )
+    {
+        return OR_matrix[ statement_index ];
+    }
+
+    BitVector result( term_count() );
+
+    for( size_t position = statement_offsets[ statement_index ]; position < statement_offsets[ statement_index + 1 ]; ++position )
+    {
+        result.set( statement_terms[ position ] );
+    }
+
+    return result;
+}
+
+// literal 2 * k or 2 * k + 1 of list_literals() becomes id * 2 or id * 2 + 1 of AND_matrix[ k ], keeping its order
+// masks are listed with list_term()
+void LogicalMatrix::make_sparse()
+{
+    if( current_storage == Sparse )
+    {
+        return;
+    }
+
+    if( current_storage == TermMajor )
+    {
+        std::vector< uint32_t > literals;
+
+        term_offsets.assign( 1, 0 );
+        term_literals.clear();
+
+        for( size_t term = 0; term < term_positive.size(); ++term )
+        {
+            list_term( term, literals );
+            term_literals.insert( term_literals.end(), literals.begin(), literals.end() );
+            term_offsets.push_back( term_literals.size() );
         }
+
+        term_positive.release();
+        term_negative.release();
+        current_storage = Sparse;
+        return;
     }
 
-    new_statement();
+    list_literals( AND_matrix.read(), term_count(), term_offsets.write(), term_literals.write() );
+
+    for( uint32_t& literal : term_literals.write() )
+    {
+        literal = AND_matrix[ literal / 2 ].identifier * 2 + ( literal & 1 );
+    }
+
+    statement_offsets.assign( 1, 0 );
+    statement_terms.clear();
+
+    for( BitVector const& statement : OR_matrix )
+    {
+        for( size_t index = statement.find_first(); index != BitVector::npos; index = statement.find_next( index ) )
+        {
+            statement_terms.push_back( index );
+        }
+
+        statement_offsets.push_back( statement_terms.size() );
+    }
+
+    AND_matrix.release();
+    OR_matrix.release();
+    current_storage = Sparse;
 }
 
-// Negation
-// !((a & !b) | (c & d)) = (!a | b) & (!c | !d) = !a & !c | !a & !d | b & !c | b & !d
-LogicalMatrix LogicalMatrix::operator !() const
+void LogicalMatrix::make_dense()
 {
-    if( empty() )
+    if( current_storage == Dense )
     {
-        return LogicalMatrix();
+        return;
     }
 
-    size_t index, old_size = OR_matrix[ 0 ].size();
-    LogicalMatrix result_matrix, cumulative_AND, temp_matrix[ old_size ];
+    make_sparse();
 
-    for( index = 0; index < old_size; ++index )
+    size_t term, terms = term_count();
+    std::vector< SymbolTable::id_type > identifiers = sparse_identifiers();
+
+    for( SymbolTable::id_type const& identifier : identifiers )
     {
-        temp_matrix[ index ] = build_inverse( index );
+        AND_matrix.emplace_back( identifier, terms );
     }
 
-    for( std::vector< bool > const& statement : OR_matrix )
+    OR_matrix.assign( statement_offsets.size() - 1, BitVector( terms ) );
+
+    for( term = 0; term < terms; ++term )
     {
-        for( index = 0; index < old_size; ++index )
+        for( size_t position = term_offsets[ term ]; position < term_offsets[ term + 1 ]; ++position )
         {
-            if( statement[ index ] )
-            {
-                cumulative_AND &= temp_matrix[ index ];
-            }
+            uint32_t literal = term_literals[ position ];
+            TruthTable &table = AND_matrix.write()[ std::lower_bound( identifiers.begin(), identifiers.end(), literal / 2 ) - identifiers.begin() ];
+
+            ( ( literal & 1 )? table.False : table.True ).set( term );
         }
+    }
 
-        result_matrix += cumulative_AND;
-        cumulative_AND.clear();
+    for( size_t statement = 0; statement < OR_matrix.size(); ++statement )
+    {
+        for( size_t position = statement_offsets[ statement ]; position < statement_offsets[ statement + 1 ]; ++position )
+        {
+            OR_matrix.write()[ statement ].set( statement_terms[ position ] );
+        }
     }
 
-    return result_matrix;
+    term_offsets.release();
+    term_literals.release();
+    statement_offsets.release();
+    statement_terms.release();
+    current_storage = Dense;
 }
 
-LogicalMatrix LogicalMatrix::NOT()
+// the masks are as wide as the SymbolTable, or the largest identifier of a matrix without one
+void LogicalMatrix::make_term_major()
 {
-    *this = !(*this);
-    return *this;
+    if( current_storage == TermMajor )
+    {
+        return;
+    }
+
+    make_sparse();
+
+    size_t width = symbols? symbols->size() : 0;
+
+    for( uint32_t const& literal : term_literals )
+    {
+        width = std::max< size_t >( width, literal / 2 + 1 );
+    }
+
+    term_positive.assign( term_count(), BitVector( width ) );
+    term_negative.assign( term_count(), BitVector( width ) );
+
+    for( size_t term = 0; term < term_positive.size(); ++term )
+    {
+        for( size_t position = term_offsets[ term ]; position < term_offsets[ term + 1 ]; ++position )
+        {
+            ( ( term_literals[ position ] & 1 )? term_negative : term_positive ).write()[ term ].set( term_literals[ position ] / 2 );
+        }
+    }
+
+    term_offsets.release();
+    term_literals.release();
+    current_storage = TermMajor;
 }
 
-// Negate specific statement
-LogicalMatrix LogicalMatrix::NOT( const size_t &statement_index )
+void LogicalMatrix::convert_storage( const Storage &storage )
 {
-    if( statement_index >= statement_count() )
+    if( storage == Dense )
     {
-        return *this;
+        make_dense();
+    }
+    else if( storage == Sparse )
+    {
+        make_sparse();
+    }
+    else if( storage == TermMajor )
+    {
+        make_term_major();
+    }
+}
+
+// Adaptive storage is sparse from sparse_term_minimum AND sets once the literal lists take an eighth of the room of the
+// columns and dense again once they take half of it, so a matrix near either bound does not convert after every operation
+void LogicalMatrix::choose_storage()
+{
+    if( requested_storage != Adaptive )
+    {
+        convert_storage( requested_storage );
+        return;
     }
 
-    size_t index, old_size = OR_matrix[ 0 ].size();
-    LogicalMatrix cumulative_AND;
+    if( current_storage == TermMajor )
+    {
+        make_sparse();
+    }
 
-    for( index = 0; index < old_size; ++index )
+    bool sparse = current_storage == Sparse;
+    size_t terms = term_count(), identifiers = 0, entries = 0;
+
+    if( terms < ( sparse? sparse_term_minimum / 2 : sparse_term_minimum ) )
+    {
+        make_dense();
+        return;
+    }
+
+    if( sparse )
+    {
+        identifiers = sparse_identifiers().size();
+        entries = term_literals.size() + statement_terms.size();
+    }
+    else
     {
-        if( OR_matrix[ statement_index ][ index ] )
+        identifiers = AND_matrix.size();
+
+        for( TruthTable const& table : AND_matrix )
         {
-            OR_matrix[ statement_index ][ index ] = false;
+            entries += table.True.count() + table.False.count();
+        }
 
-            cumulative_AND &= build_inverse( index );
+        for( BitVector const& statement : OR_matrix )
+        {
+            entries += statement.count();
         }
     }
 
-    OR_matrix.erase( OR_matrix.begin() + statement_index );
+    size_t dense_bytes = ( 2 * identifiers + statement_count() ) * ( ( terms + 7 ) / 8 ),
+        sparse_bytes = sizeof( uint32_t ) * ( entries + terms + statement_count() + 2 );
 
-    return ADD( cumulative_AND, statement_index );
+    if( sparse && 2 * sparse_bytes > dense_bytes )
+    {
+        make_dense();
+    }
+    else if( !sparse && 8 * sparse_bytes < dense_bytes )
+    {
+        make_sparse();
+    }
 }
 
-// AND yealding a new object
-LogicalMatrix LogicalMatrix::operator &( const LogicalMatrix &other ) const
+void LogicalMatrix::set_storage( const Storage &mode )
 {
-    LogicalMatrix new_matrix( *this );
-    new_matrix &= other;
-    return new_matrix;
+    requested_storage = mode;
+    choose_storage();
 }
 
-// AND assignment
-// ((a & b) | (c & d)) & ((e & f) | (g & h)) = a & b & e & f | a & b & g & h | c & d & e & f | c & d & g & h
-LogicalMatrix LogicalMatrix::operator &=( const LogicalMatrix &other )
+LogicalMatrix::Storage LogicalMatrix::storage() const
+{
+    return current_storage;
+}
+
+void LogicalMatrix::erase_statement( const size_t &statement_index )
+{
+    if( current_storage == Dense )
+    {
+        OR_matrix.erase( OR_matrix.begin() + statement_index );
+        return;
+    }
+
+    size_t removed = statement_offsets[ statement_index + 1 ] - statement_offsets[ statement_index ];
+
+    statement_terms.erase( statement_terms.begin() + statement_offsets[ statement_index ], statement_terms.begin() + statement_offsets[ statement_index + 1 ] );
+    statement_offsets.erase( statement_offsets.begin() + statement_index + 1 );
+
+    for( size_t index = statement_index + 1; index < statement_offsets.size(); ++index )
+    {
+        statement_offsets.write()[ index ] -= removed;
+    }
+}
+
+// Sparse or TermMajor storage of both, the AND sets of source follow those of this and its statements are inserted before statement_index
+// Both are inserted in place, so appending costs the entries of source and inserting also moves the statements after it
+void LogicalMatrix::insert_statements( const LogicalMatrix &source, const size_t &statement_index )
+{
+    size_t index, old_size = term_count(), literal_base = term_literals.size(),
+        depth = std::min( statement_index, statement_count() ), term_base = statement_offsets[ depth ],
+        added = source.statement_terms.size();
+
+    if( current_storage == TermMajor )
+    { // every mask is widened to the wider of the two
+        size_t own = term_positive.empty()? 0 : term_positive[ 0 ].size(),
+            width = std::max( own, source.term_positive.empty()? 0 : source.term_positive[ 0 ].size() );
+
+        term_positive.insert( term_positive.end(), source.term_positive.begin(), source.term_positive.end() );
+        term_negative.insert( term_negative.end(), source.term_negative.begin(), source.term_negative.end() );
+
+        for( index = ( own < width )? 0 : old_size; index < term_positive.size(); ++index )
+        {
+            if( term_positive[ index ].size() != width )
+            {
+                term_positive.write()[ index ].resize( width );
+                term_negative.write()[ index ].resize( width );
+            }
+        }
+    }
+    else
+    {
+        for( index = 1; index < source.term_offsets.size(); ++index )
+        {
+            term_offsets.push_back( literal_base + source.term_offsets[ index ] );
+        }
+
+        term_literals.insert( term_literals.end(), source.term_literals.begin(), source.term_literals.end() );
+    }
+
+    // statements after depth move up by the statements and AND sets of source
+    for( index = depth + 1; index < statement_offsets.size(); ++index )
+    {
+        statement_offsets.write()[ index ] += added;
+    }
+
+    statement_offsets.insert( statement_offsets.begin() + depth + 1, source.statement_offsets.begin() + 1, source.statement_offsets.end() );
+    statement_terms.insert( statement_terms.begin() + term_base, source.statement_terms.begin(), source.statement_terms.end() );
+
+    for( index = depth + 1; index < depth + source.statement_offsets.size(); ++index )
+    {
+        statement_offsets.write()[ index ] += term_base;
+    }
+
+    for( index = term_base; index < term_base + added; ++index )
+    {
+        statement_terms.write()[ index ] += old_size;
+    }
+}
+
+// appends the statements of other after those of this without trimming
+void LogicalMatrix::append_statements( const LogicalMatrix &other )
 {
     if( other.empty() )
     {
-        return *this;
+        return;
+    }
+
+    if( !symbols )
+    {
+        *this = other;
+        return;
+    }
+
+    LogicalMatrix rebound, stored;
+    const LogicalMatrix &source = share_storage( share_symbols( other, rebound ), stored );
+
+    if( current_storage != Dense )
+    {
+        insert_statements( source, statement_count() );
+        return;
+    }
+
+    if( empty() )
+    {
+        AND_matrix = source.AND_matrix;
+        OR_matrix = source.OR_matrix;
+        return;
+    }
+
+    extend_matrix( source );
+
+    size_t old_size = OR_matrix[ 0 ].size(),
+        newsize = old_size + source.OR_matrix[ 0 ].size();
+
+    OR_matrix.reserve( statement_count() + source.statement_count() );
+
+    for( BitVector& statement : OR_matrix.write() )
+    {
+        statement.resize( newsize );
+    }
+
+    for( BitVector const& statement : source.OR_matrix )
+    {
+        OR_matrix.emplace_back( old_size );
+        OR_matrix.write().back().append( statement );
+    }
+}
+
+// This function consolidates duplicate AND sets
+// AND sets are visited in order, each merging its later duplicates, found by hashing literal sets, into itself
+// and dropping every superset, found by ANDing the columns of its literals, from the statements it is part of
+// Statements are kept per AND set while visiting and every removal is applied in one compaction at the end
+void LogicalMatrix::trim()
+{
+    if( current_storage != Dense )
+    {
+        trim_sparse();
+        return;
+    }
+
+    if( AND_matrix.empty() || OR_matrix.empty() )
+    {
+        if( !AND_matrix.empty() || !OR_matrix.empty() )
+        {
+            clear();
+        }
+
+        return;
+    }
+
+    const uint32_t none = -1;
+    const size_t row_words = ( OR_matrix.size() + BitVector::word_bits - 1 ) / BitVector::word_bits;
+    size_t index, statement, size = OR_matrix[ 0 ].size(), max_count = 0;
+    Scratch< BitVector > removed, candidates, keep;
+    Scratch< std::vector< BitVector::word_type > > term_statements;
+    Scratch< std::vector< uint32_t > > literal_offsets, literals, next_duplicate, last_duplicate, same_hash, kept_runs;
+    FirstWithHash first_with_hash( size );
+    bool changed;
+
+    removed.resize( size, true );
+    candidates.resize( size );
+    term_statements.assign( size * row_words, 0 );
+    next_duplicate.assign( size, none );
+    last_duplicate.resize( size );
+
+    // the statements of AND set t are the bits of term_statements[ t * row_words .. ( t + 1 ) * row_words ), kept in one
+    // buffer so trimming needs the same few buffers however many AND sets there are
+    for( statement = 0; statement < OR_matrix.size(); ++statement )
+    {
+        const BitVector &row = OR_matrix[ statement ];
+
+        removed.and_not( row );
+
+        for( index = row.find_first(); index != BitVector::npos; index = row.find_next( index ) )
+        {
+            term_statements[ index * row_words + statement / BitVector::word_bits ] |= ( BitVector::word_type ) 1 << ( statement % BitVector::word_bits );
+        }
+    }
+
+    auto statements_of = [ & ]( const size_t term ){ return term_statements.data() + term * row_words; };
+
+    changed = removed.any(); // AND sets of no statement are dropped
+
+    // literal 2 * k or 2 * k + 1 is the True or False column of AND_matrix[ k ], listed in order for each AND set
+    list_literals( AND_matrix.read(), size, literal_offsets, literals );
+
+    auto literal_count = [ &literal_offsets ]( const size_t term ) -> size_t
+    {
+        return literal_offsets[ term + 1 ] - literal_offsets[ term ];
+    };
+
+    auto same_literals = [ & ]( const size_t left, const size_t right )
+    {
+        return literal_count( left ) == literal_count( right ) && std::equal( literals.begin() + literal_offsets[ left ],
+            literals.begin() + literal_offsets[ left + 1 ], literals.begin() + literal_offsets[ right ] );
+    };
+
+    // chains every duplicate after the first AND set with the same literals, same_hash chains first AND sets sharing a hash
+    same_hash.assign( size, none );
+
+    for( index = 0; index < size; ++index )
+    {
+        if( removed[ index ] )
+        {
+            continue;
+        }
+
+        uint64_t hash = 14695981039346656037ULL;
+
+        for( size_t literal = literal_offsets[ index ]; literal < literal_offsets[ index + 1 ]; ++literal )
+        {
+            hash = ( hash ^ literals[ literal ] ) * 1099511628211ULL;
+        }
+
+        max_count = std::max( max_count, literal_count( index ) );
+        uint32_t first_hashed = first_with_hash.try_emplace( hash, index ), first = ( first_hashed == index )? none : first_hashed;
+
+        while( first != none && !same_literals( first, index ) )
+        {
+            first = same_hash[ first ];
+        }
+
+        if( first != none )
+        {
+            next_duplicate[ last_duplicate[ first ] ] = index;
+            last_duplicate[ first ] = index;
+        }
+        else
+        {
+            last_duplicate[ index ] = index;
+
+            if( first_hashed != index )
+            {
+                same_hash[ index ] = same_hash[ first_hashed ];
+                same_hash[ first_hashed ] = index;
+            }
+        }
+    }
+
+    for( index = 0; index < size; ++index )
+    {
+        if( removed[ index ] )
+        {
+            continue;
+        }
+
+        size_t count = literal_count( index ), candidate = BitVector::npos;
+        uint32_t duplicate = next_duplicate[ index ];
+
+        if( count < max_count )
+        { // every AND set holding all literals of this one, AND sets with the same number of literals are its duplicates
+            candidates.set_range( 0, size );
+
+            for( size_t literal = literal_offsets[ index ]; literal < literal_offsets[ index + 1 ]; ++literal )
+            {
+                candidates &= ( literals[ literal ] & 1 )? AND_matrix[ literals[ literal ] / 2 ].False : AND_matrix[ literals[ literal ] / 2 ].True;
+            }
+
+            candidates.and_not( removed );
+            candidate = candidates.find_first();
+        }
+
+        // duplicates and supersets are handled in order, as merging a duplicate widens the statements of this AND set
+        while( candidate != BitVector::npos || duplicate != none )
+        {
+            if( duplicate != none && ( candidate == BitVector::npos || duplicate < candidate ) )
+            { // A == B : combine A and B, remove B
+                if( !removed[ duplicate ] )
+                {
+                    std::transform( statements_of( index ), statements_of( index + 1 ), statements_of( duplicate ), statements_of( index ), std::bit_or<>() );
+                    removed.set( duplicate );
+                    changed = true;
+                }
+
+                duplicate = next_duplicate[ duplicate ];
+                continue;
+            }
+
+            BitVector::word_type *candidate_statements = statements_of( candidate ), *index_statements = statements_of( index );
+
+            if( literal_count( candidate ) > count && std::inner_product( candidate_statements, candidate_statements + row_words, index_statements,
+                false, std::logical_or<>(), std::bit_and<>() ) )
+            { // A is subset of B and A != B : if A then remove B
+                std::transform( candidate_statements, candidate_statements + row_words, index_statements, candidate_statements,
+                    []( const BitVector::word_type left, const BitVector::word_type right ){ return left & ~right; } );
+                changed = true;
+
+                if( std::all_of( candidate_statements, candidate_statements + row_words, []( const BitVector::word_type word ){ return word == 0; } ) )
+                {
+                    removed.set( candidate );
+                }
+            }
+
+            candidate = candidates.find_next( candidate );
+        }
+    }
+
+    if( !changed )
+    {
+        return;
+    }
+
+    keep.resize( size, true );
+    keep.and_not( removed );
+    size_t kept = 0, kept_count = keep.count(), first_removed = removed.find_first();
+
+    // the runs of kept AND sets after the first removed one, as pairs of begin and end
+    for( index = ( first_removed == BitVector::npos )? BitVector::npos : keep.find_next( first_removed ); index != BitVector::npos; )
+    {
+        size_t end = std::min( removed.find_next( index ), size );
+
+        kept_runs.push_back( index );
+        kept_runs.push_back( end );
+        index = ( end < size )? keep.find_next( end ) : BitVector::npos;
+    }
+
+    // each run of kept bits moves down a word at a time to follow the kept bits before it, so the columns keep their storage
+    // Bits before the first removed AND set stay in place and a column without bits from there on is only shortened
+    auto compact = [ &kept_runs, first_removed, kept_count ]( BitVector &column )
+    {
+        if( first_removed == BitVector::npos )
+        {
+            return;
+        }
+
+        if( ( first_removed == 0 )? column.any() : column.find_next( first_removed - 1 ) != BitVector::npos )
+        {
+            size_t target = first_removed;
+
+            for( size_t run = 0; run < kept_runs.size(); run += 2 )
+            {
+                column.move_range( target, kept_runs[ run ], kept_runs[ run + 1 ] );
+                target += kept_runs[ run + 1 ] - kept_runs[ run ];
+            }
+        }
+
+        column.resize( kept_count );
+    };
+
+    filter_vector( AND_matrix.write(), [ &compact ]( TruthTable &table )
+    {
+        compact( table.True );
+        compact( table.False );
+
+        return table.True.any() || table.False.any();
+    } );
+
+    if( AND_matrix.empty() )
+    {
+        clear();
+        return;
+    }
+
+    for( BitVector& row : OR_matrix.write() )
+    {
+        row.resize( kept_count );
+        row.reset();
+    }
+
+    for( index = keep.find_first(); index != BitVector::npos; index = keep.find_next( index ), ++kept )
+    {
+        for( size_t word = 0; word < row_words; ++word )
+        {
+            for( BitVector::word_type bits = statements_of( index )[ word ]; bits != 0; bits &= bits - 1 )
+            {
+                OR_matrix.write()[ word * BitVector::word_bits + __builtin_ctzll( bits ) ].set( kept );
+            }
+        }
+    }
+}
+
+typedef std::pair< const uint32_t *, const uint32_t * > Span;
+
+// sorted lists left and right share an element
+static inline bool sorted_intersects( const Span &left, const Span &right )
+{
+    const uint32_t *left_iter = left.first, *right_iter = right.first;
+
+    while( left_iter != left.second && right_iter != right.second )
+    {
+        if( *left_iter == *right_iter )
+        {
+            return true;
+        }
+
+        ( *left_iter < *right_iter )? ++left_iter : ++right_iter;
+    }
+
+    return false;
+}
+
+// trim() over literal lists or masks, visiting AND sets, duplicates and supersets in the same order so every storage trims alike
+// The supersets of an AND set are the AND sets holding its literal held by the fewest AND sets that include all of its literals,
+// compared as sorted lists in Sparse storage and by testing each mask against the other in TermMajor storage
+void LogicalMatrix::trim_sparse()
+{
+    size_t size = term_count(), statements = statement_count();
+    const bool masks = current_storage == TermMajor;
+
+    if( empty() || statements == 0 )
+    {
+        if( size > 0 || statements > 0 )
+        {
+            clear();
+        }
+
+        return;
+    }
+
+    const uint32_t none = -1;
+    size_t index, position, max_count = 0, kept = 0;
+    Scratch< BitVector > removed, keep;
+    FirstWithHash first_with_hash( size );
+    Scratch< std::vector< std::vector< uint32_t > > > rewritten;
+    Scratch< std::vector< Span > > term_statements;
+    Scratch< std::vector< uint32_t > > statement_list_offsets, statement_list, literal_offsets, literal_counts, candidates, merged, next_duplicate,
+        last_duplicate, same_hash, list_cursor, cursor, literal_terms, offsets, literals, counts, terms;
+    Scratch< std::vector< BitVector > > positive, negative;
+    bool changed;
+
+    removed.resize( size, true );
+    rewritten.resize( size );
+    term_statements.resize( size );
+    statement_list_offsets.assign( size + 1, 0 );
+    statement_list.resize( statement_terms.size() );
+    literal_offsets.assign( masks? 2 * term_positive[ 0 ].size() + 1 : *std::max_element( term_literals.begin(), term_literals.end() ) + 2, 0 );
+    literal_counts.assign( size, 0 );
+    next_duplicate.assign( size, none );
+    last_duplicate.resize( size );
+    same_hash.assign( size, none );
+
+    // the statements of each AND set are listed together in one buffer and only those that change are copied out
+    for( uint32_t const& term : statement_terms )
+    {
+        ++statement_list_offsets[ term + 1 ];
+    }
+
+    std::partial_sum( statement_list_offsets.begin(), statement_list_offsets.end(), statement_list_offsets.begin() );
+    list_cursor.assign( statement_list_offsets.begin(), statement_list_offsets.end() - 1 );
+
+    for( size_t statement = 0; statement < statements; ++statement )
+    {
+        for( position = statement_offsets[ statement ]; position < statement_offsets[ statement + 1 ]; ++position )
+        {
+            statement_list[ list_cursor[ statement_terms[ position ] ]++ ] = statement;
+        }
+    }
+
+    for( index = 0; index < size; ++index )
+    {
+        term_statements[ index ] = { statement_list.data() + statement_list_offsets[ index ], statement_list.data() + statement_list_offsets[ index + 1 ] };
+
+        if( term_statements[ index ].first != term_statements[ index ].second )
+        {
+            removed.reset( index );
+        }
+    }
+
+    // the statements of term become merged
+    auto rewrite = [ & ]( const size_t term )
+    {
+        rewritten[ term ].swap( merged );
+        term_statements[ term ] = { rewritten[ term ].data(), rewritten[ term ].data() + rewritten[ term ].size() };
+    };
+
+    changed = removed.any(); // AND sets of no statement are dropped
+
+    // calls visit with each literal of term, masks list the positive literals before the negative ones
+    auto for_each_literal = [ this, masks ]( const size_t term, auto &&visit )
+    {
+        if( !masks )
+        {
+            for( size_t position = term_offsets[ term ]; position < term_offsets[ term + 1 ]; ++position )
+            {
+                visit( term_literals[ position ] );
+            }
+
+            return;
+        }
+
+        for( size_t identifier = term_positive[ term ].find_first(); identifier != BitVector::npos; identifier = term_positive[ term ].find_next( identifier ) )
+        {
+            visit( identifier * 2 );
+        }
+
+        for( size_t identifier = term_negative[ term ].find_first(); identifier != BitVector::npos; identifier = term_negative[ term ].find_next( identifier ) )
+        {
+            visit( identifier * 2 + 1 );
+        }
+    };
+
+    // the AND sets holding each literal, in increasing order
+    for( index = 0; index < size; ++index )
+    {
+        for_each_literal( index, [ & ]( const uint32_t literal )
+        {
+            ++literal_offsets[ literal + 1 ];
+            ++literal_counts[ index ];
+        } );
+    }
+
+    std::partial_sum( literal_offsets.begin(), literal_offsets.end(), literal_offsets.begin() );
+    cursor.assign( literal_offsets.begin(), literal_offsets.end() - 1 );
+    literal_terms.resize( literal_offsets.back() );
+
+    for( index = 0; index < size; ++index )
+    {
+        for_each_literal( index, [ & ]( const uint32_t literal )
+        {
+            literal_terms[ cursor[ literal ]++ ] = index;
+        } );
+    }
+
+    auto literal_count = [ &literal_counts ]( const size_t term ) -> size_t
+    {
+        return literal_counts[ term ];
+    };
+
+    auto same_literals = [ & ]( const size_t left, const size_t right )
+    {
+        if( masks )
+        {
+            return term_positive[ left ] == term_positive[ right ] && term_negative[ left ] == term_negative[ right ];
+        }
+
+        return literal_count( left ) == literal_count( right ) && std::equal( term_literals.begin() + term_offsets[ left ],
+            term_literals.begin() + term_offsets[ left + 1 ], term_literals.begin() + term_offsets[ right ] );
+    };
+
+    // whether every literal of term is one of superset
+    auto includes = [ & ]( const size_t superset, const size_t term )
+    {
+        if( masks )
+        {
+            return term_positive[ term ].is_subset_of( term_positive[ superset ] ) && term_negative[ term ].is_subset_of( term_negative[ superset ] );
+        }
+
+        return std::includes( term_literals.begin() + term_offsets[ superset ], term_literals.begin() + term_offsets[ superset + 1 ],
+            term_literals.begin() + term_offsets[ term ], term_literals.begin() + term_offsets[ term + 1 ] );
+    };
+
+    // chains every duplicate after the first AND set with the same literals, same_hash chains first AND sets sharing a hash
+
+    for( index = 0; index < size; ++index )
+    {
+        if( removed[ index ] )
+        {
+            continue;
+        }
+
+        uint64_t hash = 14695981039346656037ULL;
+
+        for_each_literal( index, [ &hash ]( const uint32_t literal )
+        {
+            hash = ( hash ^ literal ) * 1099511628211ULL;
+        } );
+
+        max_count = std::max( max_count, literal_count( index ) );
+        uint32_t first_hashed = first_with_hash.try_emplace( hash, index ), first = ( first_hashed == index )? none : first_hashed;
+
+        while( first != none && !same_literals( first, index ) )
+        {
+            first = same_hash[ first ];
+        }
+
+        if( first != none )
+        {
+            next_duplicate[ last_duplicate[ first ] ] = index;
+            last_duplicate[ first ] = index;
+        }
+        else
+        {
+            last_duplicate[ index ] = index;
+
+            if( first_hashed != index )
+            {
+                same_hash[ index ] = same_hash[ first_hashed ];
+                same_hash[ first_hashed ] = index;
+            }
+        }
+    }
+
+    for( index = 0; index < size; ++index )
+    {
+        if( removed[ index ] )
+        {
+            continue;
+        }
+
+        size_t count = literal_count( index ), next = 0;
+        uint32_t duplicate = next_duplicate[ index ], rarest = none;
+
+        candidates.clear();
+
+        if( count < max_count )
+        { // every AND set holding all literals of this one, AND sets with the same number of literals are its duplicates
+            for_each_literal( index, [ & ]( const uint32_t literal )
+            {
+                if( rarest == none || literal_offsets[ literal + 1 ] - literal_offsets[ literal ] < literal_offsets[ rarest + 1 ] - literal_offsets[ rarest ] )
+                {
+                    rarest = literal;
+                }
+            } );
+
+            for( position = literal_offsets[ rarest ]; rarest != none && position < literal_offsets[ rarest + 1 ]; ++position )
+            {
+                uint32_t term = literal_terms[ position ];
+
+                if( !removed[ term ] && includes( term, index ) )
+                {
+                    candidates.push_back( term );
+                }
+            }
+        }
+
+        // duplicates and supersets are handled in order, as merging a duplicate widens the statements of this AND set
+        while( next < candidates.size() || duplicate != none )
+        {
+            if( duplicate != none && ( next == candidates.size() || duplicate < candidates[ next ] ) )
+            { // A == B : combine A and B, remove B
+                if( !removed[ duplicate ] )
+                {
+                    merged.clear();
+                    std::set_union( term_statements[ index ].first, term_statements[ index ].second, term_statements[ duplicate ].first,
+                        term_statements[ duplicate ].second, std::back_inserter( merged ) );
+                    rewrite( index );
+                    removed.set( duplicate );
+                    changed = true;
+                }
+
+                duplicate = next_duplicate[ duplicate ];
+                continue;
+            }
+
+            uint32_t candidate = candidates[ next++ ];
+
+            if( literal_count( candidate ) > count && sorted_intersects( term_statements[ candidate ], term_statements[ index ] ) )
+            { // A is subset of B and A != B : if A then remove B
+                merged.clear();
+                std::set_difference( term_statements[ candidate ].first, term_statements[ candidate ].second, term_statements[ index ].first,
+                    term_statements[ index ].second, std::back_inserter( merged ) );
+                rewrite( candidate );
+                changed = true;
+
+                if( term_statements[ candidate ].first == term_statements[ candidate ].second )
+                {
+                    removed.set( candidate );
+                }
+            }
+        }
+    }
+
+    if( !changed )
+    {
+        return;
+    }
+
+    size_t kept_literals = 0;
+
+    keep.resize( size, true );
+    keep.and_not( removed );
+    offsets.assign( 1, 0 );
+    counts.assign( statements + 1, 0 );
+
+    for( index = keep.find_first(); index != BitVector::npos; index = keep.find_next( index ) )
+    {
+        if( masks )
+        {
+            positive.push_back( std::move( term_positive.write()[ index ] ) );
+            negative.push_back( std::move( term_negative.write()[ index ] ) );
+        }
+        else
+        {
+            literals.insert( literals.end(), term_literals.begin() + term_offsets[ index ], term_literals.begin() + term_offsets[ index + 1 ] );
+            offsets.push_back( literals.size() );
+        }
+
+        kept_literals += literal_count( index );
+
+        for( const uint32_t *statement = term_statements[ index ].first; statement != term_statements[ index ].second; ++statement )
+        {
+            ++counts[ *statement + 1 ];
+        }
+    }
+
+    if( kept_literals == 0 )
+    {
+        clear();
+        return;
+    }
+
+    std::partial_sum( counts.begin(), counts.end(), counts.begin() );
+    terms.resize( counts[ statements ] );
+    cursor.assign( counts.begin(), counts.end() - 1 );
+
+    for( index = keep.find_first(); index != BitVector::npos; index = keep.find_next( index ), ++kept )
+    {
+        for( const uint32_t *statement = term_statements[ index ].first; statement != term_statements[ index ].second; ++statement )
+        {
+            terms[ cursor[ *statement ]++ ] = kept;
+        }
+    }
+
+    // the replaced lists go back as Scratch for the next trim
+    if( masks )
+    {
+        term_positive.adopt( positive );
+        term_negative.adopt( negative );
+    }
+    else
+    {
+        term_offsets.adopt( offsets );
+        term_literals.adopt( literals );
+    }
+
+    statement_offsets.adopt( counts );
+    statement_terms.adopt( terms );
+}
+
+// Construct from parsing a string
+// This is where the class parses the string
+// A single pass over the string keeps one Frame per open parenthesis instead of recursing,
+// a closed group is then used like an identifier of the enclosing Frame
+// Every identifier is interned into symbol_table, or a new SymbolTable when none is given
+LogicalMatrix::LogicalMatrix( const std::string &input_string, std::shared_ptr< SymbolTable > symbol_table ) : symbols( symbol_table? symbol_table : std::make_shared< SymbolTable >() )
+{
+    struct Frame
+    {
+        LogicalMatrix temp_matrix, cumulative_OR, cumulative_AND, result;
+        size_t last, end, close;
+        bool negated = false, recursive_LSP = false;
+    };
+
+    const std::string_view input( input_string );
+    size_t index, group = 0, length = input.size();
+    std::vector< size_t > closing, open;
+    std::vector< Frame > frames;
+
+    for( index = 0; index < length; ++index )
+    { // parentheses are matched up front so nothing is interned for an unbalanced statement
+        if( input[ index ] == '(' )
+        {
+            open.push_back( closing.size() );
+            closing.push_back( 0 );
+        }
+        else if( input[ index ] == ')' )
+        {
+            if( open.empty() )
+            {
+                throw Logicalstatementexception();
+            }
+
+            closing[ open.back() ] = index;
+            open.pop_back();
+        }
+    }
+
+    if( !open.empty() )
+    {
+        throw Logicalstatementexception();
+    }
+
+    auto open_frame = [ & ]( const size_t begin, const size_t end, const size_t close )
+    {
+        frames.emplace_back();
+        frames.back().temp_matrix.symbols = symbols;
+        frames.back().result.symbols = symbols;
+        frames.back().last = begin;
+        frames.back().end = end;
+        frames.back().close = close;
+    };
+
+    // a parenthesized group ignores surrounding whitespace and must not be empty
+    auto PAREN_identifier = [ & ]()
+    {
+        size_t close = closing[ group++ ], begin = index + 1, end = close;
+
+        while( begin < end && std::isspace( ( unsigned char ) input[ begin ] ) )
+        {
+            ++begin;
+        }
+
+        while( end > begin && std::isspace( ( unsigned char ) input[ end - 1 ] ) )
+        {
+            --end;
+        }
+
+        if( begin == end )
+        {
+            throw Logicalstatementexception();
+        }
+
+        open_frame( begin, end, close );
+        index = begin;
+    };
+
+    auto AND_identifier = [ & ]()
+    {
+        Frame &frame = frames.back();
+        bool not_empty = false;
+
+        if( index - frame.last > 0 )
+        {
+            std::string_view piece = input.substr( frame.last, index - frame.last );
+
+            not_empty = trim_view( piece );
+
+            if( not_empty )
+            {
+                frame.temp_matrix.AND_matrix.emplace_back( symbols->intern( std::string( piece ) ), 1, !frame.negated );
+                frame.temp_matrix.OR_matrix.push_back( BitVector( 1, true ) );
+                frame.negated = false;
+            }
+        }
+
+        if( not_empty ^ frame.recursive_LSP )
+        {
+            frame.recursive_LSP = false;
+            frame.cumulative_AND &= frame.temp_matrix;
+            frame.temp_matrix.clear();
+            return;
+        }
+
+        throw Logicalstatementexception();
+    };
+
+    auto OR_identifier = [ & ]()
+    {
+        Frame &frame = frames.back();
+
+        AND_identifier();
+
+        frame.cumulative_OR |= frame.cumulative_AND;
+        frame.cumulative_AND.clear();
+    };
+
+    auto new_statement = [ & ]()
+    {
+        Frame &frame = frames.back();
+
+        OR_identifier();
+
+        frame.result += frame.cumulative_OR;
+        frame.cumulative_OR.clear();
+    };
+
+    // ends the innermost group, which becomes the pending operand of the enclosing Frame
+    auto close_frame = [ & ]()
+    {
+        LogicalMatrix group_matrix;
+
+        new_statement();
+        group_matrix = std::move( frames.back().result );
+        index = frames.back().close;
+        frames.pop_back();
+
+        Frame &frame = frames.back();
+
+        if( frame.negated )
+        { // a small group is expanded right away so statements keep the order of their AND sets as written, a larger one
+          // stays in CNF and is only converted when joined to an operand that takes more sets in CNF than it does in DNF
+            group_matrix = !std::move( group_matrix );
+
+            if( group_matrix.conversion_size( parsed_expansion_maximum ) <= parsed_expansion_maximum )
+            {
+                group_matrix = group_matrix.to_DNF();
+            }
+
+            frame.negated = false;
+        }
+
+        frame.temp_matrix = std::move( group_matrix );
+        frame.recursive_LSP = true;
+        frame.last = index + 1;
+    };
+
+    // the keyword at index, not reaching past the end of the innermost group
+    auto keyword = [ & ]( const std::string_view word )
+    {
+        return index + word.size() <= frames.back().end && input.compare( index, word.size(), word ) == 0;
+    };
+
+    open_frame( 0, length, length );
+
+    for( index = 0; frames.size() > 1 || index < length; ++index )
+    {
+        if( index >= frames.back().end )
+        {
+            close_frame();
+            continue;
+        }
+
+        switch( input[ index ] )
+        {
+            case '\n':
+            case ',':
+                new_statement();
+
+                frames.back().last = index + 1;
+                break;
+            case '(':
+                PAREN_identifier();
+                --index;
+                break;
+            case '|': // |, ||
+                OR_identifier();
+
+                index += keyword( "||" )? 1 : 0;
+                frames.back().last = index + 1;
+                break;
+            case 'O': // OR
+                if( keyword( "OR" ) )
+                {
+                    OR_identifier();
+
+                    index += 1;
+                    frames.back().last = index + 1;
+                }
+
+                break;
+            case '!':
+                frames.back().negated = !frames.back().negated;
+                frames.back().last = index + 1;
+                break;
+            case 'N': // NOT
+                if( keyword( "NOT" ) )
+                {
+                    frames.back().negated = !frames.back().negated;
+                    index += 2;
+                    frames.back().last = index + 1;
+                }
+
+                break;
+            case '&':
+                AND_identifier();
+
+                index += keyword( "&&" )? 1 : 0;
+                frames.back().last = index + 1;
+                break;
+            case 'A': // AND
+                if( keyword( "AND" ) )
+                {
+                    AND_identifier();
+
+                    index += 2;
+                    frames.back().last = index + 1;
+                }
+
+                break;
+        }
+    }
+
+    new_statement();
+    *this = std::move( frames.back().result );
+}
+
+// Load every statement of a file
+// The file is split at each ',' and newline outside of parentheses, blank lines are skipped
+// Statements are parsed in chunks on pool, each worker interning into a SymbolTable of its own,
+// then appended in order into one matrix sharing symbol_table and trimmed once
+// Chunks are gathered in sparse storage, so appending never widens columns, and the result is stored by density
+LogicalMatrix LogicalMatrix::load( const std::string &path, ThreadPool *pool, std::shared_ptr< SymbolTable > symbol_table )
+{
+    MappedFile file;
+    LogicalMatrix result;
+    std::vector< std::string_view > statements;
+    size_t index, begin = 0, tasks;
+    long depth = 0;
+    bool line_begin = true;
+
+    if( !file.open( path ) )
+    {
+        throw Logicalfileexception();
+    }
+
+    const std::string_view input = file.view();
+
+    // a statement holding only whitespace is a blank line when newlines or the file bound it on both sides
+    auto split = [ & ]( const size_t end, const bool line_end )
+    {
+        std::string_view piece = input.substr( begin, end - begin ), trimmed = piece;
+
+        if( trim_view( trimmed ) || !line_begin || !line_end )
+        {
+            statements.push_back( piece );
+        }
+
+        begin = end + 1;
+        line_begin = line_end;
+    };
+
+    for( index = 0; index < input.size(); ++index )
+    { // unbalanced parentheses stay within one statement for the parser to reject
+        if( input[ index ] == '(' )
+        {
+            ++depth;
+        }
+        else if( input[ index ] == ')' )
+        {
+            --depth;
+        }
+        else if( depth == 0 && ( input[ index ] == ',' || input[ index ] == '\n' ) )
+        {
+            split( index, input[ index ] == '\n' );
+        }
+    }
+
+    split( input.size(), true );
+
+    tasks = std::min( statements.size(), pool? pool->size() * 4 : 1 );
+
+    std::vector< LogicalMatrix > chunks( tasks );
+    std::vector< std::shared_ptr< SymbolTable > > tables( pool? pool->size() : 1 );
+
+    for( std::shared_ptr< SymbolTable >& table : tables )
+    {
+        table = std::make_shared< SymbolTable >();
+    }
+
+    auto parse_chunk = [ & ]( const size_t task, const size_t worker )
+    {
+        size_t first = task * statements.size() / tasks, last = ( task + 1 ) * statements.size() / tasks;
+
+        for( size_t statement = first; statement < last; ++statement )
+        {
+            LogicalMatrix parsed( std::string{ statements[ statement ] }, tables[ worker ] );
+
+            parsed.make_sparse();
+            chunks[ task ].append_statements( parsed );
+        }
+    };
+
+    if( pool )
+    {
+        pool->run( tasks, parse_chunk );
+    }
+    else if( tasks > 0 )
+    {
+        parse_chunk( 0, 0 );
+    }
+
+    result.symbols = symbol_table? symbol_table : std::make_shared< SymbolTable >();
+    result.make_sparse();
+
+    for( LogicalMatrix const& chunk : chunks )
+    {
+        result.append_statements( chunk );
+    }
+
+    result.trim();
+    result.choose_storage();
+
+    return result;
+}
+
+// Binary form written by serialize(), all integers least significant byte first
+//     "LGMX", uint32 version, uint64 size of the whole record in bytes
+//     uint8 form, uint8 storage, uint8 requested storage, uint8 flags ( 1 drops contradictions, 2 minimizes automatically )
+//     uint32 identifiers, uint64 conversion limit, then each identifier name as uint32 length and bytes
+//     unless the matrix is empty, uint32 AND sets, statements, literals and memberships, then the sparse lists term_offsets, term_literals,
+//     statement_offsets and statement_terms as uint32, a literal naming an identifier by its place in the list above
+//     uint64 FNV-1a hash of every byte before it
+static const char serial_magic[] = "LGMX";
+static const uint32_t serial_version = 1;
+static const size_t serial_header_size = 16;
+static const size_t serial_chunk_size = 1 << 20;
+
+static uint64_t serial_hash( const char *data, const size_t size )
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    for( size_t index = 0; index < size; ++index )
+    {
+        hash = ( hash ^ ( uint8_t ) data[ index ] ) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+template< typename Value >
+static void serial_put( std::string &output, const Value value )
+{
+    for( size_t byte = 0; byte < sizeof( Value ); ++byte )
+    {
+        output.push_back( ( char )( ( uint64_t ) value >> ( 8 * byte ) ) );
+    }
+}
+
+// the lists are copied whole where the host already stores them least significant byte first
+static void serial_put( std::string &output, const std::vector< uint32_t > &values )
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    output.append( reinterpret_cast< const char * >( values.data() ), values.size() * sizeof( uint32_t ) );
+#else
+    for( uint32_t const& value : values )
+    {
+        serial_put( output, value );
+    }
+#endif
+}
+
+// reads a record written by serialize(), throwing Logicalformatexception past its end
+class SerialReader
+{
+    public:
+        SerialReader( const std::string_view &input ) : input( input ), position( 0 ) {}
+
+        const char *take( const size_t size )
+        {
+            if( size > input.size() - position )
+            {
+                throw LogicalMatrix::Logicalformatexception();
+            }
+
+            position += size;
+            return input.data() + position - size;
+        }
+
+        template< typename Value >
+        Value get()
+        {
+            const char *bytes = take( sizeof( Value ) );
+            uint64_t value = 0;
+
+            for( size_t byte = 0; byte < sizeof( Value ); ++byte )
+            {
+                value |= ( uint64_t )( uint8_t ) bytes[ byte ] << ( 8 * byte );
+            }
+
+            return ( Value ) value;
+        }
+
+        void get( std::vector< uint32_t > &values, const size_t count )
+        {
+            if( count > ( input.size() - position ) / sizeof( uint32_t ) )
+            {
+                throw LogicalMatrix::Logicalformatexception();
+            }
+
+            values.resize( count );
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            const char *bytes = take( count * sizeof( uint32_t ) );
+
+            if( count > 0 )
+            {
+                std::memcpy( values.data(), bytes, count * sizeof( uint32_t ) );
+            }
+#else
+            for( uint32_t& value : values )
+            {
+                value = get< uint32_t >();
+            }
+#endif
+        }
+
+    private:
+        std::string_view input;
+        size_t position;
+};
+
+// offsets into a list of size entries, starting at 0 and never decreasing
+static bool serial_offsets( const std::vector< uint32_t > &offsets, const size_t size )
+{
+    return offsets.front() == 0 && offsets.back() == size && std::is_sorted( offsets.begin(), offsets.end() );
+}
+
+// each range of values between offsets strictly increasing and below bound
+static bool serial_ranges( const std::vector< uint32_t > &offsets, const std::vector< uint32_t > &values, const size_t bound )
+{
+    for( size_t range = 0; range + 1 < offsets.size(); ++range )
+    {
+        for( size_t position = offsets[ range ]; position < offsets[ range + 1 ]; ++position )
+        {
+            if( values[ position ] >= bound || ( position > offsets[ range ] && values[ position ] <= values[ position - 1 ] ) )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// the statements, form, storage and settings of this as one record, see deserialize()
+std::string LogicalMatrix::serialize() const
+{
+    LogicalMatrix sparse_copy;
+    const LogicalMatrix *sparse = this;
+    std::vector< SymbolTable::id_type > identifiers;
+    std::string output( serial_magic, 4 );
+
+    if( !empty() && current_storage != Sparse )
+    {
+        sparse_copy = *this;
+        sparse_copy.make_sparse();
+        sparse = &sparse_copy;
+    }
+
+    if( !empty() )
+    {
+        identifiers = sparse->sparse_identifiers();
+    }
+
+    serial_put( output, serial_version );
+    serial_put( output, ( uint64_t ) 0 );
+    serial_put( output, ( uint8_t ) matrix_form );
+    serial_put( output, ( uint8_t ) current_storage );
+    serial_put( output, ( uint8_t ) requested_storage );
+    serial_put( output, ( uint8_t )( drop_contradictions | minimize_automatically << 1 ) );
+    serial_put( output, ( uint32_t ) identifiers.size() );
+    serial_put( output, ( uint64_t ) DNF_limit );
+
+    for( SymbolTable::id_type const& identifier : identifiers )
+    {
+        const std::string &identifier_name = symbols->name( identifier );
+
+        serial_put( output, ( uint32_t ) identifier_name.size() );
+        output += identifier_name;
+    }
+
+    if( !empty() )
+    {
+        std::vector< uint32_t > literals( sparse->term_literals );
+
+        for( uint32_t& literal : literals )
+        { // identifiers are numbered in increasing order, which keeps the literals of each AND set in order
+            literal = 2 * ( std::lower_bound( identifiers.begin(), identifiers.end(), literal / 2 ) - identifiers.begin() ) + ( literal & 1 );
+        }
+
+        serial_put( output, ( uint32_t ) sparse->term_count() );
+        serial_put( output, ( uint32_t ) sparse->statement_count() );
+        serial_put( output, ( uint32_t ) literals.size() );
+        serial_put( output, ( uint32_t ) sparse->statement_terms.size() );
+        serial_put( output, sparse->term_offsets.read() );
+        serial_put( output, literals );
+        serial_put( output, sparse->statement_offsets.read() );
+        serial_put( output, sparse->statement_terms.read() );
+    }
+
+    std::string size;
+
+    serial_put( size, ( uint64_t )( output.size() + sizeof( uint64_t ) ) );
+    output.replace( 8, sizeof( uint64_t ), size );
+    serial_put( output, serial_hash( output.data(), output.size() ) );
+
+    return output;
+}
+
+void LogicalMatrix::serialize( std::ostream &output ) const
+{
+    std::string record = serialize();
+
+    output.write( record.data(), record.size() );
+}
+
+// Rebuilds a matrix written by serialize() from the first record of input without parsing or trimming it
+// Every identifier is interned into symbol_table, or a new SymbolTable when none is given
+LogicalMatrix LogicalMatrix::deserialize( const std::string_view &input, std::shared_ptr< SymbolTable > symbol_table )
+{
+    SerialReader reader( input );
+    LogicalMatrix result;
+
+    if( std::string_view( reader.take( 4 ), 4 ) != std::string_view( serial_magic, 4 ) || reader.get< uint32_t >() != serial_version )
+    {
+        throw Logicalformatexception();
+    }
+
+    uint64_t record_size = reader.get< uint64_t >();
+
+    if( record_size < serial_header_size + sizeof( uint64_t ) || record_size > input.size() ||
+        serial_hash( input.data(), record_size - sizeof( uint64_t ) ) != SerialReader( input.substr( record_size - sizeof( uint64_t ) ) ).get< uint64_t >() )
+    {
+        throw Logicalformatexception();
+    }
+
+    reader = SerialReader( input.substr( 0, record_size - sizeof( uint64_t ) ) );
+    reader.take( serial_header_size );
+
+    uint8_t form = reader.get< uint8_t >(), storage = reader.get< uint8_t >(), requested = reader.get< uint8_t >(), flags = reader.get< uint8_t >();
+    uint32_t identifier_count = reader.get< uint32_t >();
+
+    if( form > CNF || storage > TermMajor || requested > Adaptive || flags > 3 )
+    {
+        throw Logicalformatexception();
+    }
+
+    result.symbols = symbol_table? symbol_table : std::make_shared< SymbolTable >();
+    result.matrix_form = ( Form ) form;
+    result.requested_storage = ( Storage ) requested;
+    result.drop_contradictions = flags & 1;
+    result.minimize_automatically = flags & 2;
+    result.DNF_limit = reader.get< uint64_t >();
+
+    std::vector< std::string_view > names;
+    std::vector< SymbolTable::id_type > identifiers;
+
+    for( size_t index = 0; index < identifier_count; ++index )
+    {
+        uint32_t length = reader.get< uint32_t >();
+
+        names.emplace_back( reader.take( length ), length );
+    }
+
+    if( identifier_count == 0 )
+    { // an empty matrix
+        result.clear();
+        result.matrix_form = ( Form ) form;
+        return result;
+    }
+
+    uint32_t terms = reader.get< uint32_t >(), statements = reader.get< uint32_t >(), literals = reader.get< uint32_t >(), memberships = reader.get< uint32_t >();
+
+    reader.get( result.term_offsets.write(), terms + ( size_t ) 1 );
+    reader.get( result.term_literals.write(), literals );
+    reader.get( result.statement_offsets.write(), statements + ( size_t ) 1 );
+    reader.get( result.statement_terms.write(), memberships );
+
+    if( !serial_offsets( result.term_offsets, literals ) || !serial_offsets( result.statement_offsets, memberships ) ||
+        !serial_ranges( result.term_offsets, result.term_literals, 2 * names.size() ) || !serial_ranges( result.statement_offsets, result.statement_terms, terms ) ||
+        reader.take( 0 ) != input.data() + record_size - sizeof( uint64_t ) )
+    {
+        throw Logicalformatexception();
+    }
+
+    // nothing is interned before the record is known to be whole
+    std::vector< std::string_view > ordered_names( names );
+
+    std::sort( ordered_names.begin(), ordered_names.end() );
+
+    if( std::adjacent_find( ordered_names.begin(), ordered_names.end() ) != ordered_names.end() )
+    {
+        throw Logicalformatexception();
+    }
+
+    for( const std::string_view &identifier_name : names )
+    {
+        identifiers.push_back( result.symbols->intern( std::string( identifier_name ) ) );
+    }
+
+    for( uint32_t &literal : result.term_literals.write() )
+    {
+        literal = 2 * identifiers[ literal / 2 ] + ( literal & 1 );
+    }
+
+    if( !std::is_sorted( identifiers.begin(), identifiers.end() ) )
+    { // a shared SymbolTable numbering the identifiers in another order
+        for( size_t term = 0; term < terms; ++term )
+        {
+            std::sort( result.term_literals.write().begin() + result.term_offsets[ term ], result.term_literals.write().begin() + result.term_offsets[ term + 1 ] );
+        }
+    }
+
+    result.current_storage = Sparse;
+    result.convert_storage( ( Storage ) storage );
+
+    return result;
+}
+
+// reads one record written by serialize() from input, leaving input after it
+LogicalMatrix LogicalMatrix::deserialize( std::istream &input, std::shared_ptr< SymbolTable > symbol_table )
+{
+    std::string record( serial_header_size, '\0' );
+
+    if( !input.read( &record[ 0 ], serial_header_size ) )
+    {
+        throw Logicalformatexception();
+    }
+
+    SerialReader header( record );
+
+    if( std::string_view( header.take( 4 ), 4 ) != std::string_view( serial_magic, 4 ) || header.get< uint32_t >() != serial_version )
+    {
+        throw Logicalformatexception();
+    }
+
+    uint64_t record_size = header.get< uint64_t >();
+
+    if( record_size < serial_header_size + sizeof( uint64_t ) || record_size > ( uint64_t ) 1 << 40 )
+    {
+        throw Logicalformatexception();
+    }
+
+    // the record grows only as its bytes arrive, so a damaged size cannot claim memory the stream does not hold
+    while( record.size() < record_size )
+    {
+        size_t begin = record.size(), chunk = std::min< uint64_t >( record_size - begin, serial_chunk_size );
+
+        record.resize( begin + chunk );
+
+        if( !input.read( &record[ begin ], chunk ) )
+        {
+            throw Logicalformatexception();
+        }
+    }
+
+    return deserialize( std::string_view( record ), symbol_table );
+}
+
+// Negation
+// !((a & !b) | (c & d)) = (!a | b) & (!c | !d)
+// Complementing every literal turns a DNF matrix into the CNF of its negation and back
+void LogicalMatrix::negate()
+{
+    if( empty() )
+    {
+        return;
+    }
+
+    for( TruthTable& table : AND_matrix.write() )
+    {
+        std::swap( table.True, table.False );
+    }
+
+    for( uint32_t& literal : term_literals.write() )
+    {
+        literal ^= 1;
+    }
+
+    term_positive.swap( term_negative );
+
+    for( size_t term = 0; current_storage == Sparse && term < term_count(); ++term )
+    { // x and !x of one AND set trade places
+        std::sort( term_literals.write().begin() + term_offsets[ term ], term_literals.write().begin() + term_offsets[ term + 1 ] );
+    }
+
+    matrix_form = ( matrix_form == DNF )? CNF : DNF;
+
+    if( minimize_automatically )
+    {
+        minimize();
+    }
+}
+
+LogicalMatrix LogicalMatrix::operator !() const &
+{
+    LogicalMatrix result_matrix( *this );
+
+    result_matrix.negate();
+    return result_matrix;
+}
+
+LogicalMatrix LogicalMatrix::operator !() &&
+{
+    negate();
+    return std::move( *this );
+}
+
+LogicalMatrix &LogicalMatrix::NOT()
+{
+    negate();
+    return *this;
+}
+
+// Negate specific statement
+// The negated statement is in the other form, ADD brings the two to one form converting whichever is smaller
+LogicalMatrix &LogicalMatrix::NOT( const size_t &statement_index )
+{
+    if( statement_index >= statement_count() )
+    {
+        return *this;
+    }
+
+    LogicalMatrix negated = !isolate_statement( statement_index );
+
+    erase_statement( statement_index );
+
+    return ADD( negated, statement_index );
+}
+
+// AND yealding a new object
+LogicalMatrix LogicalMatrix::operator &( const LogicalMatrix &other ) const &
+{
+    LogicalMatrix new_matrix( *this );
+    new_matrix &= other;
+    return new_matrix;
+}
+
+LogicalMatrix LogicalMatrix::operator &( const LogicalMatrix &other ) &&
+{
+    *this &= other;
+    return std::move( *this );
+}
+
+// AND assignment
+// DNF matrices are multiplied out, CNF matrices only gather the OR sets of both operands
+LogicalMatrix &LogicalMatrix::operator &=( const LogicalMatrix &other )
+{
+    return combine( other, true );
+}
+
+// &= when conjunction, otherwise |=
+// Statements gathered without multiplying stay untrimmed unless trimmed, for callers joining several matrices to trim them once
+LogicalMatrix &LogicalMatrix::combine( const LogicalMatrix &other, const bool &conjunction, const bool &trimmed )
+{
+    if( other.empty() )
+    {
+        return *this;
+    }
+
+    if( empty() )
+    {
+        adopt( other );
+    }
+    else
+    {
+        LogicalMatrix rebound, converted, stored;
+        const LogicalMatrix &formed = share_form( share_symbols( other, rebound ), converted );
+
+        if( current_storage == TermMajor )
+        { // statements are joined as literal lists, choose_storage() brings back the masks
+            make_sparse();
+        }
+
+        const LogicalMatrix &source = share_storage( formed, stored );
+
+        if( ( matrix_form == DNF ) == conjunction )
+        {
+            multiply( source, BitVector::npos );
+        }
+        else
+        {
+            concatenate( source, trimmed );
+        }
+    }
+
+    choose_storage();
+
+    if( minimize_automatically )
+    {
+        minimize();
+    }
+
+    return *this;
+}
+
+// Product of every statement of this with every statement of other
+// ((a & b) | (c & d)) & ((e & f) | (g & h)) = a & b & e & f | a & b & g & h | c & d & e & f | c & d & g & h
+// The product is generated one AND set at a time and trimmed whenever it reaches four times its last trimmed size,
+// so duplicate and absorbed AND sets never take more than a few times the room of the trimmed result
+// Both matrices must be non empty and share a SymbolTable, Logicalsizeexception is thrown once more than limit AND sets remain
+void LogicalMatrix::multiply( const LogicalMatrix &source, const size_t &limit )
+{
+    if( current_storage == Sparse )
+    {
+        multiply_sparse( source, limit );
+        return;
+    }
+
+    LogicalMatrix result;
+
+    size_t old_size = OR_matrix[ 0 ].size(),
+        other_size = source.OR_matrix[ 0 ].size(),
+        other_statements = source.statement_count(),
+        size = 0, capacity = 0, next_trim = 1024,
+        index, inner_index, statement, other_statement;
+    std::vector< size_t > positions = merge_identifiers( source, 0 );
+    Scratch< std::vector< uint32_t > > old_offsets, old_literals, other_offsets, other_literals, product;
+    std::vector< BitVector > old_term_statements = transpose( OR_matrix, old_size ),
+        other_term_statements = transpose( source.OR_matrix, other_size );
+
+    // literal 2 * k or 2 * k + 1 is the True or False column of AND_matrix[ k ]
+    list_literals( AND_matrix.read(), old_size, old_offsets, old_literals );
+    list_literals( source.AND_matrix.read(), other_size, other_offsets, other_literals, &positions );
+
+    // result holds a TruthTable for every identifier of this, in the same order
+    result.merge_identifiers( *this, 0 );
+    result.OR_matrix.assign( statement_count() * other_statements, BitVector() );
+
+    auto resize = [ &result ]( const size_t length )
+    {
+        for( TruthTable& table : result.AND_matrix.write() )
+        {
+            table.True.resize( length );
+            table.False.resize( length );
+        }
+
+        for( BitVector& statement : result.OR_matrix.write() )
+        {
+            statement.resize( length );
+        }
+    };
+
+    for( index = 0; index < old_size; ++index )
+    {
+        if( old_term_statements[ index ].none() )
+        {
+            continue;
+        }
+
+        for( inner_index = 0; inner_index < other_size; ++inner_index )
+        {
+            if( other_term_statements[ inner_index ].none() )
+            {
+                continue;
+            }
+
+            product.clear();
+            std::set_union( old_literals.begin() + old_offsets[ index ], old_literals.begin() + old_offsets[ index + 1 ],
+                other_literals.begin() + other_offsets[ inner_index ], other_literals.begin() + other_offsets[ inner_index + 1 ],
+                std::back_inserter( product ) );
+
+            if( size == capacity )
+            {
+                capacity = std::max< size_t >( 2 * capacity, BitVector::word_bits );
+                resize( capacity );
+            }
+
+            for( uint32_t const& literal : product )
+            {
+                TruthTable &table = result.AND_matrix.write()[ literal / 2 ];
+
+                ( ( literal & 1 )? table.False : table.True ).set( size );
+            }
+
+            // statement i of this and statement j of other make statement i * other_statements + j
+            for( statement = old_term_statements[ index ].find_first(); statement != BitVector::npos;
+                statement = old_term_statements[ index ].find_next( statement ) )
+            {
+                for( other_statement = other_term_statements[ inner_index ].find_first(); other_statement != BitVector::npos;
+                    other_statement = other_term_statements[ inner_index ].find_next( other_statement ) )
+                {
+                    result.OR_matrix.write()[ statement * other_statements + other_statement ].set( size );
+                }
+            }
+
+            if( ++size == next_trim )
+            {
+                resize( size );
+                result.trim();
+                size = capacity = result.OR_matrix[ 0 ].size();
+                next_trim = std::max( 4 * size, next_trim );
+
+                if( size > limit )
+                {
+                    throw Logicalsizeexception();
+                }
+
+                // TruthTables trimmed away are restored empty to keep literals aligned with AND_matrix
+                result.merge_identifiers( *this, size );
+            }
+        }
+    }
+
+    resize( size );
+
+    if( drop_contradictions )
+    { // a statement keeps AND sets holding both x and !x only when it has no other AND set
+        BitVector contradictory( size ), satisfiable;
+
+        for( TruthTable const& table : result.AND_matrix )
+        {
+            BitVector both = table.True;
+
+            contradictory |= ( both &= table.False );
+        }
+
+        for( BitVector& statement : result.OR_matrix.write() )
+        {
+            satisfiable = statement;
+
+            if( satisfiable.and_not( contradictory ).any() )
+            {
+                statement = std::move( satisfiable );
+            }
+        }
+    }
+
+    result.trim();
+
+    if( result.OR_matrix[ 0 ].size() > limit )
+    {
+        throw Logicalsizeexception();
+    }
+
+    AND_matrix = std::move( result.AND_matrix );
+    OR_matrix = std::move( result.OR_matrix );
+}
+
+// multiply() over literal lists, generating and trimming the product in the same order
+void LogicalMatrix::multiply_sparse( const LogicalMatrix &source, const size_t &limit )
+{
+    LogicalMatrix result;
+
+    size_t old_size = term_count(),
+        other_size = source.term_count(),
+        other_statements = source.statement_count(),
+        size = 0, next_trim = 1024,
+        index, inner_index;
+    std::vector< std::vector< uint32_t > > old_term_statements = sparse_term_statements(),
+        other_term_statements = source.sparse_term_statements(), product_statements( statement_count() * other_statements );
+
+    result.symbols = symbols;
+    result.requested_storage = Sparse;
+    result.make_sparse();
+
+    // the AND sets of each statement of the product move into result to be trimmed and back
+    auto gather = [ &result, &product_statements ]()
+    {
+        result.statement_offsets.assign( 1, 0 );
+        result.statement_terms.clear();
+
+        for( std::vector< uint32_t > const& terms : product_statements )
+        {
+            result.statement_terms.insert( result.statement_terms.end(), terms.begin(), terms.end() );
+            result.statement_offsets.push_back( result.statement_terms.size() );
+        }
+    };
+
+    for( index = 0; index < old_size; ++index )
+    {
+        if( old_term_statements[ index ].empty() )
+        {
+            continue;
+        }
+
+        for( inner_index = 0; inner_index < other_size; ++inner_index )
+        {
+            if( other_term_statements[ inner_index ].empty() )
+            {
+                continue;
+            }
+
+            std::set_union( term_literals.begin() + term_offsets[ index ], term_literals.begin() + term_offsets[ index + 1 ],
+                source.term_literals.begin() + source.term_offsets[ inner_index ], source.term_literals.begin() + source.term_offsets[ inner_index + 1 ],
+                std::back_inserter( result.term_literals ) );
+            result.term_offsets.push_back( result.term_literals.size() );
+
+            // statement i of this and statement j of other make statement i * other_statements + j
+            for( uint32_t const& statement : old_term_statements[ index ] )
+            {
+                for( uint32_t const& other_statement : other_term_statements[ inner_index ] )
+                {
+                    product_statements[ statement * other_statements + other_statement ].push_back( size );
+                }
+            }
+
+            if( ++size == next_trim )
+            {
+                gather();
+                result.trim();
+                size = result.term_count();
+                next_trim = std::max( 4 * size, next_trim );
+
+                if( size > limit )
+                {
+                    throw Logicalsizeexception();
+                }
+
+                for( size_t statement = 0; statement < product_statements.size(); ++statement )
+                {
+                    product_statements[ statement ].assign( result.statement_terms.begin() + result.statement_offsets[ statement ],
+                        result.statement_terms.begin() + result.statement_offsets[ statement + 1 ] );
+                }
+            }
+        }
+    }
+
+    if( drop_contradictions )
+    { // a statement keeps AND sets holding both x and !x only when it has no other AND set
+        auto contradictory_term = [ &result ]( const uint32_t term )
+        {
+            return std::adjacent_find( result.term_literals.begin() + result.term_offsets[ term ], result.term_literals.begin() + result.term_offsets[ term + 1 ],
+                []( const uint32_t left, const uint32_t right ){ return ( left ^ 1 ) == right; } ) != result.term_literals.begin() + result.term_offsets[ term + 1 ];
+        };
+
+        for( std::vector< uint32_t >& terms : product_statements )
+        {
+            if( !std::all_of( terms.begin(), terms.end(), contradictory_term ) )
+            {
+                filter_vector( terms, [ &contradictory_term ]( const uint32_t term ){ return !contradictory_term( term ); } );
+            }
+        }
+    }
+
+    gather();
+    result.trim();
+
+    if( result.term_count() > limit )
+    {
+        throw Logicalsizeexception();
+    }
+
+    term_offsets = std::move( result.term_offsets );
+    term_literals = std::move( result.term_literals );
+    statement_offsets = std::move( result.statement_offsets );
+    statement_terms = std::move( result.statement_terms );
+}
+
+LogicalMatrix &LogicalMatrix::AND( const LogicalMatrix &other )
+{
+    *this &= other;
+    return *this;
+}
+
+LogicalMatrix &LogicalMatrix::AND( const LogicalMatrix &other, const size_t &statement_index )
+{
+    if( other.empty() | statement_index >= statement_count() )
+    {
+        return *this;
+    }
+
+    LogicalMatrix temp_matrix = isolate_statement( statement_index ) & other;
+
+    erase_statement( statement_index );
+
+    return ADD( temp_matrix, statement_index );
+}
+
+// OR yealding a new object
+LogicalMatrix LogicalMatrix::operator |( const LogicalMatrix &other ) const &
+{
+    LogicalMatrix new_matrix( *this );
+    new_matrix |= other;
+    return new_matrix;
+}
+
+LogicalMatrix LogicalMatrix::operator |( const LogicalMatrix &other ) &&
+{
+    *this |= other;
+    return std::move( *this );
+}
+
+// OR assignment
+// DNF matrices only gather the AND sets of both operands, CNF matrices are multiplied out
+LogicalMatrix &LogicalMatrix::operator |=( const LogicalMatrix &other )
+{
+    return combine( other, false );
+}
+
+// every statement of this joined with every statement of other, trimmed unless trimmed is false
+// Both matrices must be non empty and share a SymbolTable
+void LogicalMatrix::concatenate( const LogicalMatrix &source, const bool &trimmed )
+{
+    if( current_storage == Sparse )
+    {
+        concatenate_sparse( source, trimmed );
+        return;
+    }
+
+    extend_matrix( source );
+
+    std::vector< BitVector > temp_OR_vector;
+
+    temp_OR_vector.reserve( source.statement_count() * statement_count() );
+
+    for( BitVector const& statement : OR_matrix )
+    {
+        for( BitVector const& other_statement : source.OR_matrix )
+        {
+            temp_OR_vector.push_back( statement );
+            temp_OR_vector.back().append( other_statement );
+        }
+    }
+
+    OR_matrix = temp_OR_vector;
+
+    if( trimmed )
+    {
+        trim();
+    }
+}
+
+// concatenate() over literal lists
+void LogicalMatrix::concatenate_sparse( const LogicalMatrix &source, const bool &trimmed )
+{
+    size_t old_size = term_count(), literal_base = term_literals.size(), statement, other_statement;
+    std::vector< uint32_t > offsets( 1, 0 ), terms;
+
+    for( size_t index = 1; index < source.term_offsets.size(); ++index )
+    {
+        term_offsets.push_back( literal_base + source.term_offsets[ index ] );
+    }
+
+    term_literals.insert( term_literals.end(), source.term_literals.begin(), source.term_literals.end() );
+    terms.reserve( statement_terms.size() * source.statement_count() + source.statement_terms.size() * statement_count() );
+
+    for( statement = 0; statement < statement_count(); ++statement )
+    {
+        for( other_statement = 0; other_statement < source.statement_count(); ++other_statement )
+        {
+            terms.insert( terms.end(), statement_terms.begin() + statement_offsets[ statement ], statement_terms.begin() + statement_offsets[ statement + 1 ] );
+
+            for( size_t position = source.statement_offsets[ other_statement ]; position < source.statement_offsets[ other_statement + 1 ]; ++position )
+            {
+                terms.push_back( old_size + source.statement_terms[ position ] );
+            }
+
+            offsets.push_back( terms.size() );
+        }
+    }
+
+    statement_offsets = std::move( offsets );
+    statement_terms = std::move( terms );
+
+    if( trimmed )
+    {
+        trim();
+    }
+}
+
+LogicalMatrix &LogicalMatrix::OR( const LogicalMatrix &other )
+{
+    *this |= other;
+    return *this;
+}
+
+LogicalMatrix &LogicalMatrix::OR( const LogicalMatrix &other, const size_t &statement_index )
+{
+    if( other.empty() | statement_index >= statement_count() )
+    {
+        return *this;
+    }
+
+    LogicalMatrix temp_matrix = isolate_statement( statement_index ) | other;
+
+    erase_statement( statement_index );
+
+    return ADD( temp_matrix, statement_index );
+}
+
+LogicalMatrix LogicalMatrix::operator +( const LogicalMatrix &other ) const &
+{
+    LogicalMatrix new_matrix( *this );
+    new_matrix.ADD( other );
+    return new_matrix;
+}
+
+LogicalMatrix LogicalMatrix::operator +( const LogicalMatrix &other ) &&
+{
+    ADD( other );
+    return std::move( *this );
+}
+
+LogicalMatrix &LogicalMatrix::operator +=( const LogicalMatrix &other )
+{
+    return ADD( other );
+}
+
+LogicalMatrix &LogicalMatrix::ADD( const LogicalMatrix &other, const size_t &statement_index )
+{
+    if( other.empty() )
+    {
+        return *this;
+    }
+
+    if( statement_count() == 0 )
+    {
+        adopt( other );
+        choose_storage();
+        return *this;
+    }
+
+    LogicalMatrix rebound, converted, stored;
+    const LogicalMatrix &source = share_storage( share_form( share_symbols( other, rebound ), converted ), stored );
+
+    if( current_storage != Dense )
+    {
+        insert_statements( source, statement_index );
+    }
+    else
+    {
+        extend_matrix( source );
+
+        size_t depth = statement_count(),
+            old_size = OR_matrix[ 0 ].size(),
+            other_size = source.OR_matrix[ 0 ].size();
+        size_t index, newsize = old_size + other_size;
+
+        OR_matrix.reserve( statement_count() + source.statement_count() );
+
+        for( BitVector& statement : OR_matrix.write() )
+        {
+            statement.resize( newsize );
+        }
+
+        index = ( statement_index < depth )? statement_index : depth;
+
+        for( auto const& statement : source.OR_matrix )
+        {
+            OR_matrix.insert( OR_matrix.begin() + index, BitVector( old_size ) );
+            OR_matrix.write()[ index++ ].append( statement );
+        }
+    }
+
+    trim();
+    choose_storage();
+
+    if( minimize_automatically )
+    {
+        minimize();
+    }
+
+    return *this;
+}
+
+bool LogicalMatrix::operator ==( const LogicalMatrix &other ) const
+{
+    if( matrix_form != other.matrix_form )
+    { // matrices of one form compare as they are
+        return to_DNF() == other.to_DNF();
+    }
+
+    if( current_storage == Sparse && other.current_storage == Sparse && symbols == other.symbols )
+    {
+        return term_offsets == other.term_offsets && term_literals == other.term_literals &&
+            statement_offsets == other.statement_offsets && statement_terms == other.statement_terms;
+    }
+
+    if( current_storage != Dense || other.current_storage != Dense )
+    {
+        return dense_copy() == other.dense_copy();
+    }
+
+    if( identifier_count() != other.identifier_count() || OR_matrix != other.OR_matrix )
+    {
+        return false;
+    }
+
+    size_t index;
+
+    if( symbols == other.symbols )
+    { // identifiers can be compared by id alone
+        for( index = 0; index < AND_matrix.size(); ++index )
+        {
+            if( AND_matrix[ index ].identifier != other.AND_matrix[ index ].identifier || !( AND_matrix[ index ] == other.AND_matrix[ index ] ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector< size_t > order = ordered_identifiers(), other_order = other.ordered_identifiers();
+
+    for( index = 0; index < order.size(); ++index )
+    {
+        const TruthTable &table = AND_matrix[ order[ index ] ], &other_table = other.AND_matrix[ other_order[ index ] ];
+
+        if( name( table ) != other.name( other_table ) || !( table == other_table ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// orders by identifier name, then TruthTable, then OR_matrix
+bool LogicalMatrix::operator <( const LogicalMatrix &other ) const
+{
+    if( matrix_form != other.matrix_form )
+    { // matrices of one form compare as they are
+        return to_DNF() < other.to_DNF();
+    }
+
+    if( current_storage != Dense || other.current_storage != Dense )
+    {
+        return dense_copy() < other.dense_copy();
+    }
+
+    std::vector< size_t > order = ordered_identifiers(), other_order = other.ordered_identifiers();
+
+    for( size_t index = 0; index < order.size() && index < other_order.size(); ++index )
+    {
+        const TruthTable &table = AND_matrix[ order[ index ] ], &other_table = other.AND_matrix[ other_order[ index ] ];
+        int comparison = name( table ).compare( other.name( other_table ) );
+
+        if( comparison != 0 )
+        {
+            return comparison < 0;
+        }
+
+        if( !( table == other_table ) )
+        {
+            return table < other_table;
+        }
+    }
+
+    if( order.size() != other_order.size() )
+    {
+        return order.size() < other_order.size();
+    }
+
+    return OR_matrix < other.OR_matrix;
+}
+
+// the identifiers of the AND sets, or of the OR sets of a CNF matrix
+size_t LogicalMatrix::identifier_count() const
+{
+    return ( current_storage == Dense )? AND_matrix.size() : sparse_identifiers().size();
+}
+
+size_t LogicalMatrix::statement_count() const
+{
+    return ( current_storage == Dense )? OR_matrix.size() : statement_offsets.size() - 1;
+}
+
+bool LogicalMatrix::empty() const
+{
+    if( current_storage == TermMajor )
+    {
+        return std::all_of( term_positive.begin(), term_positive.end(), []( const BitVector &mask ){ return mask.none(); } ) &&
+            std::all_of( term_negative.begin(), term_negative.end(), []( const BitVector &mask ){ return mask.none(); } );
+    }
+
+    return ( current_storage == Dense )? AND_matrix.empty() : term_literals.empty();
+}
+
+// a cleared matrix is sparse or term-major only when that storage was requested
+void LogicalMatrix::clear()
+{
+    AND_matrix.clear();
+    OR_matrix.clear();
+    term_literals.clear();
+    statement_terms.clear();
+    term_positive.clear();
+    term_negative.clear();
+    current_storage = ( requested_storage == Sparse || requested_storage == TermMajor )? requested_storage : Dense;
+    term_offsets.assign( current_storage == Sparse, 0 );
+    statement_offsets.assign( current_storage != Dense, 0 );
+    matrix_form = DNF;
+}
+
+void LogicalMatrix::set_drop_contradictions( const bool &enabled )
+{
+    drop_contradictions = enabled;
+}
+
+bool LogicalMatrix::drops_contradictions() const
+{
+    return drop_contradictions;
+}
+
+LogicalMatrix::Form LogicalMatrix::form() const
+{
+    return matrix_form;
+}
+
+// Expansion of a CNF matrix
+// Each statement is the product of its OR sets, multiplied out in order and added to the result one statement at a time
+LogicalMatrix LogicalMatrix::to_DNF() const
+{
+    if( matrix_form == DNF || empty() )
+    {
+        LogicalMatrix result_matrix( *this );
+
+        result_matrix.matrix_form = DNF;
+        return result_matrix;
+    }
+
+    if( current_storage != Dense )
+    {
+        return dense_copy().to_DNF();
+    }
+
+    size_t index, old_size = OR_matrix[ 0 ].size();
+    std::vector< size_t > order = ordered_identifiers();
+    std::vector< LogicalMatrix > clauses( old_size );
+    LogicalMatrix result_matrix, cumulative_AND;
+
+    for( index = 0; index < old_size; ++index )
+    {
+        clauses[ index ] = build_clause( index, order );
+    }
+
+    result_matrix.drop_contradictions = cumulative_AND.drop_contradictions = drop_contradictions;
+    result_matrix.DNF_limit = cumulative_AND.DNF_limit = DNF_limit;
+
+    for( BitVector const& statement : OR_matrix )
+    {
+        for( index = statement.find_first(); index != BitVector::npos; index = statement.find_next( index ) )
+        {
+            if( cumulative_AND.empty() )
+            {
+                cumulative_AND.adopt( clauses[ index ] );
+            }
+            else
+            {
+                cumulative_AND.multiply( clauses[ index ], DNF_limit );
+            }
+        }
+
+        result_matrix += cumulative_AND;
+        cumulative_AND.clear();
+
+        if( result_matrix.term_count() > DNF_limit )
+        {
+            throw Logicalsizeexception();
+        }
+    }
+
+    result_matrix.requested_storage = requested_storage;
+    result_matrix.choose_storage();
+
+    return result_matrix;
+}
+
+// The CNF form of a DNF matrix, the expansion of its negation negated back
+// A CNF matrix is returned as it is
+LogicalMatrix LogicalMatrix::to_CNF() const
+{
+    if( matrix_form == CNF || empty() )
+    {
+        LogicalMatrix result_matrix( *this );
+
+        result_matrix.matrix_form = CNF;
+        return result_matrix;
+    }
+
+    return !( !*this ).to_DNF();
+}
+
+void LogicalMatrix::set_conversion_limit( const size_t &limit )
+{
+    DNF_limit = limit;
+}
+
+size_t LogicalMatrix::conversion_limit() const
+{
+    return DNF_limit;
+}
+
+// when enabled, &, |, +, ! and NOT minimize their result in Automatic mode
+void LogicalMatrix::set_auto_minimize( const bool &enabled )
+{
+    minimize_automatically = enabled;
+}
+
+bool LogicalMatrix::auto_minimizes() const
+{
+    return minimize_automatically;
+}
+
+std::vector< bool > LogicalMatrix::evaluate( const std::map< std::string, bool > &identifiers ) const
+{
+    if( empty() )
+    {
+        return {};
+    }
+
+    size_t index, size = term_count(), depth = statement_count();
+    BitVector truth_table( size, true );
+    std::vector< bool > result( depth, false );
+
+    if( current_storage == TermMajor )
+    { // the identifiers known to be true and known to be false, as wide as the masks
+        size_t width = term_positive[ 0 ].size();
+        BitVector known_true( width ), known_false( width );
+
+        for( auto const& identifier : identifiers )
+        {
+            SymbolTable::id_type id = symbols->find( identifier.first );
+
+            if( id < width )
+            {
+                ( identifier.second? known_true : known_false ).set( id );
+            }
+        }
+
+        // in DNF an AND set holds when its positive identifiers are true and its negative ones false, in CNF an OR set when one is
+        for( index = 0; index < size; ++index )
+        {
+            truth_table.set( index, ( matrix_form == CNF )?
+                term_positive[ index ].intersects( known_true ) || term_negative[ index ].intersects( known_false ) :
+                term_positive[ index ].is_subset_of( known_true ) && term_negative[ index ].is_subset_of( known_false ) );
+        }
+    }
+    else if( current_storage == Sparse )
+    { // the value of each known identifier by id, -1 for identifiers missing from identifiers
+        std::vector< int8_t > values( symbols->size(), -1 );
+
+        for( auto const& identifier : identifiers )
+        {
+            SymbolTable::id_type id = symbols->find( identifier.first );
+
+            if( id != SymbolTable::npos )
+            {
+                values[ id ] = identifier.second;
+            }
+        }
+
+        // in DNF an AND set holds when each of its literals is known and true, in CNF an OR set when one of them is
+        for( index = 0; index < size; ++index )
+        {
+            auto holds = [ &values ]( const uint32_t literal ){ return values[ literal / 2 ] == !( literal & 1 ); };
+            auto begin = term_literals.begin() + term_offsets[ index ], end = term_literals.begin() + term_offsets[ index + 1 ];
+
+            truth_table.set( index, ( matrix_form == CNF )? std::any_of( begin, end, holds ) : std::all_of( begin, end, holds ) );
+        }
+    }
+
+    if( current_storage != Dense )
+    {
+        for( index = 0; index < depth; ++index )
+        {
+            auto begin = statement_terms.begin() + statement_offsets[ index ], end = statement_terms.begin() + statement_offsets[ index + 1 ];
+            auto holds = [ &truth_table ]( const uint32_t term ){ return truth_table[ term ]; };
+
+            result[ index ] = ( matrix_form == CNF )? std::all_of( begin, end, holds ) : std::any_of( begin, end, holds );
+        }
+
+        return result;
+    }
+
+    if( matrix_form == CNF )
+    { // an OR set holds when one of its literals is known and true, a statement when all of its OR sets hold
+        truth_table.reset();
+
+        for( TruthTable const& data : AND_matrix )
+        {
+            auto identifier = identifiers.find( name( data ) );
+
+            if( identifier != identifiers.end() )
+            {
+                truth_table |= identifier->second? data.True : data.False;
+            }
+        }
+
+        for( index = 0; index < depth; ++index )
+        {
+            result[ index ] = OR_matrix[ index ].is_subset_of( truth_table );
+        }
+
+        return result;
+    }
+
+    for( TruthTable const& data : AND_matrix )
+    {
+        auto identifier = identifiers.find( name( data ) );
+
+        if( identifier == identifiers.end() )
+        { // keys found in this and not identifiers with are evaluated as FALSE regardless of data
+            truth_table.and_not( data.True );
+            truth_table.and_not( data.False );
+        }
+        else
+        { // keys found in both this and identifiers are evaluated based on their value in identifiers
+            truth_table.and_not( identifier->second? data.False : data.True );
+        }
+    }
+
+    for( index = 0; index < depth; ++index )
+    {
+        result[ index ] = truth_table.intersects( OR_matrix[ index ] );
+    }
+
+    return result;
+}
+
+// flattens this for repeated evaluation, see CompiledMatrix
+CompiledMatrix LogicalMatrix::compile() const
+{
+    return CompiledMatrix( *this );
+}
+
+FrozenMatrix LogicalMatrix::freeze() const
+{
+    return FrozenMatrix( *this );
+}
+
+StatementView LogicalMatrix::statement( const size_t &statement_index ) const
+{
+    return StatementView( *this, statement_index );
+}
+
+bool LogicalMatrix::remove_statement( const size_t &remove_index )
+{
+    if( remove_index < statement_count() )
+    {
+        erase_statement( remove_index );
+        trim();
+        choose_storage();
+
+        return true;
+    }
+
+    return false;
+}
+
+LogicalMatrix LogicalMatrix::isolate_statement( const size_t &statement_index ) const
+{
+    LogicalMatrix result;
+
+    if( statement_index < statement_count() )
+    {
+        result.symbols = symbols;
+        result.matrix_form = matrix_form;
+        result.drop_contradictions = drop_contradictions;
+        result.DNF_limit = DNF_limit;
+        result.requested_storage = requested_storage;
+
+        if( current_storage != Dense )
+        { // only the AND sets of the statement are copied, in order
+            std::vector< uint32_t > literals;
+
+            result.make_sparse();
+
+            for( size_t position = statement_offsets[ statement_index ]; position < statement_offsets[ statement_index + 1 ]; ++position )
+            {
+                list_term( statement_terms[ position ], literals );
+                result.term_literals.insert( result.term_literals.end(), literals.begin(), literals.end() );
+                result.term_offsets.push_back( result.term_literals.size() );
+                result.statement_terms.push_back( result.statement_terms.size() );
+            }
+
+            result.statement_offsets.push_back( result.statement_terms.size() );
+        }
+        else
+        { // only the columns of identifiers in the statement are copied, narrowed to its AND sets
+            const BitVector &row = OR_matrix[ statement_index ];
+
+            for( TruthTable const& table : AND_matrix )
+            {
+                if( table.True.intersects( row ) || table.False.intersects( row ) )
+                {
+                    result.AND_matrix.emplace_back( table.identifier );
+                    result.AND_matrix.write().back().True = table.True.compact( row );
+                    result.AND_matrix.write().back().False = table.False.compact( row );
+                }
+            }
+
+            result.OR_matrix.emplace_back( row.count(), true );
+        }
+
+        result.trim();
+        result.choose_storage();
+    }
+
+    return result;
+}
+
+// Dense storage is listed once so each statement copies only its own AND sets instead of narrowing every column
+std::vector< LogicalMatrix > LogicalMatrix::split_statements() const
+{
+    size_t index, depth = statement_count();
+
+    if( current_storage == Dense && depth > 1 )
+    {
+        LogicalMatrix listed( *this );
+
+        listed.make_sparse();
+        return listed.split_statements();
+    }
+
+    std::vector< LogicalMatrix > result = std::vector< LogicalMatrix >( depth );
+
+    for( index = 0; index < depth; ++index )
+    {
+        result[ index ] = isolate_statement( index );
+    }
+
+    return result;
+}
+
+void LogicalMatrix::combine_statements()
+{
+    if( statement_count() > 1 )
+    {
+        std::vector< LogicalMatrix > split_vector = split_statements();
+
+        clear();
+
+        for( auto const& individual_LM : split_vector )
+        {
+            *this &= individual_LM;
+        }
+    }
+}
+
+// sorted literals of one AND set, 2 * k or 2 * k + 1 for the True or False column of AND_matrix[ k ]
+typedef std::vector< uint32_t > Cube;
+
+// statements over more identifiers than these are minimized heuristically in Exact and Automatic mode
+static const size_t exact_identifier_limit = 12, automatic_identifier_limit = 8;
+static const size_t heuristic_passes = 16, cover_search_nodes = 1 << 16;
+
+static inline bool contradictory( const Cube &cube )
+{
+    return std::adjacent_find( cube.begin(), cube.end(), []( const uint32_t left, const uint32_t right )
+    {
+        return ( left ^ 1 ) == right;
+    } ) != cube.end();
+}
+
+// a statement that always holds is kept as x | !x
+static inline std::vector< Cube > tautology( const uint32_t literal )
+{
+    return { { literal & ~1u }, { literal | 1u } };
+}
+
+// drops repeated AND sets, keeping the first of each
+static void unique_cubes( std::vector< Cube > &cubes )
+{
+    std::set< Cube > seen;
+
+    filter_vector( cubes, [ &seen ]( const Cube &cube )
+    {
+        return seen.insert( cube ).second;
+    } );
+}
+
+// Espresso style expansion limited to single AND set containment
+// literal x is dropped from an AND set when another AND set holds !x and otherwise only literals of the first,
+// so a & b | a & !b merges into a and a | !a & b reduces to a | b, for at most heuristic_passes passes
+static std::vector< Cube > minimize_heuristic( const std::vector< Cube > &input )
+{
+    std::vector< Cube > cubes;
+    std::map< uint32_t, std::vector< size_t > > holding;
+    size_t index, position, pass;
+    bool changed = true;
+
+    for( Cube const& cube : input )
+    {
+        if( !contradictory( cube ) )
+        {
+            cubes.push_back( cube );
+        }
+    }
+
+    if( cubes.empty() )
+    { // every AND set is FALSE, one of them stands for the statement
+        return { input.front() };
+    }
+
+    // whether cover holds the complement of literal and no literal outside of cube
+    auto reduces = []( const Cube &cover, const Cube &cube, const uint32_t literal )
+    {
+        bool complement = false;
+
+        for( uint32_t const& value : cover )
+        {
+            if( value == ( literal ^ 1 ) )
+            {
+                complement = true;
+            }
+            else if( value == literal || !std::binary_search( cube.begin(), cube.end(), value ) )
+            {
+                return false;
+            }
+        }
+
+        return complement;
+    };
+
+    for( pass = 0; changed && pass < heuristic_passes; ++pass )
+    {
+        changed = false;
+        unique_cubes( cubes );
+        holding.clear();
+
+        for( index = 0; index < cubes.size(); ++index )
+        {
+            for( uint32_t const& literal : cubes[ index ] )
+            {
+                holding[ literal ].push_back( index );
+            }
+        }
+
+        for( index = 0; index < cubes.size(); ++index )
+        {
+            for( position = 0; position < cubes[ index ].size(); )
+            {
+                uint32_t literal = cubes[ index ][ position ];
+                auto found = holding.find( literal ^ 1 );
+                bool reduced = false;
+
+                for( size_t cover = 0; found != holding.end() && cover < found->second.size() && !reduced; ++cover )
+                {
+                    reduced = found->second[ cover ] != index && reduces( cubes[ found->second[ cover ] ], cubes[ index ], literal );
+                }
+
+                if( !reduced )
+                {
+                    ++position;
+                    continue;
+                }
+
+                cubes[ index ].erase( cubes[ index ].begin() + position );
+                changed = true;
+
+                if( cubes[ index ].empty() )
+                {
+                    return tautology( literal );
+                }
+            }
+        }
+    }
+
+    unique_cubes( cubes );
+    return cubes;
+}
+
+// Quine McCluskey over the identifiers of the statement, an implicant being a care and a value mask over them,
+// followed by a branch and bound search for the fewest prime implicants covering every minterm, then the fewest literals
+// The search keeps the best cover found within cover_search_nodes nodes
+static std::vector< Cube > minimize_exact( const std::vector< Cube > &input )
+{
+    std::vector< uint32_t > variables, minterms, chosen, best;
+    std::vector< std::pair< uint32_t, uint32_t > > primes;
+    std::vector< BitVector > covers;
+    std::vector< std::vector< uint32_t > > covering;
+    std::vector< Cube > result;
+    size_t index, nodes = 0, best_literals = 0;
+
+    for( Cube const& cube : input )
+    {
+        for( uint32_t const& literal : cube )
+        {
+            variables.push_back( literal / 2 );
+        }
+    }
+
+    std::sort( variables.begin(), variables.end() );
+    variables.erase( std::unique( variables.begin(), variables.end() ), variables.end() );
+
+    const uint32_t full = ( 1u << variables.size() ) - 1;
+    std::vector< uint32_t > minterm_position( size_t( full ) + 1, -1 );
+
+    auto for_each_minterm = []( const uint32_t care, const uint32_t value, const uint32_t full, auto function )
+    {
+        uint32_t free = full & ~care;
+
+        for( uint32_t subset = free; ; subset = ( subset - 1 ) & free )
+        {
+            function( value | subset );
+
+            if( subset == 0 )
+            {
+                break;
+            }
+        }
+    };
+
+    for( Cube const& cube : input )
+    {
+        uint32_t care = 0, value = 0;
+
+        if( contradictory( cube ) )
+        {
+            continue;
+        }
+
+        for( uint32_t const& literal : cube )
+        {
+            uint32_t bit = 1u << ( std::lower_bound( variables.begin(), variables.end(), literal / 2 ) - variables.begin() );
+
+            care |= bit;
+            value |= ( literal & 1 )? 0 : bit;
+        }
+
+        for_each_minterm( care, value, full, [ & ]( const uint32_t minterm )
+        {
+            if( minterm_position[ minterm ] == uint32_t( -1 ) )
+            {
+                minterm_position[ minterm ] = minterms.size();
+                minterms.push_back( minterm );
+            }
+        } );
+    }
+
+    if( minterms.empty() )
+    { // every AND set is FALSE, one of them stands for the statement
+        return { input.front() };
+    }
+
+    if( minterms.size() == size_t( full ) + 1 )
+    {
+        return tautology( 2 * variables.front() );
+    }
+
+    // implicants are merged one care bit at a time, those never merged are prime
+    // membership of an implicant of the current level and whether it merged are bits at care * ( full + 1 ) + value
+    const size_t masks = size_t( full ) + 1;
+    std::vector< std::pair< uint32_t, uint32_t > > current, next;
+    BitVector in_current( masks * masks ), in_next( masks * masks ), merged( masks * masks );
+
+    for( uint32_t const& minterm : minterms )
+    {
+        current.emplace_back( full, minterm );
+        in_current.set( full * masks + minterm );
+    }
+
+    while( !current.empty() )
+    {
+        next.clear();
+
+        for( auto const& implicant : current )
+        {
+            for( uint32_t bits = implicant.first & ~implicant.second; bits != 0; bits &= bits - 1 )
+            {
+                uint32_t bit = bits & ( ~bits + 1 );
+
+                if( in_current[ implicant.first * masks + ( implicant.second | bit ) ] )
+                {
+                    if( !in_next[ ( implicant.first & ~bit ) * masks + implicant.second ] )
+                    {
+                        in_next.set( ( implicant.first & ~bit ) * masks + implicant.second );
+                        next.emplace_back( implicant.first & ~bit, implicant.second );
+                    }
+
+                    merged.set( implicant.first * masks + implicant.second );
+                    merged.set( implicant.first * masks + ( implicant.second | bit ) );
+                }
+            }
+        }
+
+        for( auto const& implicant : current )
+        {
+            if( !merged[ implicant.first * masks + implicant.second ] )
+            {
+                primes.push_back( implicant );
+            }
+
+            in_current.reset( implicant.first * masks + implicant.second );
+        }
+
+        current.swap( next );
+        std::swap( in_current, in_next );
+    }
+
+    covering.resize( minterms.size() );
+
+    for( index = 0; index < primes.size(); ++index )
+    {
+        covers.emplace_back( minterms.size() );
+
+        for_each_minterm( primes[ index ].first, primes[ index ].second, full, [ & ]( const uint32_t minterm )
+        {
+            covers.back().set( minterm_position[ minterm ] );
+            covering[ minterm_position[ minterm ] ].push_back( index );
+        } );
+    }
+
+    auto literal_cost = [ &primes ]( const uint32_t prime ) -> size_t
+    {
+        return __builtin_popcount( primes[ prime ].first );
+    };
+
+    // branches on the primes covering the uncovered minterm with the fewest of them
+    auto search = [ & ]( auto &self, const BitVector &uncovered, const size_t literals ) -> void
+    {
+        if( uncovered.none() )
+        {
+            if( best.empty() || chosen.size() < best.size() || ( chosen.size() == best.size() && literals < best_literals ) )
+            {
+                best = chosen;
+                best_literals = literals;
+            }
+
+            return;
+        }
+
+        if( chosen.size() + 1 > best.size() || ++nodes > cover_search_nodes )
+        {
+            return;
+        }
+
+        size_t pick = uncovered.find_first();
+
+        for( size_t minterm = uncovered.find_next( pick ); minterm != BitVector::npos; minterm = uncovered.find_next( minterm ) )
+        {
+            if( covering[ minterm ].size() < covering[ pick ].size() )
+            {
+                pick = minterm;
+            }
+        }
+
+        for( uint32_t const& prime : covering[ pick ] )
+        {
+            BitVector remaining( uncovered );
+
+            chosen.push_back( prime );
+            self( self, remaining.and_not( covers[ prime ] ), literals + literal_cost( prime ) );
+            chosen.pop_back();
+        }
+    };
+
+    // primes alone in covering a minterm are essential, the rest start from a greedy cover which bounds the search
+    BitVector uncovered( minterms.size(), true );
+
+    for( index = 0; index < minterms.size(); ++index )
+    {
+        if( covering[ index ].size() == 1 && uncovered[ index ] )
+        {
+            chosen.push_back( covering[ index ].front() );
+            best_literals += literal_cost( chosen.back() );
+            uncovered.and_not( covers[ chosen.back() ] );
+        }
+    }
+
+    const size_t essential = chosen.size(), essential_literals = best_literals;
+
+    best = chosen;
+
+    for( BitVector remaining( uncovered ); remaining.any(); )
+    {
+        size_t pick = 0, pick_count = 0;
+
+        for( index = 0; index < primes.size(); ++index )
+        {
+            BitVector covered( covers[ index ] );
+            size_t count = ( covered &= remaining ).count();
+
+            if( count > pick_count || ( count == pick_count && count != 0 && literal_cost( index ) < literal_cost( pick ) ) )
+            {
+                pick = index;
+                pick_count = count;
+            }
+        }
+
+        best.push_back( pick );
+        best_literals += literal_cost( pick );
+        remaining.and_not( covers[ pick ] );
+    }
+
+    search( search, uncovered, essential_literals );
+    chosen.resize( essential );
+
+    for( uint32_t const& prime : best )
+    {
+        result.emplace_back();
+
+        for( index = 0; index < variables.size(); ++index )
+        {
+            if( ( primes[ prime ].first >> index ) & 1 )
+            {
+                result.back().push_back( 2 * variables[ index ] + ( ( ( primes[ prime ].second >> index ) & 1 )? 0 : 1 ) );
+            }
+        }
+    }
+
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+// Two level minimization of every statement
+// Statements are rebuilt from their minimized AND sets, in CNF the same steps minimize the OR sets
+// The result is equivalent for every assignment of all identifiers, identifiers left out of evaluate may then differ
+void LogicalMatrix::minimize( const Minimization &mode )
+{
+    if( empty() || statement_count() == 0 )
+    {
+        return;
+    }
+
+    make_dense(); // minimization rewrites the columns of each identifier
+
+    size_t index, statement, size = OR_matrix[ 0 ].size();
+    std::vector< uint32_t > offsets, literals, identifiers;
+    std::vector< std::vector< Cube > > statements( statement_count() );
+    std::map< Cube, size_t > positions;
+
+    list_literals( AND_matrix.read(), size, offsets, literals );
+
+    for( statement = 0; statement < statement_count(); ++statement )
+    {
+        std::vector< Cube > cubes;
+
+        identifiers.clear();
+
+        for( index = OR_matrix[ statement ].find_first(); index != BitVector::npos; index = OR_matrix[ statement ].find_next( index ) )
+        {
+            cubes.emplace_back( literals.begin() + offsets[ index ], literals.begin() + offsets[ index + 1 ] );
+
+            for( uint32_t const& literal : cubes.back() )
+            {
+                identifiers.push_back( literal / 2 );
+            }
+        }
+
+        if( cubes.empty() )
+        {
+            continue;
+        }
+
+        std::sort( identifiers.begin(), identifiers.end() );
+        size_t count = std::unique( identifiers.begin(), identifiers.end() ) - identifiers.begin();
+
+        if( mode == Heuristic || count > ( ( mode == Exact )? exact_identifier_limit : automatic_identifier_limit ) )
+        {
+            statements[ statement ] = minimize_heuristic( cubes );
+        }
+        else
+        {
+            statements[ statement ] = minimize_exact( cubes );
+        }
+
+        for( Cube const& cube : statements[ statement ] )
+        {
+            positions.emplace( cube, positions.size() );
+        }
+    }
+
+    for( TruthTable& table : AND_matrix.write() )
+    {
+        table.True = BitVector( positions.size() );
+        table.False = BitVector( positions.size() );
+    }
+
+    for( auto const& position : positions )
+    {
+        for( uint32_t const& literal : position.first )
+        {
+            TruthTable &table = AND_matrix.write()[ literal / 2 ];
+
+            ( ( literal & 1 )? table.False : table.True ).set( position.second );
+        }
+    }
+
+    for( statement = 0; statement < statement_count(); ++statement )
+    {
+        OR_matrix.write()[ statement ] = BitVector( positions.size() );
+
+        for( Cube const& cube : statements[ statement ] )
+        {
+            OR_matrix.write()[ statement ].set( positions[ cube ] );
+        }
+    }
+
+    trim();
+    choose_storage();
+}
+
+// every OR set, or unit literal of assumptions, holds under one assignment
+// DPLL with two watched literals per OR set and chronological backtracking over literals id * 2 + negated
+static bool satisfiable_clauses( std::vector< Cube > clauses, const Cube &assumptions )
+{
+    uint32_t variables = 0;
+    size_t head = 0, next = 0, index;
+
+    for( Cube const& clause : clauses )
+    {
+        for( uint32_t const& literal : clause )
+        {
+            variables = std::max( variables, literal / 2 + 1 );
+        }
+    }
+
+    for( uint32_t const& literal : assumptions )
+    {
+        variables = std::max( variables, literal / 2 + 1 );
+    }
+
+    // values are -1 while unassigned, the trail lists the literals made TRUE in order with decisions marked by position
+    std::vector< int8_t > values( variables, -1 );
+    std::vector< bool > used( variables, false ), flipped;
+    std::vector< std::vector< uint32_t > > watches( 2 * size_t( variables ) );
+    std::vector< uint32_t > trail;
+    std::vector< size_t > decisions;
+
+    auto value = [ &values ]( const uint32_t literal ) -> int
+    {
+        return ( values[ literal / 2 ] < 0 )? -1 : values[ literal / 2 ] ^ ( literal & 1 );
+    };
+
+    auto assign = [ &values, &trail ]( const uint32_t literal )
+    {
+        values[ literal / 2 ] = !( literal & 1 );
+        trail.push_back( literal );
+    };
+
+    auto undo = [ & ]( const size_t position )
+    {
+        while( trail.size() > position )
+        {
+            values[ trail.back() / 2 ] = -1;
+            trail.pop_back();
+        }
+
+        head = position;
+    };
+
+    for( uint32_t const& literal : assumptions )
+    {
+        if( value( literal ) == 0 )
+        {
+            return false;
+        }
+
+        if( value( literal ) < 0 )
+        {
+            assign( literal );
+        }
+    }
+
+    // OR sets holding x and !x always hold, single literals are assigned at once and the rest watch their first two literals
+    for( index = 0; index < clauses.size(); ++index )
+    {
+        Cube &clause = clauses[ index ];
+
+        std::sort( clause.begin(), clause.end() );
+        clause.erase( std::unique( clause.begin(), clause.end() ), clause.end() );
+
+        if( contradictory( clause ) )
+        {
+            continue;
+        }
+
+        if( clause.size() < 2 )
+        {
+            if( clause.empty() || value( clause[ 0 ] ) == 0 )
+            {
+                return false;
+            }
+
+            if( value( clause[ 0 ] ) < 0 )
+            {
+                assign( clause[ 0 ] );
+            }
+
+            continue;
+        }
+
+        for( uint32_t const& literal : clause )
+        {
+            used[ literal / 2 ] = true;
+        }
+
+        watches[ clause[ 0 ] ].push_back( index );
+        watches[ clause[ 1 ] ].push_back( index );
+    }
+
+    // makes every OR set watching a literal made FALSE watch another, assigning the last literal left, false on a conflict
+    auto propagate = [ & ]() -> bool
+    {
+        bool conflict = false;
+
+        while( head < trail.size() && !conflict )
+        {
+            uint32_t falsified = trail[ head++ ] ^ 1;
+            std::vector< uint32_t > &watching = watches[ falsified ];
+            size_t position, kept = 0, other;
+
+            for( position = 0; position < watching.size(); ++position )
+            {
+                Cube &clause = clauses[ watching[ position ] ];
+
+                if( !conflict )
+                {
+                    if( clause[ 0 ] == falsified )
+                    {
+                        std::swap( clause[ 0 ], clause[ 1 ] );
+                    }
+
+                    if( value( clause[ 0 ] ) != 1 )
+                    {
+                        for( other = 2; other < clause.size() && value( clause[ other ] ) == 0; ++other );
+
+                        if( other < clause.size() )
+                        {
+                            std::swap( clause[ 1 ], clause[ other ] );
+                            watches[ clause[ 1 ] ].push_back( watching[ position ] );
+                            continue;
+                        }
+
+                        if( value( clause[ 0 ] ) == 0 )
+                        {
+                            conflict = true;
+                        }
+                        else
+                        {
+                            assign( clause[ 0 ] );
+                        }
+                    }
+                }
+
+                watching[ kept++ ] = watching[ position ];
+            }
+
+            watching.resize( kept );
+        }
+
+        return !conflict;
+    };
+
+    if( !propagate() )
+    {
+        return false;
+    }
+
+    while( true )
+    {
+        while( next < variables && ( !used[ next ] || values[ next ] >= 0 ) )
+        {
+            ++next;
+        }
+
+        if( next == variables )
+        {
+            return true;
+        }
+
+        decisions.push_back( trail.size() );
+        flipped.push_back( false );
+        assign( 2 * next + 1 );
+
+        while( !propagate() )
+        { // the latest decision not yet tried both ways is flipped
+            while( !decisions.empty() && flipped.back() )
+            {
+                undo( decisions.back() );
+                decisions.pop_back();
+                flipped.pop_back();
+            }
+
+            if( decisions.empty() )
+            {
+                return false;
+            }
+
+            uint32_t literal = trail[ decisions.back() ] ^ 1;
+
+            undo( decisions.back() );
+            flipped.back() = true;
+            assign( literal );
+            next = 0;
+        }
+    }
+}
+
+// whether two sorted literal sets share a literal
+static bool shares_literal( const Cube &left, const Cube &right )
+{
+    auto left_literal = left.begin(), right_literal = right.begin();
+
+    while( left_literal != left.end() && right_literal != right.end() )
+    {
+        if( *left_literal == *right_literal )
+        {
+            return true;
+        }
+
+        ( *left_literal < *right_literal )? ++left_literal : ++right_literal;
+    }
+
+    return false;
+}
+
+// each literal complemented, a negated AND set is an OR set and the other way around
+static Cube negate_literals( Cube cube )
+{
+    for( uint32_t& literal : cube )
+    {
+        literal ^= 1;
+    }
+
+    std::sort( cube.begin(), cube.end() );
+    return cube;
+}
+
+// The AND sets, or OR sets in CNF, of a statement as sorted literals id * 2 + negated
+std::vector< std::vector< uint32_t > > LogicalMatrix::literal_sets( const size_t &statement_index ) const
+{
+    if( current_storage != Dense )
+    {
+        std::vector< std::vector< uint32_t > > result;
+
+        for( size_t position = statement_offsets[ statement_index ]; position < statement_offsets[ statement_index + 1 ]; ++position )
+        {
+            result.emplace_back();
+            list_term( statement_terms[ position ], result.back() );
+        }
+
+        return result;
+    }
+
+    const BitVector &row = OR_matrix[ statement_index ];
+    std::vector< std::vector< uint32_t > > result( row.count() );
+    std::vector< uint32_t > position( row.size() );
+    size_t index, count = 0;
+
+    for( index = row.find_first(); index != BitVector::npos; index = row.find_next( index ) )
+    {
+        position[ index ] = count++;
+    }
+
+    for( TruthTable const& table : AND_matrix )
+    {
+        BitVector True = table.True, False = table.False;
+
+        True &= row;
+        False &= row;
+
+        for( index = True.find_first(); index != BitVector::npos; index = True.find_next( index ) )
+        {
+            result[ position[ index ] ].push_back( table.identifier * 2 );
+        }
+
+        for( index = False.find_first(); index != BitVector::npos; index = False.find_next( index ) )
+        {
+            result[ position[ index ] ].push_back( table.identifier * 2 + 1 );
+        }
+    }
+
+    return result;
+}
+
+// The sets of a statement holding every one of literals, found by ANDing the columns of the literals as trim() does
+BitVector LogicalMatrix::supersets( const std::vector< uint32_t > &literals, const size_t &statement_index ) const
+{
+    BitVector result = statement_row( statement_index );
+
+    if( current_storage != Dense )
+    {
+        std::vector< uint32_t > held;
+
+        for( size_t term = result.find_first(); term != BitVector::npos; term = result.find_next( term ) )
+        {
+            list_term( term, held );
+
+            if( !std::includes( held.begin(), held.end(), literals.begin(), literals.end() ) )
+            {
+                result.reset( term );
+            }
+        }
+
+        return result;
     }
 
-    if( empty() )
+    for( uint32_t const& literal : literals )
     {
-        *this = other;
-        return *this;
-    }
+        auto table = std::lower_bound( AND_matrix.begin(), AND_matrix.end(), literal / 2, []( const TruthTable &table, const uint32_t identifier )
+        {
+            return table.identifier < identifier;
+        } );
 
-    size_t old_size = OR_matrix[ 0 ].size(),
-        other_size = other.OR_matrix[ 0 ].size();
-    size_t newsize = old_size * other_size,
-        index, other_index, count;
-    std::vector< std::vector< bool > > temp_OR_vector = std::vector< std::vector< bool > >( other.statement_count() * statement_count(), std::vector< bool >( newsize ) );
+        if( table == AND_matrix.end() || table->identifier != literal / 2 )
+        {
+            return BitVector( result.size() );
+        }
 
-    // ensures each TruthTable has the correct length of data
-    for( auto& [ key, data ] : AND_matrix )
-    {
-        data.True = stretch_vector( data.True, newsize, other_size );
-        data.False = stretch_vector( data.False, newsize, other_size );
+        result &= ( literal & 1 )? table->False : table->True;
     }
 
-    for( auto const& [ key, data ] : other.AND_matrix )
-    {
-        // adds each TruthTable from other to this if needed
-        if( AND_matrix.count( key ) == 0 )
+    return result;
+}
+
+// statement_index of this implies other_index of source, which shares the SymbolTable of this
+// the premise and the negated conclusion must be unsatisfiable together
+bool LogicalMatrix::implies_shared( const size_t &statement_index, const LogicalMatrix &source, const size_t &other_index ) const
+{
+    std::vector< Cube > premises = literal_sets( statement_index ), conclusions = source.literal_sets( other_index ), clauses;
+
+    if( source.matrix_form == DNF )
+    { // the negated conclusion is an AND of OR sets
+        for( Cube const& conclusion : conclusions )
         {
-            AND_matrix[ key ] = TruthTable( newsize );
+            clauses.push_back( negate_literals( conclusion ) );
         }
 
-        index = 0;
+        if( matrix_form == CNF )
+        {
+            clauses.insert( clauses.end(), premises.begin(), premises.end() );
+            return !satisfiable_clauses( clauses, {} );
+        }
 
-        // multiplys AND_matrix with other.AND_matrix for the current key
-        for( count = 0; count < old_size; ++count )
+        for( Cube const& premise : premises )
         {
-            for( other_index = 0; other_index < other_size ; ++other_index )
+            if( !contradictory( premise ) && satisfiable_clauses( clauses, premise ) )
             {
-                AND_matrix[ key ].True[ index ] = AND_matrix[ key ].True[ index ] | data.True[ other_index ];
-                AND_matrix[ key ].False[ index ] = AND_matrix[ key ].False[ index ] | data.False[ other_index ];
-                ++index;
+                return false;
             }
         }
-    }
 
-    index = 0;
+        return true;
+    }
 
-    // multiplys OR_matrix with other.OR_matrix
-    for( std::vector< bool > const& statement : OR_matrix )
+    // a CNF conclusion holds when each of its OR sets does, an OR set fails when all of its literals are FALSE
+    for( Cube const& conclusion : conclusions )
     {
-        for( std::vector< bool > const& other_statement : other.OR_matrix )
+        if( contradictory( conclusion ) )
         {
-            other_index = 0;
+            continue;
+        }
 
-            for( bool const& value : statement )
+        if( matrix_form == CNF )
+        {
+            if( satisfiable_clauses( premises, negate_literals( conclusion ) ) )
             {
-                for( bool const& other_value : other_statement )
+                return false;
+            }
+        }
+        else
+        {
+            for( Cube const& premise : premises )
+            {
+                if( !contradictory( premise ) && !shares_literal( premise, conclusion ) )
                 {
-                    temp_OR_vector[ index ][ other_index++ ] = value & other_value;
+                    return false;
                 }
             }
-
-            ++index;
         }
     }
 
-    OR_matrix = temp_OR_vector;
-
-    trim();
-
-    return *this;
-}
-
-LogicalMatrix LogicalMatrix::AND( const LogicalMatrix &other )
-{
-    *this &= other;
-    return *this;
+    return true;
 }
 
-LogicalMatrix LogicalMatrix::AND( const LogicalMatrix &other, const size_t &statement_index )
+bool LogicalMatrix::satisfiable( const size_t &statement_index ) const
 {
-    if( other.empty() | statement_index >= statement_count() )
+    if( statement_index >= statement_count() )
     {
-        return *this;
+        return false;
     }
 
-    LogicalMatrix temp_matrix = isolate_statement( statement_index ) & other;
-
-    OR_matrix.erase( OR_matrix.begin() + statement_index );
-
-    return ADD( temp_matrix, statement_index );
-}
-
-// OR yealding a new object
-LogicalMatrix LogicalMatrix::operator |( const LogicalMatrix &other ) const
-{
-    LogicalMatrix new_matrix( *this );
-    new_matrix |= other;
-    return new_matrix;
-}
-
-// OR assignment
-LogicalMatrix LogicalMatrix::operator |=( const LogicalMatrix &other )
-{
-    if( other.empty() )
-    {
-        return *this;
-    }
+    std::vector< Cube > sets = literal_sets( statement_index );
 
-    if( empty() )
+    if( matrix_form == CNF )
     {
-        *this = other;
-        return *this;
+        return satisfiable_clauses( sets, {} );
     }
 
-    extend_matrix( other );
-
-    size_t index = 0, newsize = OR_matrix[ 0 ].size() + other.OR_matrix[ 0 ].size();
-    std::vector< std::vector< bool > > temp_OR_vector = std::vector< std::vector< bool > >( other.statement_count() * statement_count() );
-
-    for( std::vector< bool > const& statement : OR_matrix )
+    return std::any_of( sets.begin(), sets.end(), []( const Cube &set )
     {
-        for( std::vector< bool > const& other_statement : other.OR_matrix )
-        {
-            temp_OR_vector[ index ] = statement;
-            extend_vector( temp_OR_vector[ index ], other_statement, newsize );
-            ++index;
-        }
-    }
-
-    OR_matrix = temp_OR_vector;
-
-    trim();
-
-    return *this;
+        return !contradictory( set );
+    } );
 }
 
-LogicalMatrix LogicalMatrix::OR( const LogicalMatrix &other )
+bool LogicalMatrix::implies( const size_t &statement_index, const size_t &other_index ) const
 {
-    *this |= other;
-    return *this;
+    return implies( statement_index, *this, other_index );
 }
 
-LogicalMatrix LogicalMatrix::OR( const LogicalMatrix &other, const size_t &statement_index )
+bool LogicalMatrix::implies( const size_t &statement_index, const LogicalMatrix &other, const size_t &other_index ) const
 {
-    if( other.empty() | statement_index >= statement_count() )
+    if( statement_index >= statement_count() || other_index >= other.statement_count() )
     {
-        return *this;
+        return false;
     }
 
-    LogicalMatrix temp_matrix = isolate_statement( statement_index ) | other;
-
-    OR_matrix.erase( OR_matrix.begin() + statement_index );
-
-    return ADD( temp_matrix, statement_index );
-}
+    LogicalMatrix rebound;
+    const LogicalMatrix &source = ( &other == this )? other : share_symbols( other, rebound );
 
-LogicalMatrix LogicalMatrix::operator +( const LogicalMatrix &other ) const
-{
-    LogicalMatrix new_matrix( *this );
-    return new_matrix.ADD( other );
+    return implies_shared( statement_index, source, other_index );
 }
 
-LogicalMatrix LogicalMatrix::operator +=( const LogicalMatrix &other )
+bool LogicalMatrix::equivalent( const size_t &statement_index, const size_t &other_index ) const
 {
-    return ADD( other );
+    return equivalent( statement_index, *this, other_index );
 }
 
-LogicalMatrix LogicalMatrix::ADD( const LogicalMatrix &other, const size_t &statement_index )
+bool LogicalMatrix::equivalent( const size_t &statement_index, const LogicalMatrix &other, const size_t &other_index ) const
 {
-    if( other.empty() )
-    {
-        return *this;
-    }
-
-    if( OR_matrix.empty() )
+    if( statement_index >= statement_count() || other_index >= other.statement_count() )
     {
-        *this = other;
-        return *this;
+        return false;
     }
 
-    extend_matrix( other );
-
-    size_t depth = statement_count(),
-        old_size = OR_matrix[ 0 ].size(),
-        other_size = other.OR_matrix[ 0 ].size();
-    size_t index, newsize = old_size + other_size;
-
-    std::vector< bool > temp_vector( other_size, false );
+    LogicalMatrix rebound;
+    const LogicalMatrix &source = ( &other == this )? other : share_symbols( other, rebound );
 
-    OR_matrix.reserve( statement_count() + other.statement_count() );
+    return implies_shared( statement_index, source, other_index ) && source.implies_shared( other_index, *this, statement_index );
+}
 
-    for( std::vector< bool >& statement : OR_matrix )
+// every statement of this is equivalent to the statement of other at the same index
+bool LogicalMatrix::equivalent( const LogicalMatrix &other ) const
+{
+    if( statement_count() != other.statement_count() )
     {
-        extend_vector( statement, temp_vector, newsize );
+        return false;
     }
 
-    index = ( statement_index < depth )? statement_index : depth;
+    LogicalMatrix rebound;
+    const LogicalMatrix &source = ( &other == this )? other : share_symbols( other, rebound );
 
-    for( auto const& statement : other.OR_matrix )
+    for( size_t statement = 0; statement < statement_count(); ++statement )
     {
-        OR_matrix.insert( OR_matrix.begin() + index, std::vector< bool >( old_size, false ) );
-        extend_vector( OR_matrix[ index++ ], statement, newsize );
+        if( !implies_shared( statement, source, statement ) || !source.implies_shared( statement, *this, statement ) )
+        {
+            return false;
+        }
     }
 
-    trim();
-
-    return *this;
+    return true;
 }
 
-bool LogicalMatrix::operator ==( const LogicalMatrix &other ) const
+bool LogicalMatrix::subsumes( const size_t &statement_index, const size_t &other_index ) const
 {
-    return ( AND_matrix == other.AND_matrix ) && ( OR_matrix == other.OR_matrix );
+    return subsumes( statement_index, *this, other_index );
 }
 
-bool LogicalMatrix::operator <( const LogicalMatrix &other ) const
+// In DNF every AND set of other_index holds an AND set of statement_index, in CNF every OR set of statement_index
+// holds an OR set of other_index, so other_index implies statement_index, statements of different forms are compared by implies
+bool LogicalMatrix::subsumes( const size_t &statement_index, const LogicalMatrix &other, const size_t &other_index ) const
 {
-    if( AND_matrix == other.AND_matrix )
+    if( statement_index >= statement_count() || other_index >= other.statement_count() )
     {
-        return OR_matrix < other.OR_matrix;
+        return false;
     }
-    else
+
+    LogicalMatrix rebound;
+    const LogicalMatrix &source = ( &other == this )? other : share_symbols( other, rebound );
+
+    if( matrix_form != source.matrix_form )
     {
-        return AND_matrix < other.AND_matrix;
+        return source.implies_shared( other_index, *this, statement_index );
     }
-}
-
-size_t LogicalMatrix::identifier_count() const
-{
-    return AND_matrix.size();
-}
 
-size_t LogicalMatrix::statement_count() const
-{
-    return OR_matrix.size();
-}
+    const LogicalMatrix &smaller = ( matrix_form == DNF )? *this : source, &larger = ( matrix_form == DNF )? source : *this;
+    const size_t smaller_index = ( matrix_form == DNF )? statement_index : other_index, larger_index = ( matrix_form == DNF )? other_index : statement_index;
+    BitVector row = larger.statement_row( larger_index ), covered( row.size() );
 
-bool LogicalMatrix::empty() const
-{
-    return AND_matrix.empty();
-}
+    for( Cube const& set : smaller.literal_sets( smaller_index ) )
+    {
+        covered |= larger.supersets( set, larger_index );
+    }
 
-void LogicalMatrix::clear()
-{
-    AND_matrix.clear();
-    OR_matrix.clear();
+    return row.is_subset_of( covered );
 }
 
-std::vector< bool > LogicalMatrix::evaluate( std::map< std::string, bool > identifiers ) const
+// read from the sets as they are in either form, as StatementView does
+std::set< std::string > LogicalMatrix::get_unique_identifiers() const
 {
-    if( empty() )
-    {
-        return {};
-    }
-
-    size_t index, inner_index, size = OR_matrix[ 0 ].size(), depth = statement_count();
-    std::vector< bool > truth_table( size, true );
-    std::vector< bool > result( depth, false );
+    std::set< std::string > result;
 
-    for( auto const& [ key, data ] : AND_matrix )
+    for( TruthTable const& table : AND_matrix )
     {
-        if( identifiers.count( key ) == 0 )
-        { // keys found in this and not identifiers with are evaluated as FALSE regardless of data
-            for( index = 0; index < size; ++index )
-            {
-                truth_table[ index ] = truth_table[ index ] & !( data.True[ index ] || data.False[ index ] );
-            }
-        }
-        else
-        { // keys found in both this and identifiers are evaluated based on their value in identifiers
-            if( identifiers[ key ] )
-            {
-                for( index = 0; index < size; ++index )
-                {
-                    truth_table[ index ] = truth_table[ index ] & !data.False[ index ];
-                }
-            }
-            else
-            {
-                for( index = 0; index < size; ++index )
-                {
-                    truth_table[ index ] = truth_table[ index ] & !data.True[ index ];
-                }
-            }
-        }
+        result.insert( name( table ) );
     }
 
-    for( index = 0; index < depth; ++index )
+    for( SymbolTable::id_type const& identifier : sparse_identifiers() )
     {
-        for( inner_index = 0; inner_index < size; ++inner_index )
-        {
-            if( truth_table[ inner_index ] && OR_matrix[ index ][ inner_index ] )
-            {
-                result[ index ] = true;
-                break;
-            }
-        }
+        result.insert( symbols->name( identifier ) );
     }
 
     return result;
 }
 
-bool LogicalMatrix::remove_statement( const size_t &remove_index )
+const std::shared_ptr< SymbolTable > &LogicalMatrix::symbol_table() const
 {
-    if( remove_index < statement_count() )
-    {
-        OR_matrix.erase( OR_matrix.begin() + remove_index );
-        trim();
-
-        return true;
-    }
-
-    return false;
+    return symbols;
 }
 
-LogicalMatrix LogicalMatrix::isolate_statement( const size_t &statement_index ) const
+// copy of this with every identifier interned into symbol_table
+LogicalMatrix LogicalMatrix::rebind( const std::shared_ptr< SymbolTable > &symbol_table ) const
 {
-    LogicalMatrix result;
+    LogicalMatrix result( *this );
 
-    if( statement_index < statement_count() )
+    result.symbols = symbol_table;
+
+    if( symbol_table == symbols )
     {
-        result.AND_matrix = AND_matrix;
-        result.OR_matrix.push_back( OR_matrix[ statement_index ] );
-        result.trim();
+        return result;
     }
 
-    return result;
-}
-
-std::vector< LogicalMatrix > LogicalMatrix::split_statements() const
-{
-    size_t index, depth = statement_count();
-    std::vector< LogicalMatrix > result = std::vector< LogicalMatrix >( depth );
+    if( current_storage == TermMajor )
+    { // the masks are rebuilt as wide as symbol_table
+        LogicalMatrix listed( *this );
 
-    for( index = 0; index < depth; ++index )
-    {
-        result[ index ] = isolate_statement( index );
+        listed.make_sparse();
+        result = listed.rebind( symbol_table );
+        result.make_term_major();
+        return result;
     }
 
-    return result;
-}
+    if( current_storage == Sparse )
+    { // identifiers are interned in increasing order as the TruthTables of dense storage are
+        std::vector< SymbolTable::id_type > identifiers = sparse_identifiers(), interned;
 
-void LogicalMatrix::combine_statements()
-{
-    if( statement_count() > 1 )
-    {
-        std::vector< LogicalMatrix > split_vector = split_statements();
+        for( SymbolTable::id_type const& identifier : identifiers )
+        {
+            interned.push_back( symbol_table->intern( symbols->name( identifier ) ) );
+        }
 
-        clear();
+        for( uint32_t &literal : result.term_literals.write() )
+        {
+            literal = interned[ std::lower_bound( identifiers.begin(), identifiers.end(), literal / 2 ) - identifiers.begin() ] * 2 + ( literal & 1 );
+        }
 
-        for( auto const& individual_LM : split_vector )
+        for( size_t term = 0; term < result.term_count(); ++term )
         {
-            *this &= individual_LM;
+            std::sort( result.term_literals.write().begin() + result.term_offsets[ term ], result.term_literals.write().begin() + result.term_offsets[ term + 1 ] );
         }
-    }
-}
 
-std::set< std::string > LogicalMatrix::get_unique_identifiers() const
-{
-    std::set< std::string > result;
+        return result;
+    }
 
-    for( auto const& [ key, data ] : AND_matrix )
+    for( TruthTable& table : result.AND_matrix.write() )
     {
-        result.insert( key );
+        table.identifier = symbol_table->intern( name( table ) );
     }
 
+    std::sort( result.AND_matrix.write().begin(), result.AND_matrix.write().end(), []( const TruthTable &left, const TruthTable &right )
+    {
+        return left.identifier < right.identifier;
+    } );
+
     return result;
 }
 
@@ -966,42 +4425,95 @@ std::ostream &operator<<( std::ostream &output, const LogicalMatrix &object_arg
         return output;
     }
 
+    if( object_arg.matrix_form == LogicalMatrix::CNF )
+    {
+        return output << object_arg.to_DNF();
+    }
+
+    if( object_arg.current_storage != LogicalMatrix::Dense )
+    { // the literals of each AND set are ordered by identifier name, x before !x
+        std::vector< uint32_t > literals;
+        bool output_empty = true;
+
+        auto print_term = [ & ]()
+        {
+            std::sort( literals.begin(), literals.end(), [ &object_arg ]( const uint32_t left, const uint32_t right )
+            {
+                int comparison = object_arg.symbols->name( left / 2 ).compare( object_arg.symbols->name( right / 2 ) );
+
+                return ( comparison != 0 )? comparison < 0 : left < right;
+            } );
+
+            for( size_t index = 0; index < literals.size(); ++index )
+            {
+                output << ( ( index > 0 )? " & " : "" ) << ( ( literals[ index ] & 1 )? "!" : "" ) << object_arg.symbols->name( literals[ index ] / 2 );
+            }
+        };
+
+        for( size_t statement = 0; statement < object_arg.statement_count(); ++statement )
+        {
+            bool OR_empty = true;
+
+            output << ( output_empty? "" : ", " );
+            output_empty = false;
+
+            for( size_t position = object_arg.statement_offsets[ statement ]; position < object_arg.statement_offsets[ statement + 1 ]; ++position )
+            {
+                uint32_t term = object_arg.statement_terms[ position ];
+
+                object_arg.list_term( term, literals );
+
+                if( !literals.empty() )
+                {
+                    output << ( OR_empty? "" : " | " );
+                    OR_empty = false;
+                    print_term();
+                }
+            }
+        }
+
+        return output;
+    }
+
     size_t size = object_arg.OR_matrix[ 0 ].size();
     std::ostringstream AND_streams[ size ];
-    std::vector< bool > AND_empty( size, true );
+    BitVector AND_empty( size, true ), significant;
     bool OR_empty, output_empty = true;
 
-    for( auto const& [ key, data ] : object_arg.AND_matrix )
+    for( size_t const& position : object_arg.ordered_identifiers() )
     {
-        for( size_t index = 0; index < size; ++index )
+        LogicalMatrix::TruthTable const& data = object_arg.AND_matrix[ position ];
+        std::string const& key = object_arg.name( data );
+
+        significant = data.True;
+        significant |= data.False;
+
+        for( size_t index = significant.find_first(); index != BitVector::npos; index = significant.find_next( index ) )
         {
-            if( data.True[ index ] | data.False[ index ] )
+            if( AND_empty[ index ] )
             {
-                if( AND_empty[ index ] )
-                {
-                    AND_empty[ index ] = false;
-                }
-                else
-                {
-                    AND_streams[ index ] << " & ";
-                }
-
-                if( data.True[ index ] & data.False[ index ] )
-                {
-                    AND_streams[ index ] << key << " & ";
-                }
+                AND_empty.reset( index );
+            }
+            else
+            {
+                AND_streams[ index ] << " & ";
+            }
 
-                if( data.False[ index ] )
-                {
-                    AND_streams[ index ] << "!";
-                }
+            if( data.True[ index ] & data.False[ index ] )
+            {
+                AND_streams[ index ] << key << " & ";
+            }
 
-                AND_streams[ index ] << key;
+            if( data.False[ index ] )
+            {
+                AND_streams[ index ] << "!";
             }
+
+            AND_streams[ index ] << key;
         }
     }
 
-    for( std::vector< bool > const& statement : object_arg.OR_matrix )
+    for( BitVector const& statement : object_arg.OR_matrix )
     {
         OR_empty = true;
 
@@ -1037,33 +4549,41 @@ std::ostream &operator<<( std::ostream &output, const LogicalMatrix &object_arg
 
 void LogicalMatrix::debug_print() const
 {
+    if( current_storage != Dense )
+    {
+        dense_copy().debug_print();
+        return;
+    }
+
     size_t index = 0;
     std::ostringstream output;
 
-    auto print_vector = [ &output ]( const std::vector< bool > &input_vector, const std::string &label )
+    auto print_vector = [ &output ]( const BitVector &input_vector, const std::string &label )
     {
         output << label << ": ";
 
-        for( bool const& value : input_vector )
+        for( size_t index = 0; index < input_vector.size(); ++index )
         {
-            output << value;
+            output << input_vector[ index ];
         }
 
         output << std::endl;
     };
 
-    output << "AND_matrix" << std::endl;
+    output << "AND_matrix" << ( ( matrix_form == CNF )? " of OR sets" : "" ) << std::endl;
 
-    for( auto const& [ key, data ] : AND_matrix )
+    for( size_t const& position : ordered_identifiers() )
     {
-        output << "Value: " << key << std::endl;
+        TruthTable const& data = AND_matrix[ position ];
+
+        output << "Value: " << name( data ) << std::endl;
         print_vector( data.True, "T" );
         print_vector( data.False, "F" );
     }
 
     output << "OR_matrix" << std::endl;
 
-    for( std::vector< bool > const& statement : OR_matrix )
+    for( BitVector const& statement : OR_matrix )
     {
         print_vector( statement, std::to_string( index++ ) );
     }
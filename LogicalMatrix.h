@@ -1,39 +1,121 @@
 // LogicalMatrix.h
 
 /** Header file for the LogicalMatrix class.
+ *
+ *  A LogicalMatrix holds its statements in DNF, each statement an OR of the
+ *  AND sets in AND_matrix, or in CNF, each statement an AND of OR sets kept in
+ *  the same columns. Negation swaps the literals of every column and moves
+ *  between the two forms. A CNF matrix is expanded into DNF only for the
+ *  operations that need it, failing once an expansion grows past
+ *  conversion_limit() AND sets.
  */
 
 #ifndef __LogicalMatrix_h_included__
 #define __LogicalMatrix_h_included__
 
+#include "BitVector.h"
+#include "SharedVector.h"
+#include "SymbolTable.h"
 #include <exception>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
+class CompiledMatrix;
+class DecisionDiagram;
+class FrozenMatrix;
+class LogicalExpr;
+class StatementView;
+class ThreadPool;
+
 class LogicalMatrix
 {
+    friend class CompiledMatrix;
+    friend class DecisionDiagram;
+    friend class FrozenMatrix;
+    friend class LogicalExpr;
+    friend class StatementView;
+
     private:
         class TruthTable
         {
             public:
-                std::vector< bool > True, False;
+                SymbolTable::id_type identifier;
+                BitVector True, False;
 
-                TruthTable( const size_t depth = 1 );
-                TruthTable( const size_t depth, const bool condition );
+                TruthTable( const SymbolTable::id_type identifier, const size_t depth = 1 );
+                TruthTable( const SymbolTable::id_type identifier, const size_t depth, const bool condition );
                 bool operator ==( const TruthTable &other ) const;
                 bool operator <( const TruthTable &other ) const;
                 TruthTable operator !() const;
         };
 
-        std::map< std::string, TruthTable > AND_matrix;
-        std::vector< std::vector< bool > > OR_matrix;
+    public:
+        enum Form { DNF, CNF };
+        enum Minimization { Automatic, Exact, Heuristic };
+        enum Storage { Dense, Sparse, TermMajor, Adaptive };
+
+        static const size_t default_conversion_limit = 1 << 20, default_scratch_limit = 1 << 24;
+
+    private:
+        // copies of a matrix share the vectors below until one of them changes them, writes go through write()
+        // one TruthTable per identifier, kept sorted by identifier id
+        // in CNF the columns are OR sets and each row of OR_matrix is the AND of its OR sets
+        SharedVector< TruthTable > AND_matrix;
+        SharedVector< BitVector > OR_matrix;
+        std::shared_ptr< SymbolTable > symbols;
+        Form matrix_form = DNF;
+        bool drop_contradictions = false, minimize_automatically = false;
+        size_t DNF_limit = default_conversion_limit;
+
+        // in sparse storage AND_matrix and OR_matrix are empty, AND set t holds the literals id * 2 + negated
+        // term_literals[ term_offsets[ t ] .. term_offsets[ t + 1 ] ) and statement s the AND sets
+        // statement_terms[ statement_offsets[ s ] .. statement_offsets[ s + 1 ] ), both in increasing order
+        // TermMajor storage keeps the same statements with the identifiers of AND set t as bits of term_positive[ t ]
+        // and term_negative[ t ], all as wide as the SymbolTable when they were last built
+        Storage current_storage = Dense, requested_storage = Adaptive;
+        SharedVector< uint32_t > term_offsets, term_literals, statement_offsets, statement_terms;
+        SharedVector< BitVector > term_positive, term_negative;
 
-        LogicalMatrix build_inverse( const size_t &index ) const;
+        const std::string &name( const TruthTable &table ) const;
+        std::vector< size_t > ordered_identifiers() const;
+        const LogicalMatrix &share_symbols( const LogicalMatrix &other, LogicalMatrix &rebound ) const;
+        const LogicalMatrix &share_form( const LogicalMatrix &other, LogicalMatrix &converted );
+        size_t conversion_size( const size_t &limit ) const;
+        const LogicalMatrix &share_storage( const LogicalMatrix &other, LogicalMatrix &converted ) const;
+        LogicalMatrix dense_copy() const;
+        void make_dense();
+        void make_sparse();
+        void make_term_major();
+        void convert_storage( const Storage &storage );
+        void choose_storage();
+        size_t term_count() const;
+        void list_term( const size_t &term, std::vector< uint32_t > &literals ) const;
+        std::vector< SymbolTable::id_type > sparse_identifiers() const;
+        std::vector< std::vector< uint32_t > > sparse_term_statements() const;
+        BitVector statement_row( const size_t &statement_index ) const;
+        void erase_statement( const size_t &statement_index );
+        void insert_statements( const LogicalMatrix &source, const size_t &statement_index );
+        void adopt( const LogicalMatrix &other );
+        void negate();
+        std::vector< size_t > merge_identifiers( const LogicalMatrix &other, const size_t depth );
+        LogicalMatrix build_clause( const size_t &index, const std::vector< size_t > &order ) const;
         void extend_matrix( const LogicalMatrix &other );
+        void multiply( const LogicalMatrix &other, const size_t &limit );
+        void concatenate( const LogicalMatrix &other, const bool &trimmed = true );
+        void append_statements( const LogicalMatrix &other );
+        LogicalMatrix &combine( const LogicalMatrix &other, const bool &conjunction, const bool &trimmed = true );
         void trim();
+        void multiply_sparse( const LogicalMatrix &other, const size_t &limit );
+        void concatenate_sparse( const LogicalMatrix &other, const bool &trimmed = true );
+        void trim_sparse();
+        std::vector< std::vector< uint32_t > > literal_sets( const size_t &statement_index ) const;
+        BitVector supersets( const std::vector< uint32_t > &literals, const size_t &statement_index ) const;
+        bool implies_shared( const size_t &statement_index, const LogicalMatrix &source, const size_t &other_index ) const;
 
     public:
         class Logicalstatementexception: public std::exception
@@ -45,26 +127,72 @@ class LogicalMatrix
                 }
         };
 
+        class Logicalfileexception: public std::exception
+        {
+            public:
+                virtual const char* what() const throw()
+                {
+                    return "Unreadable logical statement file";
+                }
+        };
+
+        class Logicalsizeexception: public std::exception
+        {
+            public:
+                virtual const char* what() const throw()
+                {
+                    return "Logical statement too large to convert to DNF";
+                }
+        };
+
+        class Logicalformatexception: public std::exception
+        {
+            public:
+                virtual const char* what() const throw()
+                {
+                    return "Unreadable serialized logical matrix";
+                }
+        };
+
         LogicalMatrix() {}
-        LogicalMatrix( const std::string &input_string );
+        LogicalMatrix( const std::string &input_string, std::shared_ptr< SymbolTable > symbol_table = nullptr );
+        static LogicalMatrix load( const std::string &path, ThreadPool *pool = nullptr, std::shared_ptr< SymbolTable > symbol_table = nullptr );
+
+        // a versioned binary record of the statements, form, storage and settings that deserialize() restores exactly,
+        // throwing Logicalformatexception for a record that is truncated, corrupted or of another version
+        std::string serialize() const;
+        void serialize( std::ostream &output ) const;
+        static LogicalMatrix deserialize( const std::string_view &input, std::shared_ptr< SymbolTable > symbol_table = nullptr );
+        static LogicalMatrix deserialize( std::istream &input, std::shared_ptr< SymbolTable > symbol_table = nullptr );
 
-        LogicalMatrix operator !() const;
-        LogicalMatrix NOT();
-        LogicalMatrix NOT( const size_t &statement_index );
+        // trims and products give their temporary buffers back for reuse on the same thread, holding at most limit bytes on each,
+        // 0 keeps none; scratch_size() is what the calling thread holds and release_scratch() frees it
+        static void set_scratch_limit( const size_t limit );
+        static size_t scratch_size();
+        static void release_scratch();
 
-        LogicalMatrix operator &( const LogicalMatrix &other ) const;
-        LogicalMatrix operator &=( const LogicalMatrix &other );
-        LogicalMatrix AND( const LogicalMatrix &other );
-        LogicalMatrix AND( const LogicalMatrix &other, const size_t &statement_index );
+        // the operators of a temporary reuse its storage for the result instead of copying it
+        LogicalMatrix operator !() const &;
+        LogicalMatrix operator !() &&;
+        LogicalMatrix &NOT();
+        LogicalMatrix &NOT( const size_t &statement_index );
 
-        LogicalMatrix operator |( const LogicalMatrix &other ) const;
-        LogicalMatrix operator |=( const LogicalMatrix &other );
-        LogicalMatrix OR( const LogicalMatrix &other );
-        LogicalMatrix OR( const LogicalMatrix &other, const size_t &statement_index );
+        LogicalMatrix operator &( const LogicalMatrix &other ) const &;
+        LogicalMatrix operator &( const LogicalMatrix &other ) &&;
+        LogicalMatrix &operator &=( const LogicalMatrix &other );
+        LogicalMatrix &AND( const LogicalMatrix &other );
+        LogicalMatrix &AND( const LogicalMatrix &other, const size_t &statement_index );
 
-        LogicalMatrix operator +( const LogicalMatrix &other ) const;
-        LogicalMatrix operator +=( const LogicalMatrix &other );
-        LogicalMatrix ADD( const LogicalMatrix &other, const size_t &statement_index = -1 );
+        LogicalMatrix operator |( const LogicalMatrix &other ) const &;
+        LogicalMatrix operator |( const LogicalMatrix &other ) &&;
+        LogicalMatrix &operator |=( const LogicalMatrix &other );
+        LogicalMatrix &OR( const LogicalMatrix &other );
+        LogicalMatrix &OR( const LogicalMatrix &other, const size_t &statement_index );
+
+        LogicalMatrix operator +( const LogicalMatrix &other ) const &;
+        LogicalMatrix operator +( const LogicalMatrix &other ) &&;
+        LogicalMatrix &operator +=( const LogicalMatrix &other );
+        LogicalMatrix &ADD( const LogicalMatrix &other, const size_t &statement_index = -1 );
 
         bool operator ==( const LogicalMatrix &other ) const;
         bool operator <( const LogicalMatrix &other ) const;
@@ -73,13 +201,59 @@ class LogicalMatrix
         bool empty() const;
         void clear();
 
-        std::vector< bool > evaluate( std::map< std::string, bool > identifiers ) const;
+        // when enabled, AND sets holding both x and !x are dropped from the products of &= unless nothing else is left
+        void set_drop_contradictions( const bool &enabled );
+        bool drops_contradictions() const;
+
+        // expanding a CNF matrix throws Logicalsizeexception once a product exceeds limit AND sets, as does
+        // turning a DNF matrix into CNF once it would take more than limit OR sets
+        Form form() const;
+        LogicalMatrix to_DNF() const;
+        LogicalMatrix to_CNF() const;
+        void set_conversion_limit( const size_t &limit );
+        size_t conversion_limit() const;
+
+        // Exact finds the fewest AND sets for statements of up to 12 identifiers, Heuristic only merges and reduces AND sets,
+        // Automatic is Exact up to 8 identifiers, other statements are always minimized heuristically
+        void minimize( const Minimization &mode = Automatic );
+        void set_auto_minimize( const bool &enabled );
+        bool auto_minimizes() const;
+
+        // Sparse keeps each AND set as a sorted list of its literals instead of a column per identifier, Adaptive moves
+        // between the two by density, operations without a sparse implementation work on a Dense copy
+        // TermMajor keeps each AND set as masks of its positive and negative identifiers, evaluating, printing, negating,
+        // adding and trimming them directly, & and | convert them to literal lists and back
+        void set_storage( const Storage &mode );
+        Storage storage() const;
+
+        std::vector< bool > evaluate( const std::map< std::string, bool > &identifiers ) const;
+
+        // answered without building new statements, a statement index out of range answers false
+        // subsumes is the syntactic check trim() uses, when true other_index implies statement_index
+        bool satisfiable( const size_t &statement_index ) const;
+        bool implies( const size_t &statement_index, const size_t &other_index ) const;
+        bool implies( const size_t &statement_index, const LogicalMatrix &other, const size_t &other_index ) const;
+        bool equivalent( const size_t &statement_index, const size_t &other_index ) const;
+        bool equivalent( const size_t &statement_index, const LogicalMatrix &other, const size_t &other_index ) const;
+        bool equivalent( const LogicalMatrix &other ) const;
+        bool subsumes( const size_t &statement_index, const size_t &other_index ) const;
+        bool subsumes( const size_t &statement_index, const LogicalMatrix &other, const size_t &other_index ) const;
+
+        CompiledMatrix compile() const;
+
+        // a read only image of the statements that can be written to a file and memory mapped, see FrozenMatrix
+        FrozenMatrix freeze() const;
+
+        // refers to one statement of this without copying it, see StatementView
+        StatementView statement( const size_t &statement_index ) const;
         bool remove_statement( const size_t &remove_index );
         LogicalMatrix isolate_statement( const size_t &statement_index ) const;
         std::vector< LogicalMatrix > split_statements() const;
         void combine_statements();
 
         std::set< std::string > get_unique_identifiers() const;
+        const std::shared_ptr< SymbolTable > &symbol_table() const;
+        LogicalMatrix rebind( const std::shared_ptr< SymbolTable > &symbol_table ) const;
         std::string to_string() const;
         friend std::ostream &operator<<( std::ostream &output, const LogicalMatrix &object_arg );
         void debug_print() const;
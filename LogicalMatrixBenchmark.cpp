@@ -0,0 +1,767 @@
+// LogicalMatrixBenchmark.cpp
+
+/** This file is used to measure the performance of the LogicalMatrix class
+ *
+ *  Build with optimizations and threads enabled, for example
+ *  g++ -std=c++17 -O2 -pthread LogicalMatrixBenchmark.cpp
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include "LogicalMatrix.h"
+#include "BitVector.cpp"
+#include "SymbolTable.cpp"
+#include "LogicalMatrix.cpp"
+#include "CompiledMatrix.cpp"
+#include "FrozenMatrix.cpp"
+#include "DecisionDiagram.cpp"
+#include "DeltaEvaluator.cpp"
+#include "StatementView.cpp"
+#include "LogicalExpr.cpp"
+#include "ThreadPool.cpp"
+#include "AssignmentStream.cpp"
+#include "MappedFile.cpp"
+
+// every allocation through operator new is counted and the time spent in operator new and delete summed, relaxed as
+// ThreadPool workers allocate alongside, see benchmark_allocations
+static std::atomic< size_t > allocations( 0 ), allocator_nanoseconds( 0 );
+
+// adds the nanoseconds since start to allocator_nanoseconds
+static void add_allocator_time( const std::chrono::steady_clock::time_point &start )
+{
+    allocator_nanoseconds.fetch_add( std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - start ).count(),
+        std::memory_order_relaxed );
+}
+
+__attribute__(( noinline )) void *operator new( size_t size )
+{
+    auto start = std::chrono::steady_clock::now();
+
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+
+    if( void *memory = std::malloc( size? size : 1 ) )
+    {
+        add_allocator_time( start );
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+__attribute__(( noinline )) void *operator new( size_t size, const std::nothrow_t & ) noexcept
+{
+    auto start = std::chrono::steady_clock::now();
+    void *memory = std::malloc( size? size : 1 );
+
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    add_allocator_time( start );
+    return memory;
+}
+
+__attribute__(( noinline )) void operator delete( void *memory ) noexcept
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::free( memory );
+    add_allocator_time( start );
+}
+
+__attribute__(( noinline )) void operator delete( void *memory, size_t ) noexcept
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::free( memory );
+    add_allocator_time( start );
+}
+
+// seconds taken by the fastest of repeats calls to function
+template< typename Function >
+double best_time( const size_t repeats, const Function &function )
+{
+    double best = -1;
+
+    for( size_t counter = 0; counter < repeats; ++counter )
+    {
+        auto time_start = std::chrono::high_resolution_clock::now();
+        function();
+        double elapsed = std::chrono::duration_cast< std::chrono::duration< double > >( std::chrono::high_resolution_clock::now() - time_start ).count();
+
+        if( best < 0 || elapsed < best )
+        {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+// random truth values for every identifier of every assignment in batch
+void fill_batch( CompiledMatrix::BitSlice &batch, std::mt19937_64 &generator )
+{
+    for( size_t row = 0; row < batch.rows(); ++row )
+    {
+        for( size_t lane = 0; lane < batch.lanes(); ++lane )
+        {
+            batch.row( row )[ lane ] = generator();
+        }
+    }
+}
+
+// parallel batch evaluation from one thread up to every core
+void benchmark_scaling( const size_t assignments )
+{
+    std::mt19937_64 generator( 1 );
+    LogicalMatrix matrix( "( a | b | c | d ) & ( e | f | !g | h ) & ( i | !j | k | l ), a & !e & i | b & f & !j | c & g & k, "
+        "( m | n ) & ( o | p ) & ( q | r ) & ( s | t ) | !a & !m" );
+    CompiledMatrix compiled = matrix.compile();
+    CompiledMatrix::BitSlice batch = compiled.make_batch( assignments ), results = compiled.make_batch_result( assignments );
+    size_t threads, cores = std::max( 1u, std::thread::hardware_concurrency() );
+    double single = 0, elapsed;
+
+    fill_batch( batch, generator );
+
+    std::cout << "Parallel batch evaluation of " << assignments << " assignments, " << compiled.term_count() << " AND sets, "
+        << compiled.statement_count() << " statements" << std::endl;
+
+    for( threads = 1; threads <= cores; threads = ( threads == cores || threads * 2 <= cores )? threads * 2 : cores )
+    {
+        ThreadPool pool( threads );
+
+        elapsed = best_time( 3, [ & ]{ compiled.evaluate_batch( batch, results, pool ); } );
+
+        if( threads == 1 )
+        {
+            single = elapsed;
+        }
+
+        std::cout << "\t" << threads << " threads: " << elapsed << " seconds, " << assignments / elapsed / 1e6
+            << " million assignments per second, speedup " << single / elapsed << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+// parsing a rule file with the constructor against LogicalMatrix::load, serially and on every core
+void benchmark_load( const size_t statements )
+{
+    const std::string path = "LogicalMatrixBenchmark.rules";
+    std::mt19937_64 generator( 2 );
+    std::string content;
+    ThreadPool pool;
+
+    for( size_t counter = 0; counter < statements; ++counter )
+    {
+        content += ( counter == 0? "" : "\n" );
+        content += "( r" + std::to_string( generator() % 1000 ) + " | !r" + std::to_string( generator() % 1000 ) + " ) & ( r"
+            + std::to_string( generator() % 1000 ) + " | r" + std::to_string( generator() % 1000 ) + " & !r" + std::to_string( generator() % 1000 ) + " )";
+    }
+
+    std::ofstream( path ) << content;
+
+    std::cout << "Loading " << statements << " statements" << std::endl
+        << "\tconstructor: " << best_time( 1, [ & ]{ LogicalMatrix matrix( content ); } ) << " seconds" << std::endl
+        << "\tload: " << best_time( 3, [ & ]{ LogicalMatrix::load( path ); } ) << " seconds" << std::endl
+        << "\tload on " << pool.size() << " threads: " << best_time( 3, [ & ]{ LogicalMatrix::load( path, &pool ); } ) << " seconds" << std::endl
+        << std::endl;
+
+    std::remove( path.c_str() );
+}
+
+// a chain of &= over OR clauses sharing identifiers, the raw product grows exponentially while absorption keeps the result small
+void benchmark_product( const size_t clauses )
+{
+    std::mt19937_64 generator( 3 );
+    std::vector< LogicalMatrix > factors;
+    LogicalMatrix result;
+
+    for( size_t counter = 0; counter < clauses; ++counter )
+    {
+        factors.emplace_back( "r" + std::to_string( generator() % 12 ) + " | r" + std::to_string( generator() % 12 ) + " | !r"
+            + std::to_string( generator() % 12 ) );
+    }
+
+    double elapsed = best_time( 3, [ & ]
+    {
+        result = factors[ 0 ];
+
+        for( size_t counter = 1; counter < clauses; ++counter )
+        {
+            result &= factors[ counter ];
+        }
+    } );
+
+    std::cout << "AND of " << clauses << " clauses: " << elapsed << " seconds, " << result.compile().term_count() << " AND sets" << std::endl
+        << std::endl;
+}
+
+// random AND sets of four literals minimized exactly and heuristically
+void benchmark_minimize( const size_t identifiers, const size_t terms )
+{
+    std::mt19937_64 generator( 4 );
+    std::string content;
+
+    for( size_t counter = 0; counter < terms; ++counter )
+    {
+        content += ( counter == 0? "" : " | " );
+
+        for( size_t literal = 0; literal < 4; ++literal )
+        {
+            content += std::string( literal == 0? "" : " & " ) + ( generator() % 2? "!" : "" ) + "r" + std::to_string( generator() % identifiers );
+        }
+    }
+
+    LogicalMatrix matrix( content ), result;
+
+    std::cout << "Minimizing " << terms << " AND sets over " << identifiers << " identifiers" << std::endl;
+
+    for( auto const& mode : { std::make_pair( LogicalMatrix::Exact, "exact" ), std::make_pair( LogicalMatrix::Heuristic, "heuristic" ) } )
+    {
+        double elapsed = best_time( 3, [ & ]{ result = matrix; result.minimize( mode.first ); } );
+
+        std::cout << "\t" << mode.second << ": " << elapsed << " seconds, " << result.compile().term_count() << " AND sets" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+// a chain of &= over disjoint OR clauses, the DNF doubles with every clause while the diagram grows by two nodes
+void benchmark_diagram( const size_t clauses )
+{
+    std::vector< LogicalMatrix > factors;
+    LogicalMatrix matrix;
+    DecisionDiagram diagram;
+
+    for( size_t counter = 0; counter < clauses; ++counter )
+    {
+        factors.emplace_back( "x" + std::to_string( counter ) + " | y" + std::to_string( counter ) );
+    }
+
+    double matrix_elapsed = best_time( 1, [ & ]
+    {
+        matrix = LogicalMatrix();
+
+        for( LogicalMatrix const& factor : factors )
+        {
+            matrix &= factor;
+        }
+    } );
+
+    double diagram_elapsed = best_time( 3, [ & ]
+    {
+        diagram = DecisionDiagram( factors[ 0 ] );
+
+        for( size_t counter = 1; counter < clauses; ++counter )
+        {
+            diagram &= DecisionDiagram( factors[ counter ], diagram.manager() );
+        }
+    } );
+
+    std::cout << "AND of " << clauses << " disjoint clauses" << std::endl
+        << "\tLogicalMatrix: " << matrix_elapsed << " seconds, " << matrix.compile().term_count() << " AND sets" << std::endl
+        << "\tDecisionDiagram: " << diagram_elapsed << " seconds, " << diagram.node_count() << " nodes" << std::endl
+        << std::endl;
+}
+
+// one identifier flipped per step, evaluated in full against a DeltaEvaluator updating only the AND sets holding it
+void benchmark_delta( const size_t statements, const size_t steps )
+{
+    std::mt19937_64 generator( 5 );
+    std::string content;
+
+    for( size_t counter = 0; counter < statements; ++counter )
+    {
+        content += ( counter == 0? "" : ", " );
+        content += "r" + std::to_string( generator() % 1000 ) + " & !r" + std::to_string( generator() % 1000 ) + " | r"
+            + std::to_string( generator() % 1000 ) + " & r" + std::to_string( generator() % 1000 );
+    }
+
+    CompiledMatrix compiled = LogicalMatrix( content ).compile();
+    CompiledMatrix::Assignment assignment = compiled.make_assignment();
+    CompiledMatrix::ResultBitset result = compiled.make_result();
+    DeltaEvaluator delta( compiled );
+    std::vector< SymbolTable::id_type > flips;
+    std::vector< bool > values( compiled.identifier_count(), false );
+    size_t changed = 0;
+
+    for( size_t counter = 0; counter < steps; ++counter )
+    {
+        flips.push_back( generator() % compiled.identifier_count() );
+    }
+
+    double full = best_time( 1, [ & ]
+    {
+        for( SymbolTable::id_type const& identifier : flips )
+        {
+            assignment.set( identifier, !assignment.True[ identifier ] );
+            compiled.evaluate( assignment, result );
+        }
+    } );
+
+    double incremental = best_time( 1, [ & ]
+    {
+        for( SymbolTable::id_type const& identifier : flips )
+        {
+            values[ identifier ] = !values[ identifier ];
+            delta.set( identifier, values[ identifier ] );
+            changed += delta.changes().size();
+        }
+    } );
+
+    std::cout << steps << " single identifier changes over " << statements << " statements" << std::endl
+        << "\tevaluate: " << full << " seconds" << std::endl
+        << "\tDeltaEvaluator: " << incremental << " seconds, " << changed << " statements changed" << std::endl
+        << std::endl;
+}
+
+// dense evaluation of every AND set against counting over the inverted index, with a growing share of identifiers known
+void benchmark_sparse( const size_t statements, const size_t repeats )
+{
+    std::mt19937_64 generator( 6 );
+    std::string content;
+
+    for( size_t counter = 0; counter < statements; ++counter )
+    {
+        content += ( counter == 0? "" : ", " );
+        content += "r" + std::to_string( generator() % 5000 ) + " & !r" + std::to_string( generator() % 5000 ) + " & r"
+            + std::to_string( generator() % 5000 ) + " | r" + std::to_string( generator() % 5000 ) + " & r" + std::to_string( generator() % 5000 );
+    }
+
+    CompiledMatrix compiled = LogicalMatrix( content ).compile();
+    CompiledMatrix::Assignment assignment = compiled.make_assignment();
+    CompiledMatrix::ResultBitset result = compiled.make_result();
+    std::vector< uint32_t > counts;
+
+    std::cout << "Evaluating " << compiled.term_count() << " AND sets over " << compiled.identifier_count() << " identifiers" << std::endl;
+
+    for( size_t known : { 10, 100, 1000, 5000 } )
+    {
+        assignment.clear();
+
+        for( size_t counter = 0; counter < known; ++counter )
+        {
+            assignment.set( generator() % compiled.identifier_count(), generator() % 2 );
+        }
+
+        double dense = best_time( 3, [ & ]
+        {
+            for( size_t counter = 0; counter < repeats; ++counter )
+            {
+                compiled.evaluate( assignment, result );
+            }
+        } );
+
+        double sparse = best_time( 3, [ & ]
+        {
+            for( size_t counter = 0; counter < repeats; ++counter )
+            {
+                compiled.evaluate_sparse( assignment, result, counts );
+            }
+        } );
+
+        std::cout << "\tup to " << known << " known: dense " << dense / repeats * 1e6 << " microseconds, sparse " << sparse / repeats * 1e6
+            << " microseconds" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+// statements appended one at a time, trimming after each, and evaluated in each storage
+// Over many identifiers the literal lists are smallest, over few the masks of an AND set take a word or two
+void benchmark_storage( const size_t statements, const size_t identifier_count )
+{
+    std::mt19937_64 generator( 8 );
+    std::vector< LogicalMatrix > parsed;
+    std::map< std::string, bool > identifiers;
+
+    auto identifier = [ & ]{ return "s" + std::to_string( generator() % identifier_count ); };
+
+    for( size_t counter = 0; counter < statements; ++counter )
+    {
+        parsed.emplace_back( identifier() + " & !" + identifier() + " & " + identifier() + " | " + identifier() + " & " + identifier() );
+    }
+
+    for( size_t counter = 0; counter < identifier_count; ++counter )
+    {
+        identifiers[ "s" + std::to_string( counter ) ] = generator() % 2;
+    }
+
+    std::cout << "Appending and evaluating " << statements << " statements over " << identifier_count << " identifiers" << std::endl;
+
+    for( LogicalMatrix::Storage storage : { LogicalMatrix::Dense, LogicalMatrix::Sparse, LogicalMatrix::TermMajor } )
+    {
+        LogicalMatrix test_matrix;
+        size_t holding = 0;
+
+        test_matrix.set_storage( storage );
+
+        double append = best_time( 1, [ & ]
+        {
+            for( LogicalMatrix const& statement : parsed )
+            {
+                test_matrix += statement;
+            }
+        } );
+
+        double evaluate = best_time( 3, [ & ]
+        {
+            std::vector< bool > values = test_matrix.evaluate( identifiers );
+
+            holding = std::count( values.begin(), values.end(), true );
+        } );
+
+        std::cout << "	" << ( ( storage == LogicalMatrix::Dense )? "dense" : ( storage == LogicalMatrix::Sparse )? "sparse" : "term-major" ) << ": append " << append << " seconds, evaluate "
+            << evaluate << " seconds, " << holding << " statements hold" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+// splitting a matrix into one matrix per statement in each storage, against viewing each statement in place
+void benchmark_split( const size_t statements )
+{
+    std::mt19937_64 generator( 9 );
+    std::string content;
+
+    for( size_t counter = 0; counter < statements; ++counter )
+    {
+        content += ( counter == 0? "" : ", " );
+        content += "t" + std::to_string( generator() % 5000 ) + " & !t" + std::to_string( generator() % 5000 ) + " | t" + std::to_string( generator() % 5000 );
+    }
+
+    LogicalMatrix test_matrix( content );
+    size_t terms = 0;
+
+    std::cout << "Splitting " << statements << " statements" << std::endl;
+
+    for( LogicalMatrix::Storage storage : { LogicalMatrix::Dense, LogicalMatrix::Sparse } )
+    {
+        test_matrix.set_storage( storage );
+
+        std::cout << "\t" << ( ( storage == LogicalMatrix::Dense )? "dense" : "sparse" ) << ": split_statements "
+            << best_time( 1, [ & ]{ terms = test_matrix.split_statements().size(); } ) << " seconds" << std::endl;
+    }
+
+    double views = best_time( 3, [ & ]
+    {
+        terms = 0;
+
+        for( size_t index = 0; index < test_matrix.statement_count(); ++index )
+        {
+            terms += test_matrix.statement( index ).term_count();
+        }
+    } );
+
+    std::cout << "\tviews: " << views << " seconds for " << terms << " AND sets" << std::endl << std::endl;
+}
+
+// the time, allocations and time in operator new and delete of the operations LogicalMatrixTest.cpp checks, scaled up to terms
+// AND sets and terms / 4 appended statements, with the temporary buffers of trims and products reused and with none kept
+void benchmark_allocations( const size_t terms )
+{
+    std::string statement, clauses, negated;
+    size_t width = 0;
+
+    for( size_t term = 0; term < terms; ++term )
+    {
+        statement += ( term == 0? "x" : " | x" ) + std::to_string( term ) + " & !y" + std::to_string( term );
+    }
+
+    for( ; ( ( size_t ) 1 << width ) < terms; ++width )
+    {
+        clauses += ( width == 0? "( a" : " & ( a" ) + std::to_string( width ) + " | b" + std::to_string( width ) + " )";
+        negated += ( width == 0? "a" : " | a" ) + std::to_string( width ) + " & b" + std::to_string( width );
+    }
+
+    LogicalMatrix parsed( statement ), product, appended;
+
+    auto report = [ & ]( const std::string &name, const size_t repeats, const auto &function )
+    {
+        size_t counted = allocations, nanoseconds = allocator_nanoseconds;
+        double elapsed = best_time( repeats, function );
+
+        std::cout << "\t" << name << ": " << elapsed << " seconds, " << ( allocations - counted ) / repeats << " allocations, "
+            << ( allocator_nanoseconds - nanoseconds ) / repeats * 1e-9 << " seconds in operator new and delete" << std::endl;
+    };
+
+    for( size_t limit : { LogicalMatrix::default_scratch_limit, ( size_t ) 0 } )
+    {
+        LogicalMatrix::set_scratch_limit( limit );
+        std::cout << "Allocations of " << terms << " AND sets, " << ( limit? "reusing" : "not keeping" ) << " temporary buffers" << std::endl;
+
+        report( "parse", 3, [ & ]{ parsed = LogicalMatrix( statement ); } );
+        report( "product", 3, [ & ]{ product = LogicalMatrix( clauses ); } );
+        report( "negate", 3, [ & ]{ product = ( !LogicalMatrix( negated ) ).to_DNF(); } );
+        report( "and", 3, [ & ]{ product = parsed & LogicalMatrix( "x0 | z" ); } );
+        report( "copy", 3, [ & ]{ product = parsed; } );
+
+        for( LogicalMatrix::Storage storage : { LogicalMatrix::Dense, LogicalMatrix::Sparse } )
+        {
+            report( ( storage == LogicalMatrix::Dense )? "dense append" : "sparse append", 1, [ & ]
+            {
+                appended.clear();
+                appended.set_storage( storage );
+
+                for( size_t term = 0; term < terms / 4; ++term )
+                {
+                    appended += LogicalMatrix( "x" + std::to_string( term ) + " & !y" + std::to_string( term ) + " | z" );
+                }
+            } );
+        }
+
+        std::cout << std::endl;
+    }
+
+    LogicalMatrix::set_scratch_limit( LogicalMatrix::default_scratch_limit );
+}
+
+// dense += of statements that each share z with every earlier one, doubling the appends shows how trimming scales
+void benchmark_append( const size_t appends )
+{
+    double previous = 0;
+
+    std::cout << "Dense append" << std::endl;
+
+    for( size_t count = appends / 4; count <= appends; count *= 2 )
+    {
+        LogicalMatrix appended;
+        double elapsed = best_time( 1, [ & ]
+        {
+            appended.clear();
+
+            for( size_t term = 0; term < count; ++term )
+            {
+                appended += LogicalMatrix( "x" + std::to_string( term ) + " & !y" + std::to_string( term ) + " | z" );
+            }
+        } );
+
+        std::cout << "\t" << count << " statements: " << elapsed << " seconds";
+
+        if( previous > 0 )
+        {
+            std::cout << ", " << elapsed / previous << " times the half";
+        }
+
+        std::cout << std::endl;
+        previous = elapsed;
+    }
+
+    std::cout << std::endl;
+}
+
+// composite rules built one operator at a time, against recording them as a LogicalExpr and materializing it once
+void benchmark_expression( const size_t terms, const size_t clauses )
+{
+    std::vector< LogicalMatrix > products, sums;
+    LogicalMatrix eager, lazy;
+
+    for( size_t index = 0; index < terms; ++index )
+    {
+        products.emplace_back( "x" + std::to_string( index ) + " & !y" + std::to_string( index % 50 ) + " & z" + std::to_string( index % 7 ) );
+    }
+
+    for( size_t index = 0; index < clauses; ++index )
+    {
+        sums.emplace_back( "a" + std::to_string( index ) + ( index % 3 > 0? " | b" + std::to_string( index ) : "" ) + ( index % 3 > 1? " | c" + std::to_string( index ) : "" ) );
+    }
+
+    std::cout << "Expressions of " << terms << " AND sets and " << clauses << " clauses" << std::endl;
+
+    double built = best_time( 1, [ & ]
+    {
+        eager = LogicalMatrix();
+
+        for( LogicalMatrix const& product : products )
+        {
+            eager = eager | product;
+        }
+    } );
+
+    double materialized = best_time( 1, [ & ]
+    {
+        LogicalExpr expression( products[ 0 ] );
+
+        for( size_t index = 1; index < products.size(); ++index )
+        {
+            expression = expression | products[ index ];
+        }
+
+        lazy = expression.materialize();
+    } );
+
+    std::cout << "\tOR of AND sets: operators " << built << " seconds, expression " << materialized << " seconds, equal " << lazy.equivalent( eager ) << std::endl;
+
+    built = best_time( 1, [ & ]
+    {
+        eager = !LogicalMatrix( "c & d" );
+
+        for( LogicalMatrix const& sum : sums )
+        {
+            eager = eager & sum;
+        }
+    } );
+
+    materialized = best_time( 1, [ & ]
+    {
+        LogicalExpr expression = !LogicalExpr( LogicalMatrix( "c & d" ) );
+
+        for( LogicalMatrix const& sum : sums )
+        {
+            expression = expression & sum;
+        }
+
+        lazy = expression.materialize();
+    } );
+
+    std::cout << "\tAND of clauses: operators " << built << " seconds, expression " << materialized << " seconds, " << lazy.statement( 0 ).term_count()
+        << " AND sets" << std::endl << std::endl;
+}
+
+// reloading a matrix from its binary record, against parsing its text
+void benchmark_serialize( const size_t statements )
+{
+    std::mt19937_64 generator( 11 );
+    std::string content;
+
+    for( size_t counter = 0; counter < statements; ++counter )
+    {
+        content += ( counter == 0? "" : ", " );
+
+        for( size_t term = 0; term < 4; ++term )
+        {
+            content += ( term == 0? "t" : " | t" ) + std::to_string( generator() % 5000 ) + " & !t" + std::to_string( generator() % 5000 ) + " & t" + std::to_string( generator() % 5000 );
+        }
+    }
+
+    LogicalMatrix test_matrix( content ), reloaded;
+    std::string text = test_matrix.to_string(), record;
+
+    std::cout << "Serializing " << statements << " statements" << std::endl;
+
+    for( LogicalMatrix::Storage storage : { LogicalMatrix::Dense, LogicalMatrix::Sparse } )
+    {
+        test_matrix.set_storage( storage );
+
+        double written = best_time( 3, [ & ]{ record = test_matrix.serialize(); } );
+        double read = best_time( 3, [ & ]{ reloaded = LogicalMatrix::deserialize( record ); } );
+
+        std::cout << "\t" << ( ( storage == LogicalMatrix::Dense )? "dense" : "sparse" ) << ": serialize " << written << " seconds, deserialize " << read
+            << " seconds, " << record.size() << " bytes, equal " << ( reloaded == test_matrix ) << std::endl;
+    }
+
+    std::cout << "\tparse: " << best_time( 1, [ & ]{ reloaded = LogicalMatrix( text ); } ) << " seconds, " << text.size() << " bytes" << std::endl << std::endl;
+}
+
+// what a worker pays to start from a rule file: parsing its text, reading a serialized record, or mapping a frozen image,
+// then evaluating assignments from the CompiledMatrix built at startup against evaluating the mapped image in place
+void benchmark_freeze( const size_t statements, const size_t assignments )
+{
+    const std::string path = "LogicalMatrixBenchmark.frozen";
+    std::mt19937_64 generator( 13 );
+    std::string content;
+
+    for( size_t counter = 0; counter < statements; ++counter )
+    {
+        content += ( counter == 0? "" : ", " );
+
+        for( size_t term = 0; term < 4; ++term )
+        {
+            content += ( term == 0? "t" : " | t" ) + std::to_string( generator() % 5000 ) + " & !t" + std::to_string( generator() % 5000 ) + " & t" + std::to_string( generator() % 5000 );
+        }
+    }
+
+    LogicalMatrix test_matrix( content ), reloaded;
+    std::string record = test_matrix.serialize();
+    std::ofstream output( path, std::ios::binary );
+    FrozenMatrix frozen;
+    CompiledMatrix compiled;
+
+    test_matrix.freeze().write( output );
+    output.close();
+
+    std::cout << "Starting from " << statements << " statements" << std::endl;
+
+    auto report = [ & ]( const std::string &name, const size_t repeats, const auto &function )
+    {
+        size_t counted = allocations;
+        double elapsed = best_time( repeats, function );
+
+        std::cout << "\t" << name << ": " << elapsed << " seconds, " << ( allocations - counted ) / repeats << " allocations" << std::endl;
+    };
+
+    report( "parse and compile", 1, [ & ]{ compiled = LogicalMatrix( content ).compile(); } );
+    report( "deserialize and compile", 3, [ & ]{ compiled = LogicalMatrix::deserialize( record ).compile(); } );
+    report( "open frozen", 3, [ & ]{ frozen = FrozenMatrix::open( path ); } );
+
+    std::vector< std::map< std::string, bool > > values( assignments );
+    std::vector< CompiledMatrix::Assignment > compiled_assignments;
+    std::vector< FrozenMatrix::Assignment > frozen_assignments;
+    CompiledMatrix::ResultBitset compiled_result = compiled.make_result();
+    FrozenMatrix::ResultBitset frozen_result = frozen.make_result();
+    size_t compiled_true = 0, frozen_true = 0;
+
+    for( std::map< std::string, bool > &assignment : values )
+    {
+        for( size_t identifier = 0; identifier < 5000; ++identifier )
+        {
+            assignment[ "t" + std::to_string( identifier ) ] = generator() & 1;
+        }
+
+        compiled_assignments.push_back( compiled.make_assignment( assignment ) );
+        frozen_assignments.push_back( frozen.make_assignment( assignment ) );
+    }
+
+    report( "compiled evaluate", 3, [ & ]
+    {
+        for( CompiledMatrix::Assignment const& assignment : compiled_assignments )
+        {
+            compiled.evaluate( assignment, compiled_result );
+            compiled_true += compiled_result.count();
+        }
+    } );
+
+    report( "frozen evaluate", 3, [ & ]
+    {
+        for( FrozenMatrix::Assignment const& assignment : frozen_assignments )
+        {
+            frozen.evaluate( assignment, frozen_result );
+            frozen_true += frozen_result.count();
+        }
+    } );
+
+    std::cout << "\t" << frozen.image().size() << " byte image, statements holding " << compiled_true << " and " << frozen_true << std::endl << std::endl;
+    std::remove( path.c_str() );
+}
+
+int main( int argc, char const *argv[] )
+{
+    size_t assignments = ( argc > 1 )? std::stoull( argv[ 1 ] ) : 1 << 24;
+
+    std::cout << "Begin benchmarks" << std::endl << std::endl;
+
+    benchmark_scaling( assignments );
+    benchmark_load( 500 );
+    benchmark_product( 24 );
+    benchmark_minimize( 12, 60 );
+    benchmark_diagram( 16 );
+    benchmark_delta( 5000, 2000 );
+    benchmark_sparse( 5000, 100 );
+    benchmark_storage( 1000, 5000 );
+    benchmark_storage( 1000, 100 );
+    benchmark_split( 10000 );
+    benchmark_allocations( 4000 );
+    benchmark_append( 1000 );
+    benchmark_expression( 2000, 16 );
+    benchmark_serialize( 2000 );
+    benchmark_freeze( 2000, 200 );
+
+    std::cout << "End benchmarks" << std::endl;
+    return 0;
+}
@@ -3,11 +3,62 @@
 /** This file is used to test the correctness of the LogicalMatrix class
  */
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <random>
 #include <string>
 #include "LogicalMatrix.h"
+#include "BitVector.cpp"
+#include "SymbolTable.cpp"
 #include "LogicalMatrix.cpp"
+#include "CompiledMatrix.cpp"
+#include "FrozenMatrix.cpp"
+#include "DecisionDiagram.cpp"
+#include "DeltaEvaluator.cpp"
+#include "StatementView.cpp"
+#include "LogicalExpr.cpp"
+#include "ThreadPool.cpp"
+#include "AssignmentStream.cpp"
+#include "MappedFile.cpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <sstream>
+
+// every allocation through operator new is counted, relaxed as ThreadPool workers allocate alongside the tests
+// all of them are kept out of line so the compiler does not report std::malloc paired with operator delete
+static std::atomic< size_t > allocations( 0 );
+
+__attribute__(( noinline )) void *operator new( size_t size )
+{
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+
+    if( void *memory = std::malloc( size? size : 1 ) )
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+__attribute__(( noinline )) void *operator new( size_t size, const std::nothrow_t & ) noexcept
+{
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    return std::malloc( size? size : 1 );
+}
+
+__attribute__(( noinline )) void operator delete( void *memory ) noexcept
+{
+    std::free( memory );
+}
+
+__attribute__(( noinline )) void operator delete( void *memory, size_t ) noexcept
+{
+    std::free( memory );
+}
 
 // used to print unique identifiers from LogicalMatrix
 std::ostream &operator<<( std::ostream &output, const std::set< std::string > &object_arg )
@@ -233,473 +284,2272 @@ bool test_evaluate_full( const std::string &tested, const bool &display = false
     return result;
 }
 
-// Testing function for Logicalstatementexception during parsing
-bool test_error( const std::string &tested, const bool &display = false )
+// Testing function comparing CompiledMatrix against LogicalMatrix::evaluate for every assignment of the identifiers
+// each assignment is also tried with its first identifier left out
+bool test_compiled( const std::string &tested, const bool &display = false )
 {
-    std::string result;
+    bool result = true;
 
     try
     {
         LogicalMatrix test_matrix( tested );
+        CompiledMatrix compiled = test_matrix.compile();
+        CompiledMatrix::ResultBitset result_bits = compiled.make_result();
+        std::set< std::string > test_values = test_matrix.get_unique_identifiers();
+        size_t counter, isolator, index, length = 1 << test_values.size();
+        std::map< std::string, bool > test_map;
+        std::vector< bool > expected_vector, result_vector;
 
-        if( test_matrix.empty() )
-        {
-            result = "is empty";
-        }
-        else
-        {
-            result = test_matrix.to_string();
-        }
-    }
-    catch( LogicalMatrix::Logicalstatementexception &e )
-    {
-        if( display )
+        for( counter = 0; counter < 2 * length; ++counter )
         {
-            std::cout << "Error caught for \"" << tested << "\": \"" << e.what() << "\"" << std::endl << "Test passed" << std::endl << std::endl;
-        }
+            isolator = counter;
+            test_map.clear();
 
-        return true;
-    }
+            for( std::string const& key : test_values )
+            {
+                test_map[ key ] = ( isolator & 1 );
+                isolator >>= 1;
+            }
 
-    std::cout << "Result: " << result << std::endl << "No error caught for \"" << tested << "\"" << std::endl << "Test FAILED" << std::endl << std::endl;
-    return false;
-}
+            if( isolator & 1 )
+            {
+                test_map.erase( test_map.begin() );
+            }
 
-template< typename Type >
-bool test_equality( const Type &left_value, const Type &right_value, const bool &display = false )
-{
-    bool result = ( left_value == right_value );
+            expected_vector = test_matrix.evaluate( test_map );
+            result_vector = compiled.evaluate( test_map );
+            compiled.evaluate( compiled.make_assignment( test_map ), result_bits );
 
-    if( display | !result )
+            for( index = 0; index < result_vector.size(); ++index )
+            { // marks any disagreement between the two compiled evaluate functions as a failure
+                result_vector[ index ] = ( result_bits[ index ] == result_vector[ index ] )? result_vector[ index ] : !expected_vector[ index ];
+            }
+
+            if( display || result_vector != expected_vector )
+            {
+                result &= ( result_vector == expected_vector );
+                std::cout << "Testing \"" << test_matrix << "\" with compiled evaluate function\nusing " << test_map << std::endl
+                    << result_vector << " expected " << expected_vector << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+            }
+        }
+    }
+    catch( LogicalMatrix::Logicalstatementexception &e )
     {
-        std::cout << "Testing equality of \"" << left_value << "\" with \"" << right_value << "\"" << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
     }
 
     return result;
 }
 
-bool test_equality( const size_t &left_value, const int &right_value, const bool &display = false )
-{
-    return test_equality( (int) left_value, right_value, display );
-}
-
-int main( int argc, char const *argv[] )
+// Testing function comparing FrozenMatrix against LogicalMatrix::evaluate for every assignment of the identifiers,
+// frozen from tested and from its CNF negation, each assignment is also tried with its first identifier left out
+bool test_frozen( const std::string &tested, const bool &display = false )
 {
-    std::chrono::high_resolution_clock::time_point time_start = std::chrono::high_resolution_clock::now();
     bool result = true;
 
-    if( true )
+    try
     {
-        result &= test( "!a & a", "a & !a" );
-        result &= test( " d & c & b & a", "a & b & c & d" );
-        result &= test( " a & b & c & space space", "a & b & c & space space" );
-        result &= test( "NOTaANDb&cORd", "!a & b & c | d" );
-        result &= test( "a && NOT b || c & d ", "a & !b | c & d" );
-        result &= test( "a &  b | !c | space     space", "a & b | !c | space     space" );
-        result &= test( "a  |  b & c & !       d", "a | b & c & !d" );
-        result &= test( "!a|b&c|!d", "!a | b & c | !d" );
-        result &= test( "a | !b | ! !  !c AND d", "a | !b | !c & d" );
-        result &= test( "!a | !!b OR !!!c | !!!!d", "!a | b | !c | d" );
-    }
+        LogicalMatrix test_matrix( tested );
+        std::set< std::string > test_values = test_matrix.get_unique_identifiers();
+        size_t counter, isolator, index, length = 1 << test_values.size();
+        std::map< std::string, bool > test_map;
+        std::vector< bool > expected_vector, result_vector;
 
-    if( true )
-    {
-        try
+        for( LogicalMatrix const& matrix : { test_matrix, !test_matrix } )
         {
-            if( true )
+            FrozenMatrix frozen = matrix.freeze();
+            FrozenMatrix::ResultBitset result_bits = frozen.make_result();
+
+            for( counter = 0; counter < 2 * length; ++counter )
             {
-                LogicalMatrix left_value( "a & b" );
-                LogicalMatrix right_values[] = {
-                    LogicalMatrix(),
-                    LogicalMatrix( "c & d" ),
-                    LogicalMatrix( "a & b" ),
-                    LogicalMatrix( "a | a & b | a & c" )
-                };
+                isolator = counter;
+                test_map.clear();
 
-                std::string OR_expected[] = { "a & b", "a & b | c & d", "a & b", "a" };
-                std::string AND_expected[] = { "a & b", "a & b & c & d", "a & b", "a & b" };
+                for( std::string const& key : test_values )
+                {
+                    test_map[ key ] = ( isolator & 1 );
+                    isolator >>= 1;
+                }
 
-                for( short index = 0; index < 4; ++index )
+                if( isolator & 1 )
                 {
-                    result &= test( left_value | right_values[ index ], OR_expected[ index ] )
-                            & test( left_value & right_values[ index ], AND_expected[ index ] );
+                    test_map.erase( test_map.begin() );
                 }
-            }
 
-            if( true )
-            {
-                LogicalMatrix left_value( "a & b" );
-                LogicalMatrix right_values[] = {
-                    LogicalMatrix(),
-                    LogicalMatrix( "c & d" ),
-                    LogicalMatrix( "a & b" ),
-                    LogicalMatrix( "a | a & b | a & c" )
-                };
+                expected_vector = matrix.evaluate( test_map );
+                result_vector = frozen.evaluate( test_map );
+                frozen.evaluate( frozen.make_assignment( test_map ), result_bits );
 
-                std::string OR_expected[] = { "a & b", "a & b | c & d", "a & b | c & d", "c & d | a" };
+                for( index = 0; index < result_vector.size(); ++index )
+                { // marks any disagreement between the two frozen evaluate functions as a failure
+                    result_vector[ index ] = ( result_bits[ index ] == result_vector[ index ] )? result_vector[ index ] : !expected_vector[ index ];
+                }
 
-                for( short index = 0; index < 4; ++index )
+                if( display || result_vector != expected_vector )
                 {
-                    result &= test( left_value.OR( right_values[ index ] ), OR_expected[ index ] );
+                    result &= ( result_vector == expected_vector );
+                    std::cout << "Testing \"" << matrix << "\" with frozen evaluate function\nusing " << test_map << std::endl
+                        << result_vector << " expected " << expected_vector << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
                 }
             }
+        }
+    }
+    catch( LogicalMatrix::Logicalstatementexception &e )
+    {
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+    }
 
-            if( true )
-            {
-                LogicalMatrix left_value( "a & b" );
-                LogicalMatrix right_values[] = {
-                    LogicalMatrix(),
-                    LogicalMatrix( "c & d" ),
-                    LogicalMatrix( "a & b" ),
-                    LogicalMatrix( "a | a & b | a & c" )
-                };
+    return result;
+}
 
-                std::string AND_expected[] = { "a & b", "a & b & c & d", "a & b & c & d", "a & b & c & d" };
+// Testing function comparing each supported bit sliced kernel against LogicalMatrix::evaluate
+// every identifier is known in a batch, so only full assignments are tried, each kernel also runs split across a pool
+bool test_batch( const std::string &tested, const size_t &assignments = 1000, const bool &display = false )
+{
+    static ThreadPool pool( 4 );
 
-                for( short index = 0; index < 4; ++index )
-                {
-                    result &= test( left_value.AND( right_values[ index ] ), AND_expected[ index ] );
-                }
-            }
+    bool result = true;
 
-            if( true )
-            {
-                result &= test( LogicalMatrix( "!a & b & c" ) | LogicalMatrix( "d & !e & f" ) | LogicalMatrix( "g & h & !i" ),
-                    "!a & b & c | d & !e & f | g & h & !i" );
+    try
+    {
+        LogicalMatrix test_matrix( tested );
+        CompiledMatrix compiled = test_matrix.compile();
+        CompiledMatrix::BitSlice batch = compiled.make_batch( assignments );
+        std::set< std::string > test_values = test_matrix.get_unique_identifiers();
+        std::vector< std::vector< bool > > expected;
+        size_t counter, isolator, index, length = 1 << test_values.size();
+        std::map< std::string, bool > test_map;
 
-                result &= test( LogicalMatrix( "!a | b | c" ) & LogicalMatrix( "d | !e | f" ) & LogicalMatrix( "g | h | !i" ),
-                    "!a & d & g | !a & d & h | !a & d & !i | !a & !e & g | !a & !e & h | !a & !e & !i | !a & f & g | !a & f & h | !a & f & !i | b & d & g | b & d & h | b & d & !i | b & !e & g | b & !e & h | b & !e & !i | b & f & g | b & f & h | b & f & !i | c & d & g | c & d & h | c & d & !i | c & !e & g | c & !e & h | c & !e & !i | c & f & g | c & f & h | c & f & !i" );
-            }
+        for( counter = 0; counter < assignments; ++counter )
+        {
+            isolator = ( counter * 7 + counter / length ) % length;
+            test_map.clear();
 
-            if( true )
+            for( std::string const& key : test_values )
             {
-                result &= test( !LogicalMatrix( "a & b" ), "!a | !b" );
-                result &= test( LogicalMatrix( "a & b" ).NOT(), "!a | !b" );
-                result &= test( !LogicalMatrix( "!a | !b" ), "a & b" );
-                result &= test( LogicalMatrix( "!a | !b" ).NOT(), "a & b" );
-                result &= test( !LogicalMatrix( "a & !b | c & d" ), "!a & !c | !a & !d | b & !c | b & !d" );
-                result &= test( LogicalMatrix( "a & !b | c & d" ).NOT(), "!a & !c | !a & !d | b & !c | b & !d" );
-                result &= test( LogicalMatrix( "a & !b | c & d" ).NOT( 0 ), "!a & !c | !a & !d | b & !c | b & !d" );
-                result &= test( !LogicalMatrix( "!a & b & c | d & !e & f | g & h & !i" ),
-                    "a & !d & !g | a & !d & !h | a & !d & i | a & e & !g | a & e & !h | a & e & i | a & !f & !g | a & !f & !h | a & !f & i | !b & !d & !g | !b & !d & !h | !b & !d & i | !b & e & !g | !b & e & !h | !b & e & i | !b & !f & !g | !b & !f & !h | !b & !f & i | !c & !d & !g | !c & !d & !h | !c & !d & i | !c & e & !g | !c & e & !h | !c & e & i | !c & !f & !g | !c & !f & !h | !c & !f & i" );
+                test_map[ key ] = ( isolator & 1 );
+                batch.set( test_matrix.symbol_table()->find( key ), counter, isolator & 1 );
+                isolator >>= 1;
             }
+
+            expected.push_back( test_matrix.evaluate( test_map ) );
         }
-        catch( LogicalMatrix::Logicalstatementexception &e )
+
+        for( int kernel = CompiledMatrix::Scalar; kernel <= CompiledMatrix::supported_kernel(); ++kernel )
         {
-            result = false;
-            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+            CompiledMatrix::BitSlice results = compiled.make_batch_result( assignments );
+            bool kernel_result = true;
+
+            CompiledMatrix::BitSlice pooled_results = compiled.make_batch_result( assignments );
+
+            compiled.evaluate_batch( batch, results, ( CompiledMatrix::Kernel ) kernel );
+            compiled.evaluate_batch( batch, pooled_results, pool, 3, ( CompiledMatrix::Kernel ) kernel );
+
+            for( counter = 0; counter < assignments; ++counter )
+            {
+                for( index = 0; index < results.rows(); ++index )
+                {
+                    kernel_result &= ( results.get( index, counter ) == expected[ counter ][ index ] );
+                    kernel_result &= ( pooled_results.get( index, counter ) == expected[ counter ][ index ] );
+                }
+            }
+
+            if( display || !kernel_result )
+            {
+                result &= kernel_result;
+                std::cout << "Testing \"" << test_matrix << "\" with bit sliced kernel " << kernel << " over " << assignments
+                    << " assignments" << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+            }
         }
     }
-
-    if( true )
+    catch( LogicalMatrix::Logicalstatementexception &e )
     {
-        result &= test( "( a | b ) & c", "a & c | b & c" );
-        result &= test( " a & (b || c) | d", "a & b | a & c | d" );
-        result &= test( "a && (b | c) & d ", "a & b & d | a & c & d" );
-        result &= test( "a || (b && c) & d", "a | b & c & d" );
-        result &= test( "a | (c & b) | d", "a | b & c | d" );
-        result &= test( "(a | c) AND (b | d)", "a & b | a & d | b & c | c & d" );
-        result &= test( "(a & c) OR (b & d)", "a & c | b & d" );
-        result &= test( "!(a | b) | !( c & d ) | !(!a) | !!a", "!a & !b | !c | !d | a" );
-        result &= test( "a & ( b | ( c & d ) )", "a & b | a & c & d" );
-        result &= test( " a & ( b & ( c | d ) ) ", "a & b & c | a & b & d" );
-        result &= test( "((a & b))", "a & b" );
-        result &= test( "a | ( a & b | a & c)", "a" );
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
     }
 
-    if( true )
-    {
-        result &= test( "a & b, c | d", "a & b, c | d" );
-        result &= test( "a & b | e & f, c | d | e & f", "a & b | e & f, e & f | c | d" );
-        result &= test( "a & b, a & b | d & e\na & b | c | d, c | d", "a & b, a & b | d & e, a & b | c | d, c | d" );
-        result &= test( "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, e | c | d", "a | b, a & b | c & d, a & b | e, a | b | c | d, c | d, e | c | d" );
-    }
+    return result;
+}
 
-    if( true )
-    {
-        result &= test( "( a & b, c | d ) | e & f", "a & b | e & f, c | d | e & f" );
-        result &= test( "e & f & ( a & b, c | d )", "a & b & e & f, c & e & f | d & e & f" );
-        result &= test( "( a & b, c | d ) , e & f", "a & b, c | d, e & f" );
-        result &= test( "( a & b, c | d ) | ( a & b, d & e )", "a & b, a & b | d & e, a & b | c | d, c | d" );
-        result &= test( "( a & b, c | d ) & ( a & b, d & e )", "a & b, a & b & d & e, a & b & c | a & b & d, d & e" );
-        result &= test( "( a & b, c | d ) , ( a & b, d & e )", "a & b, c | d, a & b, d & e" );
-        result &= test( "( a & b, c | d ) | ( a | b, c & d, e )", "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, c | d | e" );
-        result &= test( "( a & b, c | d ) & ( a | b, c & d, e )", "a & b, a & b & c & d, a & b & e, a & c | b & c | a & d | b & d, c & d, c & e | d & e" );
-        result &= test( "( a & b, c | d ) , ( a | b, c & d, e )", "a & b, c | d, a | b, c & d, e" );
-    }
+// Testing function streaming every assignment of the identifiers, plus an unused column, from a text and a binary file
+// batch_assignments is kept small so rows span several batches
+bool test_stream( const std::string &tested, const char delimiter = ',', const bool &display = false )
+{
+    static ThreadPool pool( 3 );
+    const std::string path = "LogicalMatrixTest.stream";
+    bool result = true;
 
-    if( true )
+    try
     {
-        try
+        LogicalMatrix test_matrix( tested );
+        CompiledMatrix compiled = test_matrix.compile();
+        std::set< std::string > test_values = test_matrix.get_unique_identifiers();
+        std::vector< std::string > names( test_values.begin(), test_values.end() ), statement_names;
+        size_t counter, index, length = 1 << names.size();
+        CompiledMatrix::BitSlice columns( names.size() + 1, length ), expected_columns( compiled.statement_count(), length );
+        std::ostringstream text, expected_text, binary, expected_binary;
+        std::map< std::string, bool > test_map;
+        std::vector< bool > expected;
+
+        names.push_back( "unused column" );
+        text << names[ 0 ];
+
+        for( index = 1; index < names.size(); ++index )
         {
-            if( true )
+            text << delimiter << names[ index ];
+        }
+
+        text << "\r\n";
+
+        for( counter = 0; counter < length; ++counter )
+        {
+            test_map.clear();
+
+            for( index = 0; index < names.size(); ++index )
             {
-                LogicalMatrix left_value( "a & b" );
-                LogicalMatrix right_values[] = {
-                    LogicalMatrix(),
-                    LogicalMatrix( "c & d" ),
-                    LogicalMatrix( "a & b" ),
-                    LogicalMatrix( "a & c" ),
-                    LogicalMatrix( "a | a & b | a & c" )
-                };
+                bool value = ( index + 1 == names.size() )? counter & 1 : ( counter >> index ) & 1;
 
-                std::string ADD_expected[] = { "a & b", "a & b, c & d", "a & b, a & b", "a & b, a & c", "a & b, a" };
+                text << ( index == 0? "" : std::string( 1, delimiter ) ) << value;
+                columns.set( index, counter, value );
 
-                for( short index = 0; index < 5; ++index )
+                if( index + 1 != names.size() )
                 {
-                    result &= test( left_value + right_values[ index ], ADD_expected[ index ] );
+                    test_map[ names[ index ] ] = value;
                 }
             }
 
-            if( true )
+            text << std::endl;
+            expected = test_matrix.evaluate( test_map );
+
+            for( index = 0; index < expected.size(); ++index )
             {
-                LogicalMatrix left_value( "a & b" );
-                LogicalMatrix right_values[] = {
+                expected_text << ( index == 0? "" : std::string( 1, delimiter ) ) << expected[ index ];
+                expected_columns.set( index, counter, expected[ index ] );
+            }
+
+            expected_text << std::endl;
+        }
+
+        std::ofstream( path, std::ios::binary ) << text.str();
+        AssignmentStream( path ).evaluate( compiled, binary, 5 );
+        result &= ( binary.str() == expected_text.str() );
+        binary.str( "" );
+        AssignmentStream( path ).evaluate( compiled, binary, 100, &pool );
+        result &= ( binary.str() == expected_text.str() );
+
+        for( index = 0; index < compiled.statement_count(); ++index )
+        {
+            statement_names.push_back( std::to_string( index ) );
+        }
+
+        { // two blocks of the same assignments, evaluated in batches cutting across them
+            std::ofstream binary_file( path, std::ios::binary );
+            AssignmentStream::write_header( binary_file, names );
+            AssignmentStream::write_block( binary_file, columns );
+            AssignmentStream::write_block( binary_file, columns, length / 2 + 1 );
+        }
+
+        auto write_expected = [ & ]( const size_t begin, const size_t end )
+        {
+            CompiledMatrix::BitSlice block( expected_columns.rows(), end - begin );
+
+            for( size_t assignment = begin; assignment < end; ++assignment )
+            {
+                for( size_t row = 0; row < block.rows(); ++row )
+                {
+                    block.set( row, assignment - begin, expected_columns.get( row, assignment ) );
+                }
+            }
+
+            AssignmentStream::write_block( expected_binary, block );
+        };
+
+        AssignmentStream::write_header( expected_binary, statement_names );
+
+        for( counter = 0; counter < length; counter += 64 )
+        {
+            write_expected( counter, std::min( length, counter + 64 ) );
+        }
+
+        for( counter = 0; counter < length / 2 + 1; counter += 64 )
+        {
+            write_expected( counter, std::min( length / 2 + 1, counter + 64 ) );
+        }
+
+        binary.str( "" );
+        AssignmentStream( path ).evaluate( compiled, binary, 64 );
+        result &= ( binary.str() == expected_binary.str() );
+        binary.str( "" );
+        AssignmentStream( path ).evaluate( compiled, binary, 64, &pool );
+        result &= ( binary.str() == expected_binary.str() );
+
+        result &= ( AssignmentStream( path ).format() == AssignmentStream::Binary );
+        result &= ( AssignmentStream( path ).columns() == names );
+
+        if( display || !result )
+        {
+            std::cout << "Testing \"" << test_matrix << "\" streamed from files" << std::endl << "Test "<< ( result? "passed" : "FAILED" )
+                << std::endl << std::endl;
+        }
+    }
+    catch( std::exception &e )
+    {
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in streaming" << std::endl << std::endl;
+    }
+
+    std::remove( path.c_str() );
+    return result;
+}
+
+// Testing function comparing LogicalMatrix::load of a file holding tested against parsing tested directly
+// a trailing newline and blank lines are added to the file, which load skips
+bool test_load( const std::string &tested, const bool &display = false )
+{
+    static ThreadPool pool( 3 );
+    const std::string path = "LogicalMatrixTest.rules";
+    bool result = true;
+
+    try
+    {
+        LogicalMatrix expected( tested );
+        std::string content = "\n" + tested + "\n \n";
+
+        std::ofstream( path, std::ios::binary ) << content;
+
+        LogicalMatrix serial = LogicalMatrix::load( path ), parallel = LogicalMatrix::load( path, &pool );
+
+        result = ( serial.to_string() == expected.to_string() ) && ( parallel.to_string() == expected.to_string() );
+
+        if( display || !result )
+        {
+            std::cout << "Testing loading \"" << tested << "\" from a file" << std::endl << "Result: " << serial << std::endl
+                << "Parallel result: " << parallel << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+        }
+    }
+    catch( std::exception &e )
+    {
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in loading" << std::endl << std::endl;
+    }
+
+    std::remove( path.c_str() );
+    return result;
+}
+
+// Testing function for Logicalstatementexception during parsing
+bool test_error( const std::string &tested, const bool &display = false )
+{
+    std::string result;
+
+    try
+    {
+        LogicalMatrix test_matrix( tested );
+
+        if( test_matrix.empty() )
+        {
+            result = "is empty";
+        }
+        else
+        {
+            result = test_matrix.to_string();
+        }
+    }
+    catch( LogicalMatrix::Logicalstatementexception &e )
+    {
+        if( display )
+        {
+            std::cout << "Error caught for \"" << tested << "\": \"" << e.what() << "\"" << std::endl << "Test passed" << std::endl << std::endl;
+        }
+
+        return true;
+    }
+
+    std::cout << "Result: " << result << std::endl << "No error caught for \"" << tested << "\"" << std::endl << "Test FAILED" << std::endl << std::endl;
+    return false;
+}
+
+template< typename Type >
+bool test_equality( const Type &left_value, const Type &right_value, const bool &display = false )
+{
+    bool result = ( left_value == right_value );
+
+    if( display | !result )
+    {
+        std::cout << "Testing equality of \"" << left_value << "\" with \"" << right_value << "\"" << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+    }
+
+    return result;
+}
+
+bool test_equality( const size_t &left_value, const int &right_value, const bool &display = false )
+{
+    return test_equality( (int) left_value, right_value, display );
+}
+
+// Testing function comparing the CNF negation of tested against its expansion into DNF
+// every assignment is evaluated directly, after expansion and compiled, also with the first identifier left out
+bool test_negated( const std::string &tested, const bool &display = false )
+{
+    bool result = true;
+
+    try
+    {
+        LogicalMatrix test_matrix( tested ), negated = !test_matrix, expanded = negated.to_DNF();
+        CompiledMatrix compiled = negated.compile();
+        std::set< std::string > test_values = test_matrix.get_unique_identifiers();
+        size_t counter, isolator, length = 1 << test_values.size();
+        std::map< std::string, bool > test_map;
+        std::vector< bool > expected_vector;
+
+        result &= test_equality( negated.form() == LogicalMatrix::CNF, true );
+        result &= test_equality( expanded.form() == LogicalMatrix::DNF, true );
+        result &= test_equality( !negated, test_matrix );
+        result &= test( negated, LogicalMatrix( "!( " + tested + " )" ).to_string(), display );
+
+        for( counter = 0; counter < 2 * length; ++counter )
+        {
+            isolator = counter;
+            test_map.clear();
+
+            for( std::string const& key : test_values )
+            {
+                test_map[ key ] = ( isolator & 1 );
+                isolator >>= 1;
+            }
+
+            if( isolator & 1 )
+            {
+                test_map.erase( test_map.begin() );
+            }
+
+            expected_vector = expanded.evaluate( test_map );
+
+            if( display || negated.evaluate( test_map ) != expected_vector || compiled.evaluate( test_map ) != expected_vector )
+            {
+                result &= ( negated.evaluate( test_map ) == expected_vector && compiled.evaluate( test_map ) == expected_vector );
+                std::cout << "Testing \"" << negated << "\" in CNF\nusing " << test_map << std::endl << negated.evaluate( test_map )
+                    << " expected " << expected_vector << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+            }
+        }
+    }
+    catch( LogicalMatrix::Logicalstatementexception &e )
+    {
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+    }
+
+    return result;
+}
+
+// Testing function for minimize in mode, the result must match expected and evaluate like tested for every full assignment
+bool test_minimize( const std::string &tested, const std::string &expected, const LogicalMatrix::Minimization &mode = LogicalMatrix::Automatic,
+    const bool &display = false )
+{
+    bool result = true;
+
+    try
+    {
+        LogicalMatrix test_matrix( tested ), minimized( test_matrix );
+        std::set< std::string > test_values = test_matrix.get_unique_identifiers();
+        size_t counter, isolator, length = 1 << test_values.size();
+        std::map< std::string, bool > test_map;
+
+        minimized.minimize( mode );
+        result &= test( minimized, expected, display );
+
+        for( counter = 0; counter < length; ++counter )
+        {
+            isolator = counter;
+
+            for( std::string const& key : test_values )
+            {
+                test_map[ key ] = ( isolator & 1 );
+                isolator >>= 1;
+            }
+
+            if( display || minimized.evaluate( test_map ) != test_matrix.evaluate( test_map ) )
+            {
+                result &= ( minimized.evaluate( test_map ) == test_matrix.evaluate( test_map ) );
+                std::cout << "Testing minimized \"" << minimized << "\" against \"" << test_matrix << "\"\nusing " << test_map << std::endl
+                    << minimized.evaluate( test_map ) << " expected " << test_matrix.evaluate( test_map ) << std::endl
+                    << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+            }
+        }
+    }
+    catch( LogicalMatrix::Logicalstatementexception &e )
+    {
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+    }
+
+    return result;
+}
+
+// Testing function for DecisionDiagram, converting back must give expected and evaluate like tested for every full assignment
+// and like the converted matrix when an identifier is missing
+bool test_diagram( const std::string &tested, const std::string &expected, const std::vector< std::string > &order = {}, const bool &display = false )
+{
+    bool result = true;
+
+    try
+    {
+        LogicalMatrix test_matrix( tested );
+        DecisionDiagram diagram( test_matrix, order );
+        LogicalMatrix converted = diagram.to_matrix();
+        std::set< std::string > test_values = test_matrix.get_unique_identifiers();
+        size_t counter, isolator, length = 1 << test_values.size();
+        std::map< std::string, bool > test_map;
+
+        result &= test( converted, expected, display );
+        result &= test_equality( DecisionDiagram( converted, diagram.manager() ) == diagram, true );
+
+        for( counter = 0; counter < 2 * length; ++counter )
+        {
+            isolator = counter;
+            test_map.clear();
+
+            for( std::string const& key : test_values )
+            {
+                test_map[ key ] = ( isolator & 1 );
+                isolator >>= 1;
+            }
+
+            if( isolator & 1 )
+            {
+                test_map.erase( test_map.begin() );
+            }
+
+            const std::vector< bool > expected_vector = ( isolator & 1 )? converted.evaluate( test_map ) : test_matrix.evaluate( test_map );
+
+            if( display || diagram.evaluate( test_map ) != expected_vector )
+            {
+                result &= ( diagram.evaluate( test_map ) == expected_vector );
+                std::cout << "Testing diagram of \"" << test_matrix << "\"\nusing " << test_map << std::endl << diagram.evaluate( test_map )
+                    << " expected " << expected_vector << std::endl << "Test "<< ( result? "passed" : "FAILED" ) << std::endl << std::endl;
+            }
+        }
+    }
+    catch( LogicalMatrix::Logicalstatementexception &e )
+    {
+        result = false;
+        std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+    }
+
+    return result;
+}
+
+int main( int argc, char const *argv[] )
+{
+    std::chrono::high_resolution_clock::time_point time_start = std::chrono::high_resolution_clock::now();
+    bool result = true;
+
+    if( true )
+    {
+        result &= test( "!a & a", "a & !a" );
+        result &= test( " d & c & b & a", "a & b & c & d" );
+        result &= test( " a & b & c & space space", "a & b & c & space space" );
+        result &= test( "NOTaANDb&cORd", "!a & b & c | d" );
+        result &= test( "a && NOT b || c & d ", "a & !b | c & d" );
+        result &= test( "a &  b | !c | space     space", "a & b | !c | space     space" );
+        result &= test( "a  |  b & c & !       d", "a | b & c & !d" );
+        result &= test( "!a|b&c|!d", "!a | b & c | !d" );
+        result &= test( "a | !b | ! !  !c AND d", "a | !b | !c & d" );
+        result &= test( "!a | !!b OR !!!c | !!!!d", "!a | b | !c | d" );
+    }
+
+    if( true )
+    {
+        try
+        {
+            if( true )
+            {
+                LogicalMatrix left_value( "a & b" );
+                LogicalMatrix right_values[] = {
                     LogicalMatrix(),
                     LogicalMatrix( "c & d" ),
                     LogicalMatrix( "a & b" ),
-                    LogicalMatrix( "a & c" ),
                     LogicalMatrix( "a | a & b | a & c" )
                 };
 
-                std::string ADD_expected[] = { "a & b", "a & b, c & d", "a & b, c & d, a & b", "a & b, c & d, a & b, a & c", "a & b, c & d, a & b, a & c, a" };
+                std::string OR_expected[] = { "a & b", "a & b | c & d", "a & b", "a" };
+                std::string AND_expected[] = { "a & b", "a & b & c & d", "a & b", "a & b" };
 
-                for( short index = 0; index < 5; ++index )
+                for( short index = 0; index < 4; ++index )
                 {
-                    result &= test( left_value.ADD( right_values[ index ] ), ADD_expected[ index ] );
+                    result &= test( left_value | right_values[ index ], OR_expected[ index ] )
+                            & test( left_value & right_values[ index ], AND_expected[ index ] );
+                }
+            }
+
+            if( true )
+            {
+                LogicalMatrix left_value( "a & b" );
+                LogicalMatrix right_values[] = {
+                    LogicalMatrix(),
+                    LogicalMatrix( "c & d" ),
+                    LogicalMatrix( "a & b" ),
+                    LogicalMatrix( "a | a & b | a & c" )
+                };
+
+                std::string OR_expected[] = { "a & b", "a & b | c & d", "a & b | c & d", "c & d | a" };
+
+                for( short index = 0; index < 4; ++index )
+                {
+                    result &= test( left_value.OR( right_values[ index ] ), OR_expected[ index ] );
+                }
+            }
+
+            if( true )
+            {
+                LogicalMatrix left_value( "a & b" );
+                LogicalMatrix right_values[] = {
+                    LogicalMatrix(),
+                    LogicalMatrix( "c & d" ),
+                    LogicalMatrix( "a & b" ),
+                    LogicalMatrix( "a | a & b | a & c" )
+                };
+
+                std::string AND_expected[] = { "a & b", "a & b & c & d", "a & b & c & d", "a & b & c & d" };
+
+                for( short index = 0; index < 4; ++index )
+                {
+                    result &= test( left_value.AND( right_values[ index ] ), AND_expected[ index ] );
+                }
+            }
+
+            if( true )
+            {
+                result &= test( LogicalMatrix( "!a & b & c" ) | LogicalMatrix( "d & !e & f" ) | LogicalMatrix( "g & h & !i" ),
+                    "!a & b & c | d & !e & f | g & h & !i" );
+
+                result &= test( LogicalMatrix( "!a | b | c" ) & LogicalMatrix( "d | !e | f" ) & LogicalMatrix( "g | h | !i" ),
+                    "!a & d & g | !a & d & h | !a & d & !i | !a & !e & g | !a & !e & h | !a & !e & !i | !a & f & g | !a & f & h | !a & f & !i | b & d & g | b & d & h | b & d & !i | b & !e & g | b & !e & h | b & !e & !i | b & f & g | b & f & h | b & f & !i | c & d & g | c & d & h | c & d & !i | c & !e & g | c & !e & h | c & !e & !i | c & f & g | c & f & h | c & f & !i" );
+            }
+
+            if( true )
+            {
+                result &= test( !LogicalMatrix( "a & b" ), "!a | !b" );
+                result &= test( LogicalMatrix( "a & b" ).NOT(), "!a | !b" );
+                result &= test( !LogicalMatrix( "!a | !b" ), "a & b" );
+                result &= test( LogicalMatrix( "!a | !b" ).NOT(), "a & b" );
+                result &= test( !LogicalMatrix( "a & !b | c & d" ), "!a & !c | !a & !d | b & !c | b & !d" );
+                result &= test( LogicalMatrix( "a & !b | c & d" ).NOT(), "!a & !c | !a & !d | b & !c | b & !d" );
+                result &= test( LogicalMatrix( "a & !b | c & d" ).NOT( 0 ), "!a & !c | !a & !d | b & !c | b & !d" );
+                result &= test( !LogicalMatrix( "!a & b & c | d & !e & f | g & h & !i" ),
+                    "a & !d & !g | a & !d & !h | a & !d & i | a & e & !g | a & e & !h | a & e & i | a & !f & !g | a & !f & !h | a & !f & i | !b & !d & !g | !b & !d & !h | !b & !d & i | !b & e & !g | !b & e & !h | !b & e & i | !b & !f & !g | !b & !f & !h | !b & !f & i | !c & !d & !g | !c & !d & !h | !c & !d & i | !c & e & !g | !c & e & !h | !c & e & i | !c & !f & !g | !c & !f & !h | !c & !f & i" );
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        result &= test( "( a | b ) & c", "a & c | b & c" );
+        result &= test( " a & (b || c) | d", "a & b | a & c | d" );
+        result &= test( "a && (b | c) & d ", "a & b & d | a & c & d" );
+        result &= test( "a || (b && c) & d", "a | b & c & d" );
+        result &= test( "a | (c & b) | d", "a | b & c | d" );
+        result &= test( "(a | c) AND (b | d)", "a & b | a & d | b & c | c & d" );
+        result &= test( "(a & c) OR (b & d)", "a & c | b & d" );
+        result &= test( "!(a | b) | !( c & d ) | !(!a) | !!a", "!a & !b | !c | !d | a" );
+        result &= test( "a & ( b | ( c & d ) )", "a & b | a & c & d" );
+        result &= test( " a & ( b & ( c | d ) ) ", "a & b & c | a & b & d" );
+        result &= test( "((a & b))", "a & b" );
+        result &= test( "a | ( a & b | a & c)", "a" );
+    }
+
+    if( true )
+    {
+        result &= test( "a & b, c | d", "a & b, c | d" );
+        result &= test( "a & b | e & f, c | d | e & f", "a & b | e & f, e & f | c | d" );
+        result &= test( "a & b, a & b | d & e\na & b | c | d, c | d", "a & b, a & b | d & e, a & b | c | d, c | d" );
+        result &= test( "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, e | c | d", "a | b, a & b | c & d, a & b | e, a | b | c | d, c | d, e | c | d" );
+    }
+
+    if( true )
+    {
+        result &= test( "( a & b, c | d ) | e & f", "a & b | e & f, c | d | e & f" );
+        result &= test( "e & f & ( a & b, c | d )", "a & b & e & f, c & e & f | d & e & f" );
+        result &= test( "( a & b, c | d ) , e & f", "a & b, c | d, e & f" );
+        result &= test( "( a & b, c | d ) | ( a & b, d & e )", "a & b, a & b | d & e, a & b | c | d, c | d" );
+        result &= test( "( a & b, c | d ) & ( a & b, d & e )", "a & b, a & b & d & e, a & b & c | a & b & d, d & e" );
+        result &= test( "( a & b, c | d ) , ( a & b, d & e )", "a & b, c | d, a & b, d & e" );
+        result &= test( "( a & b, c | d ) | ( a | b, c & d, e )", "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, c | d | e" );
+        result &= test( "( a & b, c | d ) & ( a | b, c & d, e )", "a & b, a & b & c & d, a & b & e, a & c | b & c | a & d | b & d, c & d, c & e | d & e" );
+        result &= test( "( a & b, c | d ) , ( a | b, c & d, e )", "a & b, c | d, a | b, c & d, e" );
+    }
+
+    if( true )
+    {
+        try
+        {
+            if( true )
+            {
+                LogicalMatrix left_value( "a & b" );
+                LogicalMatrix right_values[] = {
+                    LogicalMatrix(),
+                    LogicalMatrix( "c & d" ),
+                    LogicalMatrix( "a & b" ),
+                    LogicalMatrix( "a & c" ),
+                    LogicalMatrix( "a | a & b | a & c" )
+                };
+
+                std::string ADD_expected[] = { "a & b", "a & b, c & d", "a & b, a & b", "a & b, a & c", "a & b, a" };
+
+                for( short index = 0; index < 5; ++index )
+                {
+                    result &= test( left_value + right_values[ index ], ADD_expected[ index ] );
+                }
+            }
+
+            if( true )
+            {
+                LogicalMatrix left_value( "a & b" );
+                LogicalMatrix right_values[] = {
+                    LogicalMatrix(),
+                    LogicalMatrix( "c & d" ),
+                    LogicalMatrix( "a & b" ),
+                    LogicalMatrix( "a & c" ),
+                    LogicalMatrix( "a | a & b | a & c" )
+                };
+
+                std::string ADD_expected[] = { "a & b", "a & b, c & d", "a & b, c & d, a & b", "a & b, c & d, a & b, a & c", "a & b, c & d, a & b, a & c, a" };
+
+                for( short index = 0; index < 5; ++index )
+                {
+                    result &= test( left_value.ADD( right_values[ index ] ), ADD_expected[ index ] );
+                }
+            }
+
+            if( true )
+            {
+                result &= test( LogicalMatrix( "!a & b & c" ) + LogicalMatrix( "d & !e & f" ) + LogicalMatrix( "g & h & !i" ), "!a & b & c, d & !e & f, g & h & !i" );
+                result &= test( LogicalMatrix( "!a & b & c" ) + LogicalMatrix( "a & !b & c" ) + LogicalMatrix( "a & b & !c" ), "!a & b & c, a & !b & c, a & b & !c" );
+            }
+
+            if( true )
+            {
+                LogicalMatrix left_value( "a & b, c | d" );
+                LogicalMatrix right_values[] = {
+                    LogicalMatrix(),
+                    LogicalMatrix( "e & f" ),
+                    LogicalMatrix( "a & b, d & e" ),
+                    LogicalMatrix( "a | b, c & d, e" )
+                };
+
+                std::string OR_expected[] = { "a & b, c | d", "a & b | e & f, c | d | e & f", "a & b, a & b | d & e, a & b | c | d, c | d", "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, c | d | e" };
+                std::string AND_expected[] = { "a & b, c | d", "a & b & e & f, c & e & f | d & e & f", "a & b, a & b & d & e, a & b & c | a & b & d, d & e", "a & b, a & b & c & d, a & b & e, a & c | b & c | a & d | b & d, c & d, c & e | d & e" };
+                std::string ADD_expected[] = { "a & b, c | d", "a & b, c | d, e & f", "a & b, c | d, a & b, d & e", "a & b, c | d, a | b, c & d, e" };
+
+                for( short index = 0; index < 4; ++index )
+                {
+                    result &= test( left_value | right_values[ index ], OR_expected[ index ] )
+                            & test( left_value & right_values[ index ], AND_expected[ index ] )
+                            & test( left_value + right_values[ index ], ADD_expected[ index ] )
+                            & test_equality( right_values[ index ].statement_count(), index );
+                }
+            }
+
+            if( true )
+            {
+                result &= test( !LogicalMatrix( "a & b, !a | !b, a & !b | c & d, !a & b & c | d & !e & f | g & h & !i" ),
+                    "!a | !b, a & b, !a & !c | !a & !d | b & !c | b & !d, a & !d & !g | a & !d & !h | a & !d & i | a & e & !g | a & e & !h | a & e & i | a & !f & !g | a & !f & !h | a & !f & i | !b & !d & !g | !b & !d & !h | !b & !d & i | !b & e & !g | !b & e & !h | !b & e & i | !b & !f & !g | !b & !f & !h | !b & !f & i | !c & !d & !g | !c & !d & !h | !c & !d & i | !c & e & !g | !c & e & !h | !c & e & i | !c & !f & !g | !c & !f & !h | !c & !f & i" );
+            }
+
+            if( true )
+            {
+                LogicalMatrix right_value( "a | b, c & !d" );
+
+                std::string OR_expected[] = { "a | b, a & !b | c & !d, !c | d, e", "a & !b, !c | d | a | b, !c | d | c & !d, e", "a & !b, !c | d, e | a | b, e | c & !d", "a & !b, !c | d, e" };
+                std::string AND_expected[] = { "a & !b, a & !b & c & !d, !c | d, e", "a & !b, a & !c | b & !c | a & d | b & d, c & !c & !d | c & d & !d, e", "a & !b, !c | d, a & e | b & e, c & !d & e", "a & !b, !c | d, e"};
+                std::string ADD_expected[] = { "a | b, c & !d, a & !b, !c | d, e", "a & !b, a | b, c & !d, !c | d, e", "a & !b, !c | d, a | b, c & !d, e", "a & !b, !c | d, e, a | b, c & !d"};
+                std::string NOT_expected[] = { "!a | b, !c | d, e", "a & !b, c & !d, e", "a & !b, !c | d, !e", "a & !b, !c | d, e" };
+
+                for( short index = 0; index < 4; ++index )
+                {
+                    result &= test( LogicalMatrix( "a & !b, !c | d, e" ).OR( right_value, index ), OR_expected[ index ] )
+                            & test( LogicalMatrix( "a & !b, !c | d, e" ).AND( right_value, index ), AND_expected[ index ] )
+                            & test( LogicalMatrix( "a & !b, !c | d, e" ).ADD( right_value, index ), ADD_expected[ index ] )
+                            & test( LogicalMatrix( "a & !b, !c | d, e" ).NOT( index ), NOT_expected[ index ] );
+                }
+
+                result &= test( LogicalMatrix().OR( right_value, 2 ), "" );
+                result &= test( LogicalMatrix().AND( right_value, 4 ), "" );
+                result &= test( LogicalMatrix().ADD( right_value, 6 ), "a | b, c & !d" );
+                result &= test( LogicalMatrix().NOT( 8 ), "" );
+
+                result &= test( LogicalMatrix().OR( right_value, 0 ), "" );
+                result &= test( LogicalMatrix().AND( right_value, 0 ), "" );
+                result &= test( LogicalMatrix().ADD( right_value, 0 ), "a | b, c & !d" );
+                result &= test( LogicalMatrix().NOT( 0 ), "" );
+
+                result &= test( right_value.OR( LogicalMatrix(), 2 ), "a | b, c & !d" );
+                result &= test( right_value.AND( LogicalMatrix(), 1 ), "a | b, c & !d" );
+                result &= test( right_value.ADD( LogicalMatrix(), 0 ), "a | b, c & !d" );
+            }
+
+            if( true )
+            {
+                LogicalMatrix test_matrix( "a & !b, c | d" );
+
+                result &= test_equality( test_matrix, !( !test_matrix ) );
+                result &= test_equality( test_matrix, !LogicalMatrix( "a & !b, c | d" ).NOT() );
+                result &= test_equality( test_matrix, LogicalMatrix( "a & !b, c | d" ).NOT().NOT() );
+                result &= test_equality( test_matrix, LogicalMatrix( "a & !b, c | d" ).NOT( 1 ).NOT( 1 ) );
+                result &= test_equality( !test_matrix, LogicalMatrix( "a & !b, c | d" ).NOT( 0 ).NOT( 1 ) );
+            }
+
+            if( true )
+            {
+                LogicalMatrix test_remove_matrix( "( a & b, c | d ) , ( a | b, c & d, e )" );
+
+                result &= test_remove( test_remove_matrix, 2 );
+                result &= test( test_remove_matrix, "a & b, c | d, c & d, e" );
+                result &= test_remove( test_remove_matrix, 8, false );
+                result &= test( test_remove_matrix, "a & b, c | d, c & d, e" );
+                result &= test_remove( test_remove_matrix, 4, false );
+                result &= test( test_remove_matrix, "a & b, c | d, c & d, e" );
+                result &= test_remove( test_remove_matrix, 3 );
+                result &= test( test_remove_matrix, "a & b, c | d, c & d" );
+                result &= test_remove( test_remove_matrix, 0 );
+                result &= test( test_remove_matrix, "c | d, c & d" );
+
+                result &= test_remove( test_remove_matrix, 0 );
+                result &= test_remove( test_remove_matrix, 0 );
+                result &= test_remove( test_remove_matrix, 0, false );
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        result &= test_error( "a |" );
+        result &= test_error( "| b" );
+        result &= test_error( "a &" );
+        result &= test_error( "& b" );
+        result &= test_error( "& b | c & d" );
+        result &= test_error( "a & | c & d" );
+        result &= test_error( "a & b | & d" );
+        result &= test_error( "a & b | c &" );
+        result &= test_error( "a & b |" );
+        result &= test_error( "| c & d" );
+        result &= test_error( "( a" );
+        result &= test_error( "a )" );
+        result &= test_error( "!" );
+        result &= test_error( "! & a" );
+        result &= test_error( "()" );
+        result &= test_error( "" );
+        result &= test_error( "," );
+        result &= test_error( "a ," );
+        result &= test_error( ", b" );
+        result &= test_error( "a , , c & d" );
+        result &= test_error( "a & , c & d" );
+        result &= test_error( "a & b , | d" );
+        result &= test_error( "( a & b ) ," );
+        result &= test_error( "( , ) | b" );
+        result &= test_error( "!, a" );
+        result &= test_error( "( a ) ( b" );
+        result &= test_error( "( \n )" );
+    }
+
+    if( true )
+    { // nesting far deeper than a recursive parser could take
+        std::string deep_statement = std::string( 100000, '(' ) + "a" + std::string( 100000, ')' ),
+            negated_statement = "!" + std::string( 50000, '(' ) + "!( a | b )" + std::string( 50000, ')' ) + " & c";
+
+        result &= test( deep_statement, "a" );
+        result &= test( negated_statement, "a & c | b & c" );
+        result &= test( "( \n a | b \n ) & c\nd", "a & c | b & c, d" );
+        result &= test( "( a ) ( b ) & c", "b & c" );
+    }
+
+    if( true )
+    {
+        std::map< std::string, bool > test_map = { { "a", false }, { "b", true }, { "c", true }, { "d", false }, { "e", false } };
+
+        result &= test_evaluate( "a & b, c | d", test_map, { 0, 1 } );
+        result &= test_evaluate( "a & b | e & f, c | d | e & f", test_map, { 0, 1 } );
+        result &= test_evaluate( "a & b, a & b | d & e, a & b | c | d, c | d", test_map, { 0, 0, 1, 1 } );
+        result &= test_evaluate( "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, e | c | d", test_map, { 1, 0, 0, 1, 1, 1 } );
+
+        result &= test_evaluate( "a & !a", { { "a", false } }, { 0 } );
+        result &= test_evaluate( "a & !a", { { "a", true } }, { 0 } );
+        result &= test_evaluate( "a | !a", { { "a", false } }, { 1 } );
+        result &= test_evaluate( "a | !a", { { "a", true } }, { 1 } );
+        result &= test_evaluate( "a | !a", { }, { 0 } );
+    }
+
+    if( true )
+    {
+        try
+        {
+            if( true )
+            {
+                LogicalMatrix test_matrix( "a | b" );
+
+                result &= test_equality( test_matrix.split_statements(), std::vector< LogicalMatrix >( { test_matrix } ) );
+
+                result &= test_equality( test_matrix.identifier_count(), 2 );
+                result &= test_equality( test_matrix.statement_count(), 1 );
+
+                test_matrix.combine_statements();
+
+                result &= test( test_matrix, "a | b" );
+            }
+
+            if( true )
+            {
+                LogicalMatrix test_matrix( "a | b, c & d, e" );
+
+                std::string split_expected[] = { "a | b", "c & d", "e" };
+
+                result &= test_equality( test_matrix.identifier_count(), 5 );
+                result &= test_equality( test_matrix.statement_count(), 3 );
+
+                std::vector< LogicalMatrix > split_vector = test_matrix.split_statements();
+
+                for( short index = 0; index < 3; ++index )
+                {
+                    result &= test( split_vector[ index ], split_expected[ index ] );
+                    result &= test( test_matrix.isolate_statement( index ), split_expected[ index ] );
+                }
+
+                result &= test( test_matrix.isolate_statement( 3 ), "" );
+                result &= test( test_matrix.isolate_statement( 8 ), "" );
+
+                test_matrix.combine_statements();
+
+                result &= test( test_matrix, "a & c & d & e | b & c & d & e" );
+            }
+
+            if( true )
+            {
+                LogicalMatrix test_matrix;
+
+                result &= test( test_matrix, "" );
+
+                result &= test_equality( test_matrix, !test_matrix );
+
+                result &= test_equality( test_matrix.identifier_count(), 0 );
+                result &= test_equality( test_matrix.statement_count(), 0 );
+
+                result &= test_equality( test_matrix.split_statements(), std::vector< LogicalMatrix >( { } ) );
+                result &= test_equality( test_matrix.get_unique_identifiers(), std::set< std::string >( { } ) );
+
+                result &= test_equality( test_matrix, test_matrix.isolate_statement( 0 ) );
+                result &= test_equality( test_matrix, test_matrix.isolate_statement( 5 ) );
+
+                test_matrix.combine_statements();
+
+                result &= test( test_matrix, "" );
+
+                result &= test_evaluate( test_matrix, { }, { } );
+
+                result &= test_remove( test_matrix, 5, false );
+                result &= test_remove( test_matrix, 0, false );
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        result &= test_evaluate_full( "( a & b, c | d ) & ( a | b, c & d, e )" );
+    }
+
+    if( true )
+    {
+        result &= test_compiled( "( a & b, c | d ) & ( a | b, c & d, e )" );
+        result &= test_compiled( "a & !a, a | !a, !a & b | c & !d" );
+        result &= test_compiled( "!( a & !b | c & d ) | e & f & !g" );
+
+        CompiledMatrix compiled = LogicalMatrix().compile();
+
+        result &= test_equality( compiled.statement_count(), 0 );
+        result &= test_equality( compiled.evaluate( { { "a", true } } ), std::vector< bool >( { } ) );
+    }
+
+    if( true )
+    {
+        result &= test_batch( "( a & b, c | d ) & ( a | b, c & d, e )" );
+        result &= test_batch( "a & !a, a | !a, !a & b | c & !d", 37 );
+        result &= test_batch( "!( a & !b | c & d ) | e & f & !g", 777 );
+        result &= test_batch( "( a | b | c | d | e ) & ( f | g | h | i | j ) & ( k | l | m | n | !o ), a & f & k | b & g & l", 2000 );
+    }
+
+    if( true )
+    {
+        result &= test_stream( "( a & b, c | d ) & ( a | b, c & d, e )" );
+        result &= test_stream( "a & !a, a | !a, !a & b | c & !d", '\t' );
+        result &= test_stream( "!( a & !b | c & d ) | e & f & !g" );
+        result &= test_stream( "( a | b | c | d | e ) & ( f | g | h ) & ( i | !j ), a & f & i | b & g & j" );
+
+        try
+        { // c has no column
+            std::ostringstream output;
+            std::ofstream( "LogicalMatrixTest.stream" ) << "a,b\n1,0\n";
+            AssignmentStream( "LogicalMatrixTest.stream" ).evaluate( LogicalMatrix( "a & c" ).compile(), output );
+            result = false;
+            std::cout << "No error caught for a missing column" << std::endl << "Test FAILED" << std::endl << std::endl;
+        }
+        catch( AssignmentStream::Streamexception &e )
+        {
+        }
+
+        std::remove( "LogicalMatrixTest.stream" );
+    }
+
+    if( true )
+    {
+        std::string many_statements;
+
+        for( size_t counter = 0; counter < 200; ++counter )
+        {
+            many_statements += std::string( counter == 0? "" : ( counter % 3 == 0 )? "\n" : ", " ) + "( a" + std::to_string( counter % 7 ) +
+                " | !b" + std::to_string( counter % 5 ) + " ) & ( c | d" + std::to_string( counter % 11 ) + " )";
+        }
+
+        result &= test_load( "a & b, c | d & !a" );
+        result &= test_load( "( a | b\n c ) & d\ne | !( f\ng ), a & b | a" );
+        result &= test_load( many_statements );
+        result &= test_equality( LogicalMatrix::load( "/dev/null" ).empty(), true );
+
+        try
+        {
+            std::ofstream( "LogicalMatrixTest.rules" ) << "a & b\n( c\nd ) )\n";
+            LogicalMatrix::load( "LogicalMatrixTest.rules" );
+            result = false;
+            std::cout << "No error caught loading unbalanced parentheses" << std::endl << "Test FAILED" << std::endl << std::endl;
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+        }
+
+        std::remove( "LogicalMatrixTest.rules" );
+    }
+
+    if( true )
+    {
+        try
+        {
+            std::shared_ptr< SymbolTable > symbols = std::make_shared< SymbolTable >();
+            LogicalMatrix left_value( "b & !c", symbols ), right_value( "a | c", symbols );
+
+            result &= test_equality( left_value.symbol_table(), right_value.symbol_table() );
+            result &= test_equality( symbols->size(), 3 );
+            result &= test( left_value & right_value, "a & b & !c | b & c & !c" );
+            result &= test_equality( left_value & right_value, left_value & LogicalMatrix( "a | c" ) );
+            result &= test_equality( left_value + right_value, LogicalMatrix( "b & !c, a | c" ) );
+            result &= test_equality( symbols->size(), 3 );
+            result &= test( ( left_value | LogicalMatrix( "d" ) ).rebind( std::make_shared< SymbolTable >() ), "b & !c | d" );
+            result &= test( !LogicalMatrix( "a & !a & b" ), "!a | a | !b" );
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    { // more than 64 AND sets so every BitVector spans several words
+        try
+        {
+            LogicalMatrix test_matrix( "( a | b | c | d | e ) & ( f | g | h | i | j ) & ( k | l | m | n | !o ), a & f & k | b & g & l" );
+
+            result &= test( test_matrix.isolate_statement( 1 ), "a & f & k | b & g & l" );
+            result &= test_equality( test_matrix, !( !test_matrix ) );
+            result &= test_evaluate( test_matrix, { { "e", true }, { "j", true }, { "o", false } }, { 1, 0 } );
+            result &= test_evaluate( test_matrix, { { "e", true }, { "j", true }, { "o", true } }, { 0, 0 } );
+            result &= test_evaluate( test_matrix, { { "b", true }, { "g", true }, { "l", true } }, { 1, 1 } );
+            result &= test_evaluate( test_matrix | LogicalMatrix( "e & j" ), { { "e", true }, { "j", true }, { "o", true } }, { 1, 1 } );
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    { // trimming removes AND sets scattered over several words and keeps the order and bits of the others
+        try
+        {
+            std::mt19937_64 generator( 29 );
+
+            for( size_t round = 0; round < 24; ++round )
+            {
+                size_t count = 40 + generator() % 300, first = generator() % count;
+                std::string left = "p & q", expected = "p & q", right = "r";
+
+                for( size_t counter = 0; counter < count; ++counter )
+                {
+                    std::string term = "v" + std::to_string( counter % 7 ) + " & w" + std::to_string( counter );
+
+                    left += " | " + term;
+                    expected += " | " + term;
+
+                    if( counter >= first && generator() % 3 == 0 )
+                    { // kept while parsing the left side and absorbed once the right side is added
+                        std::string absorbing = "v" + std::to_string( counter % 5 ) + " & x" + std::to_string( counter );
+
+                        left += " | " + absorbing + " & u" + std::to_string( generator() % 3 );
+                        right += " | " + absorbing;
+                    }
+                }
+
+                LogicalMatrix trimmed = LogicalMatrix( left ) | LogicalMatrix( right );
+
+                result &= test_equality( trimmed, LogicalMatrix( expected + " | " + right ) );
+                result &= test_evaluate( trimmed, { { "v3", true }, { "w3", true } }, { 1 } );
+                result &= test_evaluate( trimmed, { { "v0", true }, { "x" + std::to_string( count - 1 ), true }, { "u0", true } }, { 0 } );
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    { // the raw product holds more AND sets than are generated before the first intermediate trim
+        std::string left_string = "a", right_string = "b", expected = "a & b";
+
+        for( size_t counter = 1; counter <= 40; ++counter )
+        {
+            left_string += " | x" + std::to_string( counter ) + " & b";
+            right_string += " | y" + std::to_string( counter ) + " & a";
+            expected += " | a & y" + std::to_string( counter );
+        }
+
+        for( size_t counter = 1; counter <= 40; ++counter )
+        {
+            expected += " | b & x" + std::to_string( counter );
+        }
+
+        try
+        {
+            LogicalMatrix test_matrix( "a | !b" );
+
+            result &= test( LogicalMatrix( left_string ) & LogicalMatrix( right_string ), expected );
+            result &= test( test_matrix & LogicalMatrix( "!a | b, a & !a" ), "a & !a | a & b | !a & !b | b & !b, a & !a" );
+
+            test_matrix.set_drop_contradictions( true );
+            result &= test_equality( test_matrix.drops_contradictions(), true );
+            result &= test( test_matrix & LogicalMatrix( "!a | b, a & !a" ), "a & b | !a & !b, a & !a" );
+            result &= test( test_matrix &= LogicalMatrix( "!a | c" ), "a & c | !a & !b | !b & c" );
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        std::string many_terms = "a0 & b0";
+        std::map< std::string, bool > all_false = { { "a0", false } };
+
+        for( size_t counter = 1; counter < 30; ++counter )
+        {
+            many_terms += " | a" + std::to_string( counter ) + " & b" + std::to_string( counter );
+            all_false[ "a" + std::to_string( counter ) ] = false;
+        }
+
+        result &= test_negated( "( a & b, c | d ) & ( a | b, c & d, e )" );
+        result &= test_negated( "a & !a, a | !a, !a & b | c & !d" );
+        result &= test_negated( "!( a & !b | c & d ) | e & f & !g" );
+
+        try
+        {
+            LogicalMatrix test_matrix( "a & !b | c, d" ), negated = !test_matrix, large = !LogicalMatrix( many_terms );
+
+            result &= test( negated & LogicalMatrix( "e" ), "!a & !c & e | b & !c & e, !d & e" );
+            result &= test_equality( ( negated & !LogicalMatrix( "e" ) ).form() == LogicalMatrix::CNF, true );
+            result &= test( negated & !LogicalMatrix( "e" ), "!a & !c & !e | b & !c & !e, !d & !e" );
+            result &= test( negated | !LogicalMatrix( "d" ), "!a & !c | b & !c | !d, !d" );
+            result &= test( test_matrix.NOT( 0 ), "!a & !c | b & !c, d" );
+            result &= test_equality( large.statement_count(), 1 );
+            result &= test_evaluate( large, all_false, { 1 } );
+            result &= test_evaluate( large, { { "a3", true }, { "b3", false } }, { 0 } );
+            result &= test_evaluate( large & !LogicalMatrix( "!a3" ), { { "a3", true }, { "b3", true } }, { 0 } );
+            large.set_conversion_limit( 1000 );
+
+            try
+            {
+                large.to_DNF();
+                result = false;
+                std::cout << "No error caught expanding 2^30 AND sets" << std::endl << "Test FAILED" << std::endl << std::endl;
+            }
+            catch( LogicalMatrix::Logicalsizeexception &e )
+            {
+            }
+
+            // queries and parsed negations of a matrix too large to expand stay in CNF
+            LogicalMatrix parsed( "!( " + many_terms + " )" ), joined( "x & !( " + many_terms + " ) & y" ),
+                listed( "x | y, !( " + many_terms + " ) | z" ), restored( parsed );
+            std::map< std::string, bool > known = all_false;
+
+            known[ "x" ] = true;
+            known[ "y" ] = false;
+            known[ "z" ] = false;
+
+            result &= test_equality( large.identifier_count(), 60 );
+            result &= test_equality( large.get_unique_identifiers().size(), 60 );
+            result &= test_equality( large.get_unique_identifiers() == large.statement( 0 ).get_unique_identifiers(), true );
+            result &= test_equality( parsed.form() == LogicalMatrix::CNF, true );
+            result &= test_equality( large == parsed, true );
+            result &= test_equality( large < parsed || parsed < large, false );
+            result &= test_equality( large == joined, false );
+            result &= test_equality( joined.form() == LogicalMatrix::CNF, true );
+            result &= test_evaluate( joined, known, { 0 } );
+            known[ "y" ] = true;
+            result &= test_evaluate( joined, known, { 1 } );
+            known[ "b3" ] = true;
+            result &= test_evaluate( joined, known, { 1 } );
+            known[ "a3" ] = true;
+            result &= test_evaluate( joined, known, { 0 } );
+            result &= test_evaluate( listed, known, { 1, 0 } );
+            known[ "z" ] = true;
+            result &= test_evaluate( listed, known, { 1, 1 } );
+            result &= test_equality( restored.NOT( 0 ) == LogicalMatrix( many_terms ), true );
+            result &= test_evaluate( listed.NOT( 1 ), known, { 1, 0 } );
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        std::string wide = "x0 & !y0";
+
+        for( size_t counter = 1; counter < 8; ++counter )
+        {
+            wide += " | x" + std::to_string( counter ) + " & !y" + std::to_string( counter ) + " | x" + std::to_string( counter ) + " & y" + std::to_string( counter );
+        }
+
+        for( LogicalMatrix::Minimization mode : { LogicalMatrix::Automatic, LogicalMatrix::Exact, LogicalMatrix::Heuristic } )
+        {
+            result &= test_minimize( "a & b | a & !b", "a", mode );
+            result &= test_minimize( "a & !a | b", "b", mode );
+            result &= test_minimize( "a | !a & b", "a | b", mode );
+            result &= test_minimize( "a & !a, a | !a", "a & !a, a | !a", mode );
+            result &= test_minimize( "a & b & c | a & b & !c | a & !b, c | !c & d", "a, c | d", mode );
+        }
+
+        result &= test_minimize( "( a | b | c ) & ( !a | !b | !c )", "a & !c | !a & b | !b & c", LogicalMatrix::Exact );
+        result &= test_minimize( "( a | b | c ) & ( !a | !b | !c )", "a & !b | a & !c | !a & b | b & !c | !a & c | !b & c", LogicalMatrix::Heuristic );
+
+        result &= test_minimize( "a & b | !a & c | b & c", "a & b | !a & c", LogicalMatrix::Exact );
+        result &= test_minimize( "a & b | !a & c | b & c", "a & b | !a & c | b & c", LogicalMatrix::Heuristic );
+        result &= test_minimize( wide, "x0 & !y0 | x1 | x2 | x3 | x4 | x5 | x6 | x7", LogicalMatrix::Exact );
+
+        try
+        {
+            LogicalMatrix test_matrix( "a & b" ), negated = !LogicalMatrix( "a & b | a & !b" );
+
+            negated.minimize();
+            result &= test_equality( negated.form() == LogicalMatrix::CNF, true );
+            result &= test( negated, "!a" );
+
+            test_matrix.set_auto_minimize( true );
+            result &= test_equality( test_matrix.auto_minimizes(), true );
+            result &= test( test_matrix | LogicalMatrix( "a & !b" ), "a" );
+            result &= test( test_matrix & LogicalMatrix( "!a | c" ), "a & b & c" );
+            result &= test( test_matrix += LogicalMatrix( "c & d | c & !d" ), "a & b, c" );
+            result &= test( !test_matrix, "!a | !b, !c" );
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        try
+        {
+            LogicalMatrix test_matrix( "a & !a, a & b | !a & c, a | !a, b & c, a & !a | b" ), other( "c & b | a & d | c & !a" );
+            std::string clauses = "!x0 & !y0";
+
+            for( size_t counter = 1; counter < 40; ++counter )
+            {
+                clauses += " | !x" + std::to_string( counter ) + " & !y" + std::to_string( counter );
+            }
+
+            LogicalMatrix chain = !LogicalMatrix( clauses ), contradiction = chain & !LogicalMatrix( "x7" ) & !LogicalMatrix( "y7" );
+
+            result &= test_equality( test_matrix.satisfiable( 0 ), false );
+            result &= test_equality( test_matrix.satisfiable( 1 ), true );
+            result &= test_equality( test_matrix.satisfiable( 4 ), true );
+            result &= test_equality( test_matrix.satisfiable( 5 ), false );
+            result &= test_equality( ( !test_matrix ).satisfiable( 2 ), false );
+            result &= test_equality( ( !test_matrix ).satisfiable( 0 ), true );
+
+            result &= test_equality( test_matrix.implies( 0, 3 ), true );
+            result &= test_equality( test_matrix.implies( 3, 1 ), true );
+            result &= test_equality( test_matrix.implies( 1, 3 ), false );
+            result &= test_equality( test_matrix.implies( 1, 2 ), true );
+            result &= test_equality( test_matrix.implies( 1, other, 0 ), false );
+            result &= test_equality( other.implies( 0, test_matrix, 1 ), false );
+            result &= test_equality( ( !test_matrix ).implies( 3, !LogicalMatrix( "b & c & d" ), 0 ), true );
+            result &= test_equality( ( !test_matrix ).implies( 3, LogicalMatrix( "!b | !c" ), 0 ), true );
+            result &= test_equality( test_matrix.implies( 3, !LogicalMatrix( "!b" ), 0 ), true );
+
+            result &= test_equality( test_matrix.equivalent( 4, LogicalMatrix( "b" ), 0 ), true );
+            result &= test_equality( test_matrix.equivalent( 1, !LogicalMatrix( "a & !b | !a & !c" ), 0 ), true );
+            result &= test_equality( test_matrix.equivalent( 1, 3 ), false );
+            result &= test_equality( LogicalMatrix( "a & b | a & !b, c" ).equivalent( LogicalMatrix( "a, c & d | c & !d" ) ), true );
+            result &= test_equality( LogicalMatrix( "a & b | a & !b, c" ).equivalent( LogicalMatrix( "a" ) ), false );
+
+            result &= test_equality( test_matrix.subsumes( 1, 3 ), false );
+            result &= test_equality( LogicalMatrix( "a | b & c" ).subsumes( 0, LogicalMatrix( "a & d | b & c & e" ), 0 ), true );
+            result &= test_equality( LogicalMatrix( "a | b & c" ).subsumes( 0, LogicalMatrix( "a & d | b & e" ), 0 ), false );
+            result &= test_equality( ( !LogicalMatrix( "!a & !b" ) ).subsumes( 0, !LogicalMatrix( "!a" ), 0 ), true );
+            result &= test_equality( test_matrix.subsumes( 9, 0 ), false );
+
+            // 2^40 AND sets in DNF
+            result &= test_equality( chain.satisfiable( 0 ), true );
+            result &= test_equality( contradiction.satisfiable( 0 ), false );
+            result &= test_equality( chain.implies( 0, LogicalMatrix( "x12 | y12 | z" ), 0 ), true );
+            result &= test_equality( chain.implies( 0, LogicalMatrix( "x12 | z" ), 0 ), false );
+            result &= test_equality( LogicalMatrix( "x12 & y12" ).implies( 0, chain, 0 ), false );
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        result &= test_diagram( "a", "a" );
+        result &= test_diagram( "a & b | c", "a & b | a & !b & c | !a & c" );
+        result &= test_diagram( "a & b | c", "c | a & b & !c", { "c", "b", "a" } );
+        result &= test_diagram( "a & b | a & !b", "a" );
+        result &= test_diagram( "a & !a, b", "a & !a, b" );
+        result &= test_diagram( "( a | b ) & ( c | !d ), !a & d | c", "a & c | a & !c & !d | !a & b & c | !a & b & !c & !d, a & c | !a & c | !a & !c & d" );
+
+        try
+        {
+            DecisionDiagram left_value( LogicalMatrix( "a & b | c" ) ), chain( LogicalMatrix( "x0 | y0" ), { "x0", "y0" } );
+            DecisionDiagram right_value( LogicalMatrix( "!c | d" ), left_value.manager() );
+            LogicalMatrix expanded( "x0 | y0" );
+
+            result &= test( ( !left_value ).to_matrix(), "a & !b & !c | !a & !c" );
+            result &= test( ( left_value & right_value ).to_matrix(), "a & b & c & d | a & b & !c | a & !b & c & d | !a & c & d" );
+            result &= test( ( left_value | right_value ).to_matrix(), "a | !a" );
+            result &= test( ( left_value + right_value ).to_matrix(), "a & b | a & !b & c | !a & c, c & d | !c" );
+            result &= test( left_value.restrict( "a", true ).to_matrix(), "b | !b & c" );
+            result &= test( left_value.restrict( "c", true ).to_matrix(), "a | !a" );
+            result &= test( left_value.restrict( "e", true ).to_matrix(), "a & b | a & !b & c | !a & c" );
+            result &= test_equality( ( left_value & !left_value ).to_matrix(), LogicalMatrix( "a & !a" ) );
+            result &= test_equality( ( left_value | !left_value ) == left_value.restrict( "c", true ), true );
+            result &= test_equality( left_value.restrict( "c", true ).evaluate( {} ), std::vector< bool >{ true } );
+            result &= test_equality( left_value.statement_count(), 1 );
+            result &= test_equality( left_value.node_count(), 5 );
+
+            // each clause adds two nodes to the diagram while the DNF doubles
+            for( size_t counter = 1; counter < 16; ++counter )
+            {
+                std::string clause = "x" + std::to_string( counter ) + " | y" + std::to_string( counter );
+
+                chain &= DecisionDiagram( LogicalMatrix( clause ), chain.manager() );
+
+                if( counter < 6 )
+                {
+                    expanded &= LogicalMatrix( clause );
+                }
+            }
+
+            result &= test_equality( chain.node_count(), 34 );
+            result &= test_equality( chain.evaluate( { { "x3", true } } ), std::vector< bool >{ false } );
+            result &= test_equality( chain.restrict( "x6", false ).restrict( "y6", false ).roots()[ 0 ], DecisionDiagram::Manager::False );
+            result &= test_equality( DecisionDiagram( expanded, chain.manager() ).node_count(), 14 );
+
+            try
+            {
+                left_value &= chain;
+                result = false;
+                std::cout << "No error caught combining diagrams of different managers" << std::endl << "Test FAILED" << std::endl << std::endl;
+            }
+            catch( DecisionDiagram::Diagramexception &e )
+            {
+            }
+
+            try
+            {
+                chain.to_matrix( 1000 );
+                result = false;
+                std::cout << "No error caught converting 2^16 paths" << std::endl << "Test FAILED" << std::endl << std::endl;
+            }
+            catch( LogicalMatrix::Logicalsizeexception &e )
+            {
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        try
+        {
+            LogicalMatrix test_matrix( "a & b | !c, a & !a, c & d | !b & !d, e | !e, b" );
+            CompiledMatrix compiled = test_matrix.compile();
+            CompiledMatrix::Assignment assignment = compiled.make_assignment( { { "a", true }, { "c", false } } );
+            CompiledMatrix::ResultBitset expected = compiled.make_result(), sparse = compiled.make_result();
+            DeltaEvaluator delta( compiled ), started( compiled, assignment );
+            std::vector< uint32_t > counts;
+            std::mt19937_64 generator( 5 );
+
+            result &= test_equality( delta.result() == compiled.make_result(), true );
+            compiled.evaluate( assignment, expected );
+            result &= test_equality( started.result() == expected, true );
+            result &= test_equality( started.changes(), std::vector< size_t >() );
+
+            delta.set( "c", false );
+            result &= test_equality( delta.changes(), std::vector< size_t >{ 0 } );
+            delta.set( "e", true );
+            delta.set( "e", false );
+            result &= test_equality( delta.changes(), std::vector< size_t >{ 3 } );
+            delta.set( "b", true );
+            delta.unset( "b" );
+            delta.set( "f", true );
+            result &= test_equality( delta.changes(), std::vector< size_t >() );
+            delta.unset( "c" );
+            delta.unset( "e" );
+            result &= test_equality( delta.changes(), std::vector< size_t >{ 0, 3 } );
+            result &= test_equality( delta.statement_count(), 5 );
+            result &= test_equality( compiled.references( test_matrix.symbol_table()->find( "d" ) ), true );
+            result &= test_equality( compiled.references( compiled.identifier_count() ), false );
+
+            // every change of one identifier is checked against a full evaluation
+            assignment.clear();
+            compiled.evaluate( assignment, expected );
+
+            for( size_t counter = 0; counter < 2000; ++counter )
+            {
+                SymbolTable::id_type identifier = generator() % compiled.identifier_count();
+                std::vector< size_t > changed, found;
+
+                if( generator() % 4 == 0 )
+                {
+                    assignment.unset( identifier );
+                    delta.unset( identifier );
+                }
+                else
+                {
+                    bool value = generator() % 2;
+
+                    assignment.set( identifier, value );
+                    delta.set( identifier, value );
+                }
+
+                CompiledMatrix::ResultBitset previous = expected;
+
+                compiled.evaluate( assignment, expected );
+
+                for( size_t statement = 0; statement < expected.size(); ++statement )
+                {
+                    if( expected[ statement ] != previous[ statement ] )
+                    {
+                        changed.push_back( statement );
+                    }
+                }
+
+                found = delta.changes();
+
+                compiled.evaluate_sparse( assignment, sparse, counts );
+
+                if( !( delta.result() == expected ) || !( sparse == expected ) || found != changed )
+                {
+                    result = false;
+                    std::cout << "Delta or sparse evaluation differs after " << counter << " changes" << std::endl << "Test FAILED" << std::endl << std::endl;
+                    break;
+                }
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        try
+        {
+            LogicalMatrix dense( "a & b | !c, a & !a | b & c" ), sparse( dense ), other( "!b | d & e" ), wide;
+            std::mt19937_64 generator( 17 );
+
+            sparse.set_storage( LogicalMatrix::Sparse );
+            result &= test_equality( sparse.storage(), LogicalMatrix::Sparse );
+            result &= test_equality( dense.storage(), LogicalMatrix::Dense );
+            result &= test_equality( sparse.to_string(), std::string( "a & b | !c, a & !a | b & c" ) );
+            result &= test_equality( sparse == dense, true );
+
+            sparse &= other;
+            dense &= other;
+            result &= test_equality( sparse.to_string(), dense.to_string() );
+            result &= test_equality( sparse.storage(), LogicalMatrix::Sparse );
+            sparse |= !other;
+            dense |= !other;
+            result &= test_equality( sparse.to_string(), dense.to_string() );
+            sparse.ADD( other, 1 );
+            dense.ADD( other, 1 );
+            result &= test_equality( sparse.to_string(), dense.to_string() );
+            sparse.ADD( LogicalMatrix( "f & !a, g" ), 0 );
+            dense.ADD( LogicalMatrix( "f & !a, g" ), 0 );
+            result &= test_equality( sparse.to_string(), dense.to_string() );
+            result &= test_equality( sparse.statement_count(), 5 );
+            result &= test_equality( sparse.evaluate( { { "a", true }, { "b", false }, { "c", false } } ), dense.evaluate( { { "a", true }, { "b", false }, { "c", false } } ) );
+            result &= test_equality( sparse.identifier_count(), dense.identifier_count() );
+            result &= test_equality( ( !sparse ).to_string(), ( !dense ).to_string() );
+            sparse.set_storage( LogicalMatrix::Dense );
+            result &= test_equality( sparse.storage(), LogicalMatrix::Dense );
+            result &= test_equality( sparse == dense, true );
+
+            // random operations give the same statements in both storages
+            for( size_t counter = 0; counter < 200; ++counter )
+            {
+                LogicalMatrix left( "v" + std::to_string( generator() % 6 ) + " & !v" + std::to_string( generator() % 6 ) + " | v" + std::to_string( generator() % 6 ) +
+                    ", !v" + std::to_string( generator() % 6 ) ), right( "v" + std::to_string( generator() % 6 ) + " | !v" + std::to_string( generator() % 6 ) );
+                LogicalMatrix sparse_left( left ), sparse_right( right );
+
+                sparse_left.set_storage( LogicalMatrix::Sparse );
+
+                switch( generator() % 4 )
+                {
+                    case 0:
+                        left &= right;
+                        sparse_left &= sparse_right;
+                        break;
+                    case 1:
+                        left |= right;
+                        sparse_left |= sparse_right;
+                        break;
+                    case 2:
+                        left.ADD( right, 1 );
+                        sparse_left.ADD( sparse_right, 1 );
+                        break;
+                    default:
+                        left.NOT( 0 );
+                        sparse_left.NOT( 0 );
+                }
+
+                if( sparse_left.to_string() != left.to_string() || !( sparse_left == left ) || sparse_left.storage() != LogicalMatrix::Sparse )
+                {
+                    result = false;
+                    std::cout << "Sparse storage differs after " << counter << " operations" << std::endl << "Test FAILED" << std::endl << std::endl;
+                    break;
+                }
+            }
+
+            // over a thousand AND sets of two literals out of over a thousand identifiers stay sparse once Adaptive
+            wide.set_storage( LogicalMatrix::Sparse );
+
+            for( size_t counter = 0; counter < 1200; ++counter )
+            {
+                wide += LogicalMatrix( "w" + std::to_string( counter ) + " & !x" + std::to_string( counter % 400 ) + " | y" + std::to_string( counter % 7 ), wide.symbol_table() );
+            }
+
+            wide.set_storage( LogicalMatrix::Adaptive );
+            result &= test_equality( wide.storage(), LogicalMatrix::Sparse );
+            result &= test_equality( wide.statement_count(), 1200 );
+            result &= test_equality( wide.evaluate( { { "w5", true }, { "x5", false } } )[ 5 ], true );
+            result &= test_equality( wide.evaluate( { { "w5", true }, { "x5", true } } )[ 5 ], false );
+            result &= test_equality( wide.isolate_statement( 12 ).to_string(), std::string( "y5 | w12 & !x12" ) );
+            result &= test_equality( wide.isolate_statement( 12 ).storage(), LogicalMatrix::Dense );
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        try
+        {
+            LogicalMatrix dense( "a & b | a & b & c | !c, a & !d" ), masks( dense ), other( "!b | d & e" );
+            std::mt19937_64 generator( 19 );
+
+            masks.set_storage( LogicalMatrix::TermMajor );
+            result &= test_equality( masks.storage(), LogicalMatrix::TermMajor );
+            result &= test_equality( masks.to_string(), std::string( "a & b | !c, a & !d" ) );
+            result &= test_equality( masks == dense, true );
+
+            // the duplicate a & b & c merges with its first copy, which a & b only absorbs in the statements holding both
+            masks.ADD( LogicalMatrix( "a & b & c | c & a & b | !c" ), 1 );
+            dense.ADD( LogicalMatrix( "a & b & c | c & a & b | !c" ), 1 );
+            result &= test_equality( masks.to_string(), dense.to_string() );
+            result &= test_equality( masks.to_string(), std::string( "a & b | !c, !c | a & b & c, a & !d" ) );
+            result &= test_equality( masks.storage(), LogicalMatrix::TermMajor );
+            result &= test_equality( masks.evaluate( { { "a", true }, { "b", true }, { "d", false } } ), dense.evaluate( { { "a", true }, { "b", true }, { "d", false } } ) );
+            result &= test_equality( ( !masks ).evaluate( { { "a", true }, { "c", true } } ), ( !dense ).evaluate( { { "a", true }, { "c", true } } ) );
+            result &= test_equality( ( !masks ).storage(), LogicalMatrix::TermMajor );
+
+            masks &= other;
+            dense &= other;
+            result &= test_equality( masks.to_string(), dense.to_string() );
+            result &= test_equality( masks.storage(), LogicalMatrix::TermMajor );
+            masks |= !other;
+            dense |= !other;
+            result &= test_equality( masks.to_string(), dense.to_string() );
+            result &= test_equality( masks.identifier_count(), dense.identifier_count() );
+            masks.set_storage( LogicalMatrix::Sparse );
+            result &= test_equality( masks.storage(), LogicalMatrix::Sparse );
+            result &= test_equality( masks == dense, true );
+
+            // random operations give the same statements as dense storage
+            for( size_t counter = 0; counter < 200; ++counter )
+            {
+                LogicalMatrix left( "v" + std::to_string( generator() % 6 ) + " & !v" + std::to_string( generator() % 6 ) + " | v" + std::to_string( generator() % 6 ) +
+                    ", !v" + std::to_string( generator() % 6 ) ), right( "v" + std::to_string( generator() % 6 ) + " | !v" + std::to_string( generator() % 6 ) );
+                LogicalMatrix masks_left( left );
+                std::map< std::string, bool > assignment = { { "v" + std::to_string( generator() % 6 ), true }, { "v" + std::to_string( generator() % 6 ), false } };
+
+                masks_left.set_storage( LogicalMatrix::TermMajor );
+
+                switch( generator() % 4 )
+                {
+                    case 0:
+                        left &= right;
+                        masks_left &= right;
+                        break;
+                    case 1:
+                        left |= right;
+                        masks_left |= right;
+                        break;
+                    case 2:
+                        left.ADD( right, 1 );
+                        masks_left.ADD( right, 1 );
+                        break;
+                    default:
+                        left.NOT( 0 );
+                        masks_left.NOT( 0 );
+                }
+
+                if( masks_left.to_string() != left.to_string() || !( masks_left == left ) || masks_left.evaluate( assignment ) != left.evaluate( assignment ) ||
+                    masks_left.storage() != LogicalMatrix::TermMajor )
+                {
+                    result = false;
+                    std::cout << "TermMajor storage differs after " << counter << " operations" << std::endl << "Test FAILED" << std::endl << std::endl;
+                    break;
+                }
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        try
+        {
+            LogicalMatrix test_matrix( "a & !b | c, (d | e) & (f | !a), g" ), negated( !test_matrix );
+            std::mt19937_64 generator( 23 );
+            StatementView view = test_matrix.statement( 1 );
+
+            result &= test_equality( view.index(), 1 );
+            result &= test_equality( view.term_count(), 4 );
+            result &= test_equality( view.to_string(), test_matrix.isolate_statement( 1 ).to_string() );
+            result &= test_equality( view.get_unique_identifiers(), std::set< std::string >( { "a", "d", "e", "f" } ) );
+            result &= test_equality( view.evaluate( { { "d", true }, { "f", true } } ), true );
+            result &= test_equality( view.evaluate( { { "d", true }, { "a", true } } ), false );
+            result &= test_equality( view.to_matrix(), test_matrix.isolate_statement( 1 ) );
+            result &= test_equality( test_matrix.statement( 3 ).empty(), true );
+            result &= test_equality( test_matrix.statement( 3 ).to_string(), std::string( "" ) );
+
+            // a CNF view evaluates its OR sets and prints their DNF
+            result &= test_equality( negated.statement( 0 ).to_string(), ( !test_matrix.isolate_statement( 0 ) ).to_string() );
+            result &= test_equality( negated.statement( 0 ).evaluate( { { "b", true }, { "c", false } } ), true );
+            result &= test_equality( negated.statement( 0 ).evaluate( { { "a", true }, { "c", false } } ), false );
+
+            // views and split statements match isolated statements in every storage
+            for( size_t counter = 0; counter < 60; ++counter )
+            {
+                LogicalMatrix matrix;
+
+                for( size_t statement = 0; statement < 6; ++statement )
+                {
+                    matrix += LogicalMatrix( "v" + std::to_string( generator() % 8 ) + " & !v" + std::to_string( generator() % 8 ) + " | v" +
+                        std::to_string( generator() % 8 ) + " & v" + std::to_string( generator() % 8 ) );
+                }
+
+                matrix.set_storage( ( counter % 3 == 0 )? LogicalMatrix::Dense : ( counter % 3 == 1 )? LogicalMatrix::Sparse : LogicalMatrix::TermMajor );
+
+                std::map< std::string, bool > assignment = { { "v" + std::to_string( generator() % 8 ), true }, { "v" + std::to_string( generator() % 8 ), false },
+                    { "v" + std::to_string( generator() % 8 ), true } };
+                std::vector< LogicalMatrix > split = matrix.split_statements();
+                std::vector< bool > values = matrix.evaluate( assignment );
+
+                for( size_t statement = 0; statement < matrix.statement_count(); ++statement )
+                {
+                    LogicalMatrix isolated = matrix.isolate_statement( statement );
+                    StatementView statement_view = matrix.statement( statement );
+
+                    if( !( split[ statement ] == isolated ) || split[ statement ].to_string() != isolated.to_string() ||
+                        statement_view.to_string() != isolated.to_string() || statement_view.evaluate( assignment ) != values[ statement ] )
+                    {
+                        result = false;
+                        std::cout << "StatementView differs for statement " << statement << " of " << matrix << std::endl << "Test FAILED" << std::endl << std::endl;
+                    }
+                }
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
+
+    if( true )
+    {
+        try
+        {
+            LogicalMatrix test_matrix( "a | b" ), other( "c" );
+            std::string statement[ 2 ];
+            size_t counted[ 2 ];
+
+            result &= test_equality( &( test_matrix &= other ) == &test_matrix, true );
+            result &= test_equality( &( test_matrix |= other ) == &test_matrix, true );
+            result &= test_equality( &( test_matrix += other ) == &test_matrix, true );
+            result &= test_equality( &test_matrix.NOT() == &test_matrix, true );
+            result &= test( LogicalMatrix( "a | b" ) & other, "a & c | b & c" );
+            result &= test( LogicalMatrix( "a | b" ) | other, "a | b | c" );
+            result &= test( LogicalMatrix( "a | b" ) + other, "a | b, c" );
+            result &= test( !LogicalMatrix( "a & !b" ), "!a | b" );
+            result &= test( !std::move( other ), "!c" );
+
+            // parsing allocates in proportion to the AND sets, twice as many take about twice the allocations
+            for( size_t index = 0; index < 2; ++index )
+            {
+                for( size_t term = 0; term < 1000 * ( index + 1 ); ++term )
+                {
+                    statement[ index ] += ( term == 0? "x" : " | x" ) + std::to_string( term ) + " & !y" + std::to_string( term );
                 }
+
+                counted[ index ] = allocations;
+                LogicalMatrix parsed( statement[ index ] );
+                counted[ index ] = allocations - counted[ index ];
+
+                result &= test_equality( parsed.identifier_count(), 2000 * ( index + 1 ) );
             }
 
-            if( true )
+            if( counted[ 1 ] > 3 * counted[ 0 ] || counted[ 0 ] > 200 * 1000 )
             {
-                result &= test( LogicalMatrix( "!a & b & c" ) + LogicalMatrix( "d & !e & f" ) + LogicalMatrix( "g & h & !i" ), "!a & b & c, d & !e & f, g & h & !i" );
-                result &= test( LogicalMatrix( "!a & b & c" ) + LogicalMatrix( "a & !b & c" ) + LogicalMatrix( "a & b & !c" ), "!a & b & c, a & !b & c, a & b & !c" );
+                result = false;
+                std::cout << "Parsing 1000 and 2000 AND sets took " << counted[ 0 ] << " and " << counted[ 1 ] << " allocations" << std::endl << "Test FAILED" << std::endl << std::endl;
             }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+        }
+    }
 
-            if( true )
+    if( true )
+    {
+        try
+        {
+            std::string clauses;
+
+            for( size_t index = 0; index < 10; ++index )
             {
-                LogicalMatrix left_value( "a & b, c | d" );
-                LogicalMatrix right_values[] = {
-                    LogicalMatrix(),
-                    LogicalMatrix( "e & f" ),
-                    LogicalMatrix( "a & b, d & e" ),
-                    LogicalMatrix( "a | b, c & d, e" )
-                };
+                clauses += ( index == 0? "( a" : " & ( a" ) + std::to_string( index ) + " | b" + std::to_string( index ) + " )";
+            }
 
-                std::string OR_expected[] = { "a & b, c | d", "a & b | e & f, c | d | e & f", "a & b, a & b | d & e, a & b | c | d, c | d", "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, c | d | e" };
-                std::string AND_expected[] = { "a & b, c | d", "a & b & e & f, c & e & f | d & e & f", "a & b, a & b & d & e, a & b & c | a & b & d, d & e", "a & b, a & b & c & d, a & b & e, a & c | b & c | a & d | b & d, c & d, c & e | d & e" };
-                std::string ADD_expected[] = { "a & b, c | d", "a & b, c | d, e & f", "a & b, c | d, a & b, d & e", "a & b, c | d, a | b, c & d, e" };
+            LogicalMatrix product( clauses ), copy;
+            size_t counted = 0;
 
-                for( short index = 0; index < 4; ++index )
-                {
-                    result &= test( left_value | right_values[ index ], OR_expected[ index ] )
-                            & test( left_value & right_values[ index ], AND_expected[ index ] )
-                            & test( left_value + right_values[ index ], ADD_expected[ index ] )
-                            & test_equality( right_values[ index ].statement_count(), index );
-                }
-            }
+            product.set_storage( LogicalMatrix::Dense );
 
-            if( true )
+            // once a trim has run on this thread the next ones reuse its buffers instead of allocating their own
+            for( size_t repeat = 0; repeat < 3; ++repeat )
             {
-                result &= test( !LogicalMatrix( "a & b, !a | !b, a & !b | c & d, !a & b & c | d & !e & f | g & h & !i" ),
-                    "!a | !b, a & b, !a & !c | !a & !d | b & !c | b & !d, a & !d & !g | a & !d & !h | a & !d & i | a & e & !g | a & e & !h | a & e & i | a & !f & !g | a & !f & !h | a & !f & i | !b & !d & !g | !b & !d & !h | !b & !d & i | !b & e & !g | !b & e & !h | !b & e & i | !b & !f & !g | !b & !f & !h | !b & !f & i | !c & !d & !g | !c & !d & !h | !c & !d & i | !c & e & !g | !c & e & !h | !c & e & i | !c & !f & !g | !c & !f & !h | !c & !f & i" );
+                copy = product;
+                counted = allocations;
+                copy |= product;
+                counted = allocations - counted;
+
+                result &= test_equality( copy == product, true );
+                result &= test_equality( copy.statement( 0 ).term_count(), ( size_t ) 1024 );
             }
 
-            if( true )
+            if( counted > 8 )
             {
-                LogicalMatrix right_value( "a | b, c & !d" );
-
-                std::string OR_expected[] = { "a | b, a & !b | c & !d, !c | d, e", "a & !b, !c | d | a | b, !c | d | c & !d, e", "a & !b, !c | d, e | a | b, e | c & !d", "a & !b, !c | d, e" };
-                std::string AND_expected[] = { "a & !b, a & !b & c & !d, !c | d, e", "a & !b, a & !c | b & !c | a & d | b & d, c & !c & !d | c & d & !d, e", "a & !b, !c | d, a & e | b & e, c & !d & e", "a & !b, !c | d, e"};
-                std::string ADD_expected[] = { "a | b, c & !d, a & !b, !c | d, e", "a & !b, a | b, c & !d, !c | d, e", "a & !b, !c | d, a | b, c & !d, e", "a & !b, !c | d, e, a | b, c & !d"};
-                std::string NOT_expected[] = { "!a | b, !c | d, e", "a & !b, c & !d, e", "a & !b, !c | d, !e", "a & !b, !c | d, e" };
-
-                for( short index = 0; index < 4; ++index )
-                {
-                    result &= test( LogicalMatrix( "a & !b, !c | d, e" ).OR( right_value, index ), OR_expected[ index ] )
-                            & test( LogicalMatrix( "a & !b, !c | d, e" ).AND( right_value, index ), AND_expected[ index ] )
-                            & test( LogicalMatrix( "a & !b, !c | d, e" ).ADD( right_value, index ), ADD_expected[ index ] )
-                            & test( LogicalMatrix( "a & !b, !c | d, e" ).NOT( index ), NOT_expected[ index ] );
-                }
+                result = false;
+                std::cout << "Trimming 2048 AND sets took " << counted << " allocations" << std::endl << "Test FAILED" << std::endl << std::endl;
+            }
 
-                result &= test( LogicalMatrix().OR( right_value, 2 ), "" );
-                result &= test( LogicalMatrix().AND( right_value, 4 ), "" );
-                result &= test( LogicalMatrix().ADD( right_value, 6 ), "a | b, c & !d" );
-                result &= test( LogicalMatrix().NOT( 8 ), "" );
+            // the buffers given back stay within the limit, are freed by release_scratch and not kept at all with a limit of 0
+            result &= test_equality( LogicalMatrix::scratch_size() > 0 && LogicalMatrix::scratch_size() <= LogicalMatrix::default_scratch_limit, true );
+            LogicalMatrix::release_scratch();
+            result &= test_equality( LogicalMatrix::scratch_size(), 0 );
 
-                result &= test( LogicalMatrix().OR( right_value, 0 ), "" );
-                result &= test( LogicalMatrix().AND( right_value, 0 ), "" );
-                result &= test( LogicalMatrix().ADD( right_value, 0 ), "a | b, c & !d" );
-                result &= test( LogicalMatrix().NOT( 0 ), "" );
+            LogicalMatrix::set_scratch_limit( 4096 );
+            copy = product;
+            copy |= product;
+            result &= test_equality( LogicalMatrix::scratch_size() <= 4096, true );
 
-                result &= test( right_value.OR( LogicalMatrix(), 2 ), "a | b, c & !d" );
-                result &= test( right_value.AND( LogicalMatrix(), 1 ), "a | b, c & !d" );
-                result &= test( right_value.ADD( LogicalMatrix(), 0 ), "a | b, c & !d" );
-            }
+            LogicalMatrix::set_scratch_limit( 0 );
+            result &= test_equality( LogicalMatrix::scratch_size(), 0 );
 
-            if( true )
+            for( size_t repeat = 0; repeat < 2; ++repeat )
             {
-                LogicalMatrix test_matrix( "a & !b, c | d" );
-
-                result &= test_equality( test_matrix, !( !test_matrix ) );
-                result &= test_equality( test_matrix, !LogicalMatrix( "a & !b, c | d" ).NOT() );
-                result &= test_equality( test_matrix, LogicalMatrix( "a & !b, c | d" ).NOT().NOT() );
-                result &= test_equality( test_matrix, LogicalMatrix( "a & !b, c | d" ).NOT( 1 ).NOT( 1 ) );
-                result &= test_equality( !test_matrix, LogicalMatrix( "a & !b, c | d" ).NOT( 0 ).NOT( 1 ) );
+                copy = product;
+                counted = allocations;
+                copy |= product;
+                counted = allocations - counted;
             }
 
-            if( true )
-            {
-                LogicalMatrix test_remove_matrix( "( a & b, c | d ) , ( a | b, c & d, e )" );
+            result &= test_equality( copy == product, true );
+            result &= test_equality( LogicalMatrix::scratch_size(), 0 );
+            result &= test_equality( counted > 8, true );
+            LogicalMatrix::set_scratch_limit( LogicalMatrix::default_scratch_limit );
 
-                result &= test_remove( test_remove_matrix, 2 );
-                result &= test( test_remove_matrix, "a & b, c | d, c & d, e" );
-                result &= test_remove( test_remove_matrix, 8, false );
-                result &= test( test_remove_matrix, "a & b, c | d, c & d, e" );
-                result &= test_remove( test_remove_matrix, 4, false );
-                result &= test( test_remove_matrix, "a & b, c | d, c & d, e" );
-                result &= test_remove( test_remove_matrix, 3 );
-                result &= test( test_remove_matrix, "a & b, c | d, c & d" );
-                result &= test_remove( test_remove_matrix, 0 );
-                result &= test( test_remove_matrix, "c | d, c & d" );
+            for( LogicalMatrix::Storage storage : { LogicalMatrix::Sparse, LogicalMatrix::TermMajor } )
+            { // the lists a trim replaces are reused by the next one
+                copy = product;
+                copy.set_storage( storage );
 
-                result &= test_remove( test_remove_matrix, 0 );
-                result &= test_remove( test_remove_matrix, 0 );
-                result &= test_remove( test_remove_matrix, 0, false );
+                for( size_t repeat = 0; repeat < 3; ++repeat )
+                {
+                    copy |= product;
+                    copy &= LogicalMatrix( "a0 | b0" );
+                }
+
+                result &= test_equality( copy == product, true );
+                result &= test_equality( copy.storage(), storage );
             }
         }
         catch( LogicalMatrix::Logicalstatementexception &e )
         {
             result = false;
-            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in reusing buffers" << std::endl << std::endl;
         }
     }
 
     if( true )
     {
-        result &= test_error( "a |" );
-        result &= test_error( "| b" );
-        result &= test_error( "a &" );
-        result &= test_error( "& b" );
-        result &= test_error( "& b | c & d" );
-        result &= test_error( "a & | c & d" );
-        result &= test_error( "a & b | & d" );
-        result &= test_error( "a & b | c &" );
-        result &= test_error( "a & b |" );
-        result &= test_error( "| c & d" );
-        result &= test_error( "( a" );
-        result &= test_error( "a )" );
-        result &= test_error( "!" );
-        result &= test_error( "! & a" );
-        result &= test_error( "()" );
-        result &= test_error( "" );
-        result &= test_error( "," );
-        result &= test_error( "a ," );
-        result &= test_error( ", b" );
-        result &= test_error( "a , , c & d" );
-        result &= test_error( "a & , c & d" );
-        result &= test_error( "a & b , | d" );
-        result &= test_error( "( a & b ) ," );
-        result &= test_error( "( , ) | b" );
-        result &= test_error( "!, a" );
-    }
-
-    if( true )
-    {
-        std::map< std::string, bool > test_map = { { "a", false }, { "b", true }, { "c", true }, { "d", false }, { "e", false } };
+        try
+        {
+            LogicalMatrix a( "a" ), b( "b | !c" ), c( "c & d" ), d( "!a | e" ), e( "e & !b" ), pair( "a, b" ), other_pair( "c | d, e" );
+            LogicalExpr shared = LogicalExpr( b ) & c;
+            std::mt19937 generator( 5 );
+
+            result &= test( ( ( LogicalExpr( a ) & b & c ) | ( LogicalExpr( d ) & e ) ).materialize(), "!b & e | a & b & c & d | a & c & !c & d" );
+            result &= test( ( !( LogicalExpr( a ) & b ) ).materialize(), ( !( a & b ) ).to_string() );
+            result &= test( ( !!LogicalExpr( a ) ).materialize(), "a" );
+            result &= test_equality( ( !( LogicalExpr( a ) | ( LogicalExpr( b ) & !LogicalExpr( c ) ) ) ).materialize().equivalent( !( a | ( b & !c ) ) ), true );
+            result &= test_equality( ( shared | !shared ).materialize().equivalent( ( b & c ) | !( b & c ) ), true );
+
+            // operands of several statements keep their order, + keeps the order of every operand
+            result &= test_equality( ( LogicalExpr( c ) & pair & e & other_pair ).materialize().equivalent( c & pair & e & other_pair ), true );
+            result &= test_equality( ( !( LogicalExpr( pair ) | d | other_pair ) ).materialize().equivalent( !( pair | d | other_pair ) ), true );
+            result &= test( ( LogicalExpr( pair ) + c + ( LogicalExpr( d ) | a ) ).materialize(), ( pair + c + ( d | a ) ).to_string() );
+            result &= test( ( LogicalExpr( a ) & LogicalMatrix() ).materialize(), "a" );
+
+            // random expressions over the operands match the LogicalMatrix operators they record
+            for( size_t round = 0; round < 200; ++round )
+            {
+                std::vector< LogicalMatrix > matrices = { a, b, c, d, e, pair, other_pair };
+                std::vector< LogicalExpr > expressions( matrices.begin(), matrices.end() );
 
-        result &= test_evaluate( "a & b, c | d", test_map, { 0, 1 } );
-        result &= test_evaluate( "a & b | e & f, c | d | e & f", test_map, { 0, 1 } );
-        result &= test_evaluate( "a & b, a & b | d & e, a & b | c | d, c | d", test_map, { 0, 0, 1, 1 } );
-        result &= test_evaluate( "a | b, a & b | c & d, a & b | e, c | d | a | b, c | d, e | c | d", test_map, { 1, 0, 0, 1, 1, 1 } );
+                while( matrices.size() > 1 )
+                {
+                    size_t left = generator() % matrices.size(), right = generator() % matrices.size(), operation = generator() % 4;
+                    LogicalMatrix matrix = ( operation == 0 )? matrices[ left ] & matrices[ right ] : ( operation == 1 )? matrices[ left ] | matrices[ right ] :
+                        ( operation == 2 && matrices[ left ].statement_count() + matrices[ right ].statement_count() < 5 )? matrices[ left ] + matrices[ right ] : !matrices[ left ];
+                    LogicalExpr expression = ( operation == 0 )? expressions[ left ] & expressions[ right ] : ( operation == 1 )? expressions[ left ] | expressions[ right ] :
+                        ( operation == 2 && matrices[ left ].statement_count() + matrices[ right ].statement_count() < 5 )? expressions[ left ] + expressions[ right ] : !expressions[ left ];
+
+                    matrices[ left ] = matrix;
+                    expressions[ left ] = expression;
+
+                    if( left != right && operation < 3 && matrix.statement_count() < 16 )
+                    {
+                        matrices.erase( matrices.begin() + right );
+                        expressions.erase( expressions.begin() + right );
+                    }
+                    else if( matrix.statement_count() >= 16 )
+                    {
+                        matrices.pop_back();
+                        expressions.pop_back();
+                    }
+                }
 
-        result &= test_evaluate( "a & !a", { { "a", false } }, { 0 } );
-        result &= test_evaluate( "a & !a", { { "a", true } }, { 0 } );
-        result &= test_evaluate( "a | !a", { { "a", false } }, { 1 } );
-        result &= test_evaluate( "a | !a", { { "a", true } }, { 1 } );
-        result &= test_evaluate( "a | !a", { }, { 0 } );
+                if( !expressions[ 0 ].materialize().equivalent( matrices[ 0 ] ) )
+                {
+                    result = false;
+                    std::cout << "Expression " << round << " materialized to " << expressions[ 0 ].materialize() << " instead of " << matrices[ 0 ] << std::endl << "Test FAILED" << std::endl << std::endl;
+                    break;
+                }
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in expressions" << std::endl << std::endl;
+        }
     }
 
     if( true )
     {
         try
         {
-            if( true )
+            std::vector< LogicalMatrix > matrices = { LogicalMatrix( "a & !b | c, !a & d, e" ), !LogicalMatrix( "x & y | !z" ), LogicalMatrix(), LogicalMatrix( "a & !a | b" ) };
+            std::shared_ptr< SymbolTable > table = std::make_shared< SymbolTable >();
+            std::stringstream stream;
+
+            matrices[ 0 ].set_storage( LogicalMatrix::Sparse );
+            matrices[ 1 ].set_conversion_limit( 64 );
+            matrices[ 3 ].set_storage( LogicalMatrix::TermMajor );
+            matrices[ 3 ].set_drop_contradictions( true );
+            matrices.push_back( matrices[ 0 ] & matrices[ 3 ] );
+
+            // reloaded matrices keep their statements, form, storage and settings, and serialize to the same record
+            for( LogicalMatrix const& matrix : matrices )
             {
-                LogicalMatrix test_matrix( "a | b" );
+                std::string record = matrix.serialize();
+                LogicalMatrix copy = LogicalMatrix::deserialize( record );
+
+                result &= test( copy, matrix.to_string() );
+                result &= test_equality( copy == matrix, true );
+                result &= test_equality( copy.form(), matrix.form() );
+                result &= test_equality( copy.storage(), matrix.storage() );
+                result &= test_equality( copy.drops_contradictions(), matrix.drops_contradictions() );
+                result &= test_equality( copy.conversion_limit(), matrix.conversion_limit() );
+                result &= test_equality( copy.serialize(), record );
+
+                matrix.serialize( stream );
+            }
 
-                result &= test_equality( test_matrix.split_statements(), std::vector< LogicalMatrix >( { test_matrix } ) );
+            for( LogicalMatrix const& matrix : matrices )
+            { // records follow one another in a stream
+                result &= test( LogicalMatrix::deserialize( stream ), matrix.to_string() );
+            }
 
-                result &= test_equality( test_matrix.identifier_count(), 2 );
-                result &= test_equality( test_matrix.statement_count(), 1 );
+            // a SymbolTable numbering the identifiers in another order
+            table->intern( "d" );
+            table->intern( "c" );
+            table->intern( "b" );
 
-                test_matrix.combine_statements();
+            LogicalMatrix shared = LogicalMatrix::deserialize( matrices[ 0 ].serialize(), table );
 
-                result &= test( test_matrix, "a | b" );
-            }
+            result &= test( shared, "a & !b | c, !a & d, e" );
+            result &= test_equality( shared.symbol_table() == table, true );
+            result &= test_equality( shared.equivalent( LogicalMatrix( "c | a & !b, d & !a, e", table ) ), true );
 
-            if( true )
+            // truncated records, and records with a changed byte or another version
+            std::string record = matrices[ 0 ].serialize();
+            std::vector< std::string > damaged = { record.substr( 0, 16 ), record.substr( 0, record.size() - 1 ) };
+
+            for( size_t position : { ( size_t ) 0, ( size_t ) 4, record.size() / 2, record.size() - 1 } )
             {
-                LogicalMatrix test_matrix( "a | b, c & d, e" );
+                damaged.push_back( record );
+                damaged.back()[ position ] ^= 1;
+            }
 
-                std::string split_expected[] = { "a | b", "c & d", "e" };
+            // headers claiming records far larger than the stream holding them
+            for( uint64_t claimed : { ( uint64_t ) 0, ( uint64_t ) 23, ( uint64_t ) 1 << 32, ( uint64_t ) 1 << 40, ( uint64_t ) 1 << 41, ~( uint64_t ) 0 } )
+            {
+                damaged.push_back( record.substr( 0, 16 ) );
 
-                result &= test_equality( test_matrix.identifier_count(), 5 );
-                result &= test_equality( test_matrix.statement_count(), 3 );
+                for( size_t byte = 0; byte < 8; ++byte )
+                {
+                    damaged.back()[ 8 + byte ] = ( char )( claimed >> ( 8 * byte ) );
+                }
+            }
 
-                std::vector< LogicalMatrix > split_vector = test_matrix.split_statements();
+            for( size_t index = 0; index < damaged.size(); ++index )
+            {
+                try
+                {
+                    std::stringstream damaged_stream( damaged[ index ] );
 
-                for( short index = 0; index < 3; ++index )
+                    LogicalMatrix::deserialize( damaged_stream );
+                    result = false;
+                    std::cout << "No error caught reading damaged stream " << index << std::endl << "Test FAILED" << std::endl << std::endl;
+                }
+                catch( LogicalMatrix::Logicalformatexception &e )
                 {
-                    result &= test( split_vector[ index ], split_expected[ index ] );
-                    result &= test( test_matrix.isolate_statement( index ), split_expected[ index ] );
                 }
 
-                result &= test( test_matrix.isolate_statement( 3 ), "" );
-                result &= test( test_matrix.isolate_statement( 8 ), "" );
+                try
+                {
+                    LogicalMatrix::deserialize( damaged[ index ] );
+                    result = false;
+                    std::cout << "No error caught reading damaged record " << index << std::endl << "Test FAILED" << std::endl << std::endl;
+                }
+                catch( LogicalMatrix::Logicalformatexception &e )
+                {
+                }
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in serialization" << std::endl << std::endl;
+        }
+    }
 
-                test_matrix.combine_statements();
+    if( true )
+    {
+        try
+        {
+            const std::string path = "LogicalMatrixTest.frozen";
+            std::vector< std::string > tested = { "a & !b | c, !a & d, e", "( x | !y ) & ( z | w ) & !v", "A & !A | B, !B" };
 
-                result &= test( test_matrix, "a & c & d & e | b & c & d & e" );
+            for( std::string const& statement : tested )
+            {
+                result &= test_frozen( statement );
             }
 
-            if( true )
+            // identifiers are numbered by name, whatever the SymbolTable numbered them
+            LogicalMatrix test_matrix( "c & !b | a, b & d, !a | !c & e" );
+            FrozenMatrix frozen = test_matrix.freeze();
+
+            result &= test_equality( frozen.identifier_count(), 5 );
+            result &= test_equality( frozen.statement_count(), 3 );
+            result &= test_equality( frozen.term_count(), 5 );
+            result &= test_equality( frozen.find( "a" ), ( SymbolTable::id_type ) 0 );
+            result &= test_equality( frozen.find( "e" ), ( SymbolTable::id_type ) 4 );
+            result &= test_equality( frozen.find( "f" ), SymbolTable::npos );
+            result &= test_equality( std::string( frozen.name( 2 ) ), std::string( "c" ) );
+            result &= test( frozen.to_matrix(), test_matrix.to_string() );
+            result &= test_equality( frozen.to_matrix().equivalent( test_matrix ), true );
+
+            // an image written to a file is mapped and evaluated in place, copies keeping the mapping
+            std::ofstream output( path, std::ios::binary );
+
+            frozen.write( output );
+            output.close();
+
+            FrozenMatrix mapped = FrozenMatrix::open( path ), copy = mapped;
+            FrozenMatrix::Assignment assignment = copy.make_assignment( { { "a", false }, { "b", true }, { "c", true }, { "d", true }, { "e", true } } );
+            FrozenMatrix::ResultBitset result_bits = copy.make_result();
+            mapped = FrozenMatrix();
+
+            // mapping allocates only the MappedFile and evaluating nothing
+            size_t before = allocations;
+            FrozenMatrix reopened = FrozenMatrix::open( path );
+
+            result &= test_equality( allocations - before <= 1, true );
+            before = allocations;
+            copy.evaluate( assignment, result_bits );
+            result &= test_equality( allocations - before, 0 );
+            result &= test_equality( reopened.image() == copy.image(), true );
+            result &= test_equality( copy.image() == frozen.image(), true );
+            result &= test_equality( reinterpret_cast< uintptr_t >( copy.image().data() ) % 64, 0 );
+            result &= test_equality( result_bits[ 0 ], false );
+            result &= test_equality( result_bits[ 1 ], true );
+            result &= test_equality( result_bits[ 2 ], true );
+            result &= test_equality( mapped.statement_count(), 0 );
+
+            // a shared SymbolTable numbering the identifiers in another order
+            std::shared_ptr< SymbolTable > table = std::make_shared< SymbolTable >();
+
+            table->intern( "e" );
+            table->intern( "d" );
+            result &= test_equality( copy.to_matrix( table ).equivalent( LogicalMatrix( "c & !b | a, b & d, !a | !c & e", table ) ), true );
+
+            // truncated images, and images with a changed header or statement list
+            std::string image( frozen.image() );
+            std::vector< std::string > damaged = { image.substr( 0, 32 ), image.substr( 0, image.size() - 64 ), image + std::string( 64, '\0' ) };
+
+            for( size_t position : { ( size_t ) 0, ( size_t ) 4, ( size_t ) 8, ( size_t ) 24, ( size_t ) 48, image.size() - 64 } )
             {
-                LogicalMatrix test_matrix;
-
-                result &= test( test_matrix, "" );
-
-                result &= test_equality( test_matrix, !test_matrix );
-
-                result &= test_equality( test_matrix.identifier_count(), 0 );
-                result &= test_equality( test_matrix.statement_count(), 0 );
+                damaged.push_back( image );
+                damaged.back()[ position ] ^= 1;
+            }
 
-                result &= test_equality( test_matrix.split_statements(), std::vector< LogicalMatrix >( { } ) );
-                result &= test_equality( test_matrix.get_unique_identifiers(), std::set< std::string >( { } ) );
+            for( size_t index = 0; index < damaged.size(); ++index )
+            {
+                try
+                {
+                    FrozenMatrix::view( damaged[ index ] );
+                    result = false;
+                    std::cout << "No error caught reading damaged image " << index << std::endl << "Test FAILED" << std::endl << std::endl;
+                }
+                catch( LogicalMatrix::Logicalformatexception &e )
+                {
+                }
+            }
 
-                result &= test_equality( test_matrix, test_matrix.isolate_statement( 0 ) );
-                result &= test_equality( test_matrix, test_matrix.isolate_statement( 5 ) );
+            std::remove( path.c_str() );
 
-                test_matrix.combine_statements();
+            try
+            {
+                FrozenMatrix::open( path );
+                result = false;
+                std::cout << "No error caught opening a missing image" << std::endl << "Test FAILED" << std::endl << std::endl;
+            }
+            catch( LogicalMatrix::Logicalfileexception &e )
+            {
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in freezing" << std::endl << std::endl;
+        }
+    }
 
-                result &= test( test_matrix, "" );
+    if( true )
+    {
+        try
+        {
+            // slices shaped for another matrix or another number of assignments are refused before any row is read
+            static ThreadPool pool( 2 );
+            CompiledMatrix compiled = LogicalMatrix( "a & b | c, !d, e & !f" ).compile(), other = LogicalMatrix( "a | b" ).compile();
+            CompiledMatrix::BitSlice batch = compiled.make_batch( 128 ), results = compiled.make_batch_result( 128 );
+            std::vector< std::pair< CompiledMatrix::BitSlice, CompiledMatrix::BitSlice > > mismatched =
+            {
+                { other.make_batch( 128 ), compiled.make_batch_result( 128 ) },
+                { compiled.make_batch( 128 ), other.make_batch_result( 128 ) },
+                { compiled.make_batch( 128 ), compiled.make_batch_result( 64 ) },
+                { compiled.make_batch( 64 ), compiled.make_batch_result( 128 ) }
+            };
 
-                result &= test_evaluate( test_matrix, { }, { } );
+            compiled.evaluate_batch( batch, results );
+            compiled.evaluate_batch( batch, results, pool );
 
-                result &= test_remove( test_matrix, 5, false );
-                result &= test_remove( test_matrix, 0, false );
+            for( size_t index = 0; index < 2 * mismatched.size(); ++index )
+            {
+                try
+                {
+                    if( index % 2 == 0 )
+                    {
+                        compiled.evaluate_batch( mismatched[ index / 2 ].first, mismatched[ index / 2 ].second );
+                    }
+                    else
+                    {
+                        compiled.evaluate_batch( mismatched[ index / 2 ].first, mismatched[ index / 2 ].second, pool );
+                    }
+
+                    result = false;
+                    std::cout << "No error caught evaluating mismatched batch " << index / 2 << std::endl << "Test FAILED" << std::endl << std::endl;
+                }
+                catch( CompiledMatrix::Batchexception &e )
+                {
+                }
             }
         }
         catch( LogicalMatrix::Logicalstatementexception &e )
         {
             result = false;
-            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in parsing" << std::endl << std::endl;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in batch shapes" << std::endl << std::endl;
         }
     }
 
     if( true )
     {
-        result &= test_evaluate_full( "( a & b, c | d ) & ( a | b, c & d, e )" );
+        try
+        {
+            // copies share their storage until one of them changes, which never shows in the other
+            LogicalMatrix other( "a | z & !b" );
+            std::vector< std::function< void( LogicalMatrix & ) > > changes =
+            {
+                [ & ]( LogicalMatrix &matrix ){ matrix &= other; },
+                [ & ]( LogicalMatrix &matrix ){ matrix |= other; },
+                [ & ]( LogicalMatrix &matrix ){ matrix += other; },
+                [ & ]( LogicalMatrix &matrix ){ matrix &= matrix; },
+                [ & ]( LogicalMatrix &matrix ){ matrix |= matrix; },
+                [ & ]( LogicalMatrix &matrix ){ matrix += matrix; },
+                [ & ]( LogicalMatrix &matrix ){ matrix.AND( other, 0 ); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.OR( other, 1 ); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.ADD( other, 0 ); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.NOT(); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.NOT( 1 ); },
+                [ & ]( LogicalMatrix &matrix ){ matrix = std::move( matrix ) & other; },
+                [ & ]( LogicalMatrix &matrix ){ matrix = !std::move( matrix ); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.minimize(); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.remove_statement( 0 ); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.combine_statements(); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.clear(); },
+                [ & ]( LogicalMatrix &matrix ){ matrix.set_storage( LogicalMatrix::Dense ); matrix |= other; },
+                [ & ]( LogicalMatrix &matrix ){ matrix.set_storage( LogicalMatrix::Sparse ); matrix |= other; },
+                [ & ]( LogicalMatrix &matrix ){ matrix.set_storage( LogicalMatrix::TermMajor ); matrix += other; }
+            };
+
+            for( const std::string &statement : { std::string( "a & !b | c, !a & d | b & c, e" ), std::string( "( a | b ) & ( c | !d ), a & !e" ) } )
+            {
+                for( LogicalMatrix::Storage storage : { LogicalMatrix::Dense, LogicalMatrix::Sparse, LogicalMatrix::TermMajor } )
+                {
+                    for( bool negated : { false, true } )
+                    {
+                        LogicalMatrix original( statement );
+
+                        original.set_storage( storage );
+
+                        if( negated )
+                        {
+                            original.NOT();
+                        }
+
+                        std::string record = original.serialize();
+
+                        for( size_t index = 0; index < changes.size(); ++index )
+                        {
+                            size_t before = allocations;
+                            LogicalMatrix copy( original ), kept( original );
+
+                            result &= test_equality( allocations - before, 0 );
+                            changes[ index ]( copy );
+                            result &= test_equality( original.serialize(), record );
+                            result &= test_equality( kept == original, true );
+
+                            // and the other way round
+                            copy = original;
+                            changes[ index ]( original );
+                            result &= test_equality( copy.serialize(), record );
+                            original = LogicalMatrix::deserialize( record );
+                        }
+                    }
+                }
+            }
+        }
+        catch( LogicalMatrix::Logicalstatementexception &e )
+        {
+            result = false;
+            std::cout << "Error caught: \"" << e.what() << "\"" << std::endl << "Tests FAILED in shared storage" << std::endl << std::endl;
+        }
     }
 
     std::cout << std::endl << ( result? "All tests passed" : "Tests FAILED" ) << std::endl << "\tTime elapsed: " <<
@@ -0,0 +1,85 @@
+// MappedFile.cpp
+
+/** Implementation file for the MappedFile class.
+ */
+
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : mapping( nullptr ), length( 0 )
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// maps path in place of any file already open, returns false if it cannot be read
+bool MappedFile::open( const std::string &path, const Access access )
+{
+    int descriptor = ::open( path.c_str(), O_RDONLY );
+    struct stat status;
+
+    close();
+
+    if( descriptor < 0 )
+    {
+        return false;
+    }
+
+    if( fstat( descriptor, &status ) != 0 )
+    {
+        ::close( descriptor );
+        return false;
+    }
+
+    if( status.st_size > 0 )
+    {
+        mapping = mmap( nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+
+        if( mapping == MAP_FAILED )
+        {
+            mapping = nullptr;
+            ::close( descriptor );
+            return false;
+        }
+
+        length = status.st_size;
+        static const int advice[] = { MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_NORMAL };
+
+        madvise( mapping, length, advice[ access ] );
+    }
+
+    ::close( descriptor );
+    return true;
+}
+
+void MappedFile::close()
+{
+    if( mapping )
+    {
+        munmap( mapping, length );
+    }
+
+    mapping = nullptr;
+    length = 0;
+}
+
+const char *MappedFile::data() const
+{
+    return ( const char * ) mapping;
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+std::string_view MappedFile::view() const
+{
+    return std::string_view( data(), length );
+}
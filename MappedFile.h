@@ -0,0 +1,42 @@
+// MappedFile.h
+
+/** Header file for the MappedFile class.
+ *
+ *  A MappedFile maps a whole file read only into memory and unmaps it when
+ *  destroyed. An empty file maps to no data. The kernel is advised how the
+ *  mapping will be read, by default once front to back.
+ */
+
+#ifndef __MappedFile_h_included__
+#define __MappedFile_h_included__
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class MappedFile
+{
+    public:
+        // Sequential lets pages go soon after they are read, Random keeps them and reads no further ahead,
+        // WillNeed reads the whole file in ahead of use
+        enum Access { Sequential, Random, WillNeed, Normal };
+
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile &operator =( const MappedFile& ) = delete;
+
+        bool open( const std::string &path, const Access access = Sequential );
+        void close();
+
+        const char *data() const;
+        size_t size() const;
+        std::string_view view() const;
+
+    private:
+        void *mapping;
+        size_t length;
+};
+
+#endif
@@ -0,0 +1,276 @@
+// SharedVector.h
+
+/** Header file for the SharedVector class template.
+ *
+ *  A SharedVector holds a std::vector that copies of it share until one of
+ *  them is changed, so copying one costs a reference count rather than its
+ *  values. Elements are only read through operator [] and the iterators,
+ *  which never copy; they are changed through write() and the members that
+ *  add or remove them, which first detach the vector from its other owners.
+ *
+ *  As with any copy on write container, a reference or iterator taken
+ *  from write() must not be written through once the SharedVector has
+ *  been copied again.
+ */
+
+#ifndef __SharedVector_h_included__
+#define __SharedVector_h_included__
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template< typename Value >
+class SharedVector
+{
+    public:
+        typedef typename std::vector< Value >::iterator iterator;
+        typedef typename std::vector< Value >::const_iterator const_iterator;
+        typedef Value value_type;
+
+        SharedVector() = default;
+        SharedVector( const SharedVector &other ) : values( other.values ) {}
+        SharedVector( SharedVector &&other ) noexcept : values( std::move( other.values ) ) {}
+        SharedVector( const size_t size, const Value &value = Value() ) : values( std::make_shared< std::vector< Value > >( size, value ) ) {}
+        SharedVector( std::vector< Value > &&other ) : values( std::make_shared< std::vector< Value > >( std::move( other ) ) ) {}
+
+        template< typename Iterator >
+        SharedVector( Iterator first, Iterator last ) : values( std::make_shared< std::vector< Value > >( first, last ) ) {}
+
+        // a vector owned alone is kept as the spare of this, the next detach copying into it reuses its buffers
+        SharedVector &operator =( const SharedVector &other )
+        {
+            if( values != other.values )
+            {
+                if( values && values.use_count() == 1 )
+                {
+                    spare = std::move( values );
+                }
+
+                values = other.values;
+            }
+
+            return *this;
+        }
+
+        SharedVector &operator =( SharedVector &&other ) noexcept
+        {
+            values = std::move( other.values );
+            return *this;
+        }
+
+        SharedVector &operator =( const std::vector< Value > &other )
+        {
+            if( values && values.use_count() == 1 )
+            { // keeps the buffer of a vector owned alone
+                *values = other;
+            }
+            else
+            {
+                values = std::make_shared< std::vector< Value > >( other );
+            }
+
+            return *this;
+        }
+
+        SharedVector &operator =( std::vector< Value > &&other )
+        {
+            if( values && values.use_count() == 1 )
+            {
+                *values = std::move( other );
+            }
+            else
+            {
+                values = std::make_shared< std::vector< Value > >( std::move( other ) );
+            }
+
+            return *this;
+        }
+
+        SharedVector &operator =( std::initializer_list< Value > other )
+        {
+            return *this = std::vector< Value >( other );
+        }
+
+        // the vector, never copied
+        const std::vector< Value > &read() const
+        {
+            return values? *values : none;
+        }
+
+        operator const std::vector< Value > &() const
+        {
+            return read();
+        }
+
+        // the vector owned by this alone, copied first if it is shared
+        std::vector< Value > &write()
+        {
+            if( !values || values.use_count() != 1 )
+            {
+                detach();
+            }
+
+            return *values;
+        }
+
+        bool shared() const
+        {
+            return values && values.use_count() > 1;
+        }
+
+        size_t size() const { return values? values->size() : 0; }
+        bool empty() const { return !values || values->empty(); }
+        size_t capacity() const { return values? values->capacity() : 0; }
+
+        const Value &operator []( const size_t index ) const { return ( *values )[ index ]; }
+        const Value &front() const { return values->front(); }
+        const Value &back() const { return values->back(); }
+        const Value *data() const { return values? values->data() : nullptr; }
+        const_iterator begin() const { return read().begin(); }
+        const_iterator end() const { return read().end(); }
+        const_iterator cbegin() const { return read().begin(); }
+        const_iterator cend() const { return read().end(); }
+
+        void push_back( const Value &value ) { write().push_back( value ); }
+        void push_back( Value &&value ) { write().push_back( std::move( value ) ); }
+
+        template< typename... Arguments >
+        Value &emplace_back( Arguments&&... arguments ) { return write().emplace_back( std::forward< Arguments >( arguments )... ); }
+
+        void pop_back() { write().pop_back(); }
+        void reserve( const size_t size ) { write().reserve( size ); }
+        void resize( const size_t size ) { write().resize( size ); }
+        void resize( const size_t size, const Value &value ) { write().resize( size, value ); }
+        void assign( const size_t size, const Value &value ) { own_empty().assign( size, value ); }
+
+        template< typename Iterator >
+        void assign( Iterator first, Iterator last ) { own_empty().assign( first, last ); }
+
+        template< typename... Arguments >
+        iterator insert( const_iterator position, Arguments&&... arguments )
+        { // position may come from the shared vector, so it is moved to the vector it detaches to
+            size_t offset = position - read().begin();
+            std::vector< Value > &owned = write();
+
+            return owned.insert( owned.begin() + offset, std::forward< Arguments >( arguments )... );
+        }
+
+        iterator erase( const_iterator position )
+        {
+            size_t offset = position - read().begin();
+            std::vector< Value > &owned = write();
+
+            return owned.erase( owned.begin() + offset );
+        }
+
+        iterator erase( const_iterator first, const_iterator last )
+        {
+            size_t offset = first - read().begin(), count = last - first;
+            std::vector< Value > &owned = write();
+
+            return owned.erase( owned.begin() + offset, owned.begin() + offset + count );
+        }
+
+        // a vector shared with others is let go rather than copied only to be emptied
+        void clear()
+        {
+            if( values && values.use_count() == 1 )
+            {
+                values->clear();
+            }
+            else
+            {
+                values.reset();
+            }
+        }
+
+        // lets the buffers go as well
+        void release()
+        {
+            values.reset();
+            spare.reset();
+        }
+
+        void swap( SharedVector &other )
+        {
+            values.swap( other.values );
+        }
+
+        // takes the values of other, leaving other the old values of this when they were not shared and empty otherwise
+        void adopt( std::vector< Value > &other )
+        {
+            if( values && values.use_count() == 1 )
+            {
+                values->swap( other );
+            }
+            else
+            {
+                own_empty().swap( other );
+                other.clear();
+            }
+        }
+
+        bool operator ==( const SharedVector &other ) const
+        {
+            return values == other.values || read() == other.read();
+        }
+
+        bool operator !=( const SharedVector &other ) const
+        {
+            return !( *this == other );
+        }
+
+        bool operator <( const SharedVector &other ) const
+        {
+            return read() < other.read();
+        }
+
+    private:
+        // read by SharedVectors without a vector, a namespace scope static so that reading needs no guard
+        static inline const std::vector< Value > none;
+
+        // spare is owned by this alone whenever it is set
+        std::shared_ptr< std::vector< Value > > values, spare;
+
+        // kept out of line so that write() stays small enough to inline in loops
+        __attribute__(( noinline )) void detach()
+        {
+            if( !values )
+            {
+                own_empty();
+            }
+            else if( spare )
+            {
+                *spare = *values;
+                values = std::move( spare );
+            }
+            else
+            {
+                values = std::make_shared< std::vector< Value > >( *values );
+            }
+        }
+
+        // the vector owned by this alone without copying what it held
+        std::vector< Value > &own_empty()
+        {
+            if( !values || values.use_count() > 1 )
+            {
+                if( spare )
+                {
+                    values = std::move( spare );
+                    values->clear();
+                }
+                else
+                {
+                    values = std::make_shared< std::vector< Value > >();
+                }
+            }
+
+            return *values;
+        }
+};
+
+#endif
@@ -0,0 +1,145 @@
+// StatementView.cpp
+
+/** Implementation file for the StatementView class.
+ */
+
+#include "StatementView.h"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+StatementView::StatementView( const LogicalMatrix &matrix, const size_t statement_index ) : matrix( &matrix ), statement( statement_index )
+{
+}
+
+size_t StatementView::index() const
+{
+    return statement;
+}
+
+bool StatementView::empty() const
+{
+    return matrix->empty() || statement >= matrix->statement_count();
+}
+
+size_t StatementView::term_count() const
+{
+    if( empty() )
+    {
+        return 0;
+    }
+
+    if( matrix->current_storage == LogicalMatrix::Dense )
+    {
+        return matrix->OR_matrix[ statement ].count();
+    }
+
+    return matrix->statement_offsets[ statement + 1 ] - matrix->statement_offsets[ statement ];
+}
+
+// in DNF an AND set holds when each of its literals is known and true, in CNF an OR set when one of them is
+bool StatementView::evaluate( const std::map< std::string, bool > &identifiers ) const
+{
+    if( empty() )
+    {
+        return false;
+    }
+
+    std::vector< std::vector< uint32_t > > sets = matrix->literal_sets( statement );
+
+    auto holds = [ & ]( const uint32_t literal )
+    {
+        auto identifier = identifiers.find( matrix->symbols->name( literal / 2 ) );
+
+        return identifier != identifiers.end() && identifier->second == !( literal & 1 );
+    };
+
+    if( matrix->matrix_form == LogicalMatrix::CNF )
+    {
+        return std::all_of( sets.begin(), sets.end(), [ &holds ]( const std::vector< uint32_t > &set )
+        {
+            return std::any_of( set.begin(), set.end(), holds );
+        } );
+    }
+
+    return std::any_of( sets.begin(), sets.end(), [ &holds ]( const std::vector< uint32_t > &set )
+    {
+        return std::all_of( set.begin(), set.end(), holds );
+    } );
+}
+
+std::set< std::string > StatementView::get_unique_identifiers() const
+{
+    std::set< std::string > result;
+
+    if( empty() )
+    {
+        return result;
+    }
+
+    for( std::vector< uint32_t > const& set : matrix->literal_sets( statement ) )
+    {
+        for( uint32_t const& literal : set )
+        {
+            result.insert( matrix->symbols->name( literal / 2 ) );
+        }
+    }
+
+    return result;
+}
+
+LogicalMatrix StatementView::to_matrix() const
+{
+    return matrix->isolate_statement( statement );
+}
+
+// printed as LogicalMatrix prints the statement, the literals of each AND set ordered by identifier name, x before !x
+// A CNF statement is expanded into DNF first
+std::string StatementView::to_string() const
+{
+    std::ostringstream output;
+
+    if( empty() )
+    {
+        return output.str();
+    }
+
+    if( matrix->matrix_form == LogicalMatrix::CNF )
+    {
+        output << to_matrix();
+        return output.str();
+    }
+
+    const SymbolTable &symbols = *matrix->symbols;
+    bool OR_empty = true;
+
+    for( std::vector< uint32_t >& set : matrix->literal_sets( statement ) )
+    {
+        if( set.empty() )
+        {
+            continue;
+        }
+
+        std::sort( set.begin(), set.end(), [ &symbols ]( const uint32_t left, const uint32_t right )
+        {
+            int comparison = symbols.name( left / 2 ).compare( symbols.name( right / 2 ) );
+
+            return ( comparison != 0 )? comparison < 0 : left < right;
+        } );
+
+        output << ( OR_empty? "" : " | " );
+        OR_empty = false;
+
+        for( size_t index = 0; index < set.size(); ++index )
+        {
+            output << ( ( index > 0 )? " & " : "" ) << ( ( set[ index ] & 1 )? "!" : "" ) << symbols.name( set[ index ] / 2 );
+        }
+    }
+
+    return output.str();
+}
+
+std::ostream &operator<<( std::ostream &output, const StatementView &object_arg )
+{
+    return output << object_arg.to_string();
+}
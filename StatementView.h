@@ -0,0 +1,47 @@
+// StatementView.h
+
+/** Header file for the StatementView class.
+ *
+ *  A StatementView refers to one statement of a LogicalMatrix without copying
+ *  any of its columns or literal lists. It reads the AND sets of the statement,
+ *  or its OR sets in CNF, straight from the matrix, and only to_matrix() builds
+ *  a LogicalMatrix of its own.
+ *
+ *  A view is valid while its matrix is alive and unchanged, a statement index
+ *  out of range views an empty statement.
+ */
+
+#ifndef __StatementView_h_included__
+#define __StatementView_h_included__
+
+#include "LogicalMatrix.h"
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+
+class StatementView
+{
+    public:
+        StatementView( const LogicalMatrix &matrix, const size_t statement_index );
+
+        size_t index() const;
+        bool empty() const;
+
+        // the AND sets of the statement, or its OR sets in CNF
+        size_t term_count() const;
+
+        // matches the value of the statement in LogicalMatrix::evaluate
+        bool evaluate( const std::map< std::string, bool > &identifiers ) const;
+
+        std::set< std::string > get_unique_identifiers() const;
+        LogicalMatrix to_matrix() const;
+        std::string to_string() const;
+        friend std::ostream &operator<<( std::ostream &output, const StatementView &object_arg );
+
+    private:
+        const LogicalMatrix *matrix;
+        size_t statement;
+};
+
+#endif
@@ -0,0 +1,39 @@
+// SymbolTable.cpp
+
+/** Implementation file for the SymbolTable class.
+ */
+
+#include "SymbolTable.h"
+
+const SymbolTable::id_type SymbolTable::npos;
+
+// returns the id of name, adding it to the table if it is not already present
+SymbolTable::id_type SymbolTable::intern( const std::string &name )
+{
+    auto [ iter, inserted ] = ids.try_emplace( name, names.size() );
+
+    if( inserted )
+    {
+        names.push_back( name );
+    }
+
+    return iter->second;
+}
+
+// returns the id of name or npos if the table does not contain name
+SymbolTable::id_type SymbolTable::find( const std::string &name ) const
+{
+    auto iter = ids.find( name );
+
+    return ( iter == ids.end() )? npos : iter->second;
+}
+
+const std::string &SymbolTable::name( const id_type identifier ) const
+{
+    return names[ identifier ];
+}
+
+size_t SymbolTable::size() const
+{
+    return names.size();
+}
@@ -0,0 +1,35 @@
+// SymbolTable.h
+
+/** Header file for the SymbolTable class.
+ *
+ *  A SymbolTable interns identifier names into dense integer ids. Ids are
+ *  handed out in order of first appearance and are never reused, so matrices
+ *  sharing a table can be combined by comparing ids alone.
+ */
+
+#ifndef __SymbolTable_h_included__
+#define __SymbolTable_h_included__
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SymbolTable
+{
+    public:
+        typedef uint32_t id_type;
+
+        static const id_type npos = -1;
+
+        id_type intern( const std::string &name );
+        id_type find( const std::string &name ) const;
+        const std::string &name( const id_type identifier ) const;
+        size_t size() const;
+
+    private:
+        std::vector< std::string > names;
+        std::unordered_map< std::string, id_type > ids;
+};
+
+#endif
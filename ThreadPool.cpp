@@ -0,0 +1,152 @@
+// ThreadPool.cpp
+
+/** Implementation file for the ThreadPool class.
+ */
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool( const size_t threads ) : current( nullptr ), generation( 0 ), active( 0 ), stopping( false )
+{
+    size_t count = ( threads == 0 )? 1 : threads;
+
+    for( size_t index = 0; index < count; ++index )
+    {
+        queues.emplace_back( new Queue() );
+    }
+
+    for( size_t index = 1; index < count; ++index )
+    {
+        workers.emplace_back( &ThreadPool::loop, this, index );
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard< std::mutex > guard( lock );
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for( std::thread& worker : workers )
+    {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const
+{
+    return queues.size();
+}
+
+// runs task for every index in [ 0, tasks ) and returns once all of them finished,
+// the first exception thrown by a task is rethrown here after the remaining tasks ran
+void ThreadPool::run( const size_t tasks, const Task &task )
+{
+    size_t index;
+
+    for( index = 0; index < tasks; ++index )
+    { // contiguous blocks keep neighbouring tasks on the same worker until stolen
+        Queue &queue = *queues[ index * queues.size() / tasks ];
+        std::lock_guard< std::mutex > guard( queue.lock );
+        queue.tasks.push_back( index );
+    }
+
+    {
+        std::lock_guard< std::mutex > guard( lock );
+        current = &task;
+        active = workers.size();
+        error = nullptr;
+        ++generation;
+    }
+
+    wake.notify_all();
+    work( 0 );
+
+    std::unique_lock< std::mutex > guard( lock );
+    done.wait( guard, [ this ]{ return active == 0; } );
+    current = nullptr;
+
+    if( error )
+    {
+        std::rethrow_exception( error );
+    }
+}
+
+// pops from the back of its own queue, then steals from the front of the others
+bool ThreadPool::take( const size_t worker, size_t &task )
+{
+    for( size_t offset = 0; offset < queues.size(); ++offset )
+    {
+        Queue &queue = *queues[ ( worker + offset ) % queues.size() ];
+        std::lock_guard< std::mutex > guard( queue.lock );
+
+        if( !queue.tasks.empty() )
+        {
+            if( offset == 0 )
+            {
+                task = queue.tasks.back();
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = queue.tasks.front();
+                queue.tasks.pop_front();
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// every task is queued before the workers wake, so empty queues mean no work is left to take
+void ThreadPool::work( const size_t worker )
+{
+    size_t task;
+
+    while( take( worker, task ) )
+    {
+        try
+        {
+            ( *current )( task, worker );
+        }
+        catch( ... )
+        {
+            std::lock_guard< std::mutex > guard( lock );
+
+            if( !error )
+            {
+                error = std::current_exception();
+            }
+        }
+    }
+}
+
+void ThreadPool::loop( const size_t worker )
+{
+    size_t seen = 0;
+    std::unique_lock< std::mutex > guard( lock );
+
+    while( true )
+    {
+        wake.wait( guard, [ this, seen ]{ return stopping || generation != seen; } );
+
+        if( stopping )
+        {
+            return;
+        }
+
+        seen = generation;
+        guard.unlock();
+        work( worker );
+        guard.lock();
+
+        if( --active == 0 )
+        {
+            done.notify_one();
+        }
+    }
+}
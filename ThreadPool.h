@@ -0,0 +1,64 @@
+// ThreadPool.h
+
+/** Header file for the ThreadPool class.
+ *
+ *  A ThreadPool runs indexed tasks on a fixed set of worker threads. Each
+ *  worker owns a deque of task indices, taking work from its back and
+ *  stealing from the front of the other deques once its own is empty. The
+ *  calling thread takes part as worker 0, so a pool of one thread runs
+ *  everything inline.
+ */
+
+#ifndef __ThreadPool_h_included__
+#define __ThreadPool_h_included__
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+    public:
+        // task is called with the task index and the worker running it, worker is below size()
+        typedef std::function< void( const size_t task, const size_t worker ) > Task;
+
+        ThreadPool( const size_t threads = std::thread::hardware_concurrency() );
+        ~ThreadPool();
+
+        ThreadPool( const ThreadPool& ) = delete;
+        ThreadPool &operator =( const ThreadPool& ) = delete;
+
+        size_t size() const;
+
+        // not reentrant, a single thread at a time may call run
+        void run( const size_t tasks, const Task &task );
+
+    private:
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque< size_t > tasks;
+        };
+
+        std::vector< std::unique_ptr< Queue > > queues;
+        std::vector< std::thread > workers;
+
+        std::mutex lock;
+        std::condition_variable wake, done;
+        const Task *current;
+        std::exception_ptr error;
+        size_t generation, active;
+        bool stopping;
+
+        bool take( const size_t worker, size_t &task );
+        void work( const size_t worker );
+        void loop( const size_t worker );
+};
+
+#endif